@@ -0,0 +1,444 @@
+// ルール System とスケジューラのマイクロベンチマーク(Google Benchmark)
+//
+//   使い方: benchmarks [--board_rows=N] [--board_cols=N] [--board_fill=F]
+//                      [Google Benchmark のフラグ]
+//     盤面の指定がなければ 行数 20/40 × 列数 10/40 × 充填率 0/0.5/0.85 の組み合わせで測る。
+//     充填率は下から何割の行を埋めるか(各行に 1 つ穴を残すので、揃った行はできない)。
+//     機械可読な結果は --benchmark_out=results.json --benchmark_out_format=json で書き出す
+//     (CMake の run_benchmarks ターゲットはこれを付けて実行する)。
+#include <benchmark/benchmark.h>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+import GlobalSetting;
+import SceneFramework;
+import Input;
+import Command;
+import Tetrimino;
+import SevenBag;
+import TetrisRule;
+import PlacementSearch;
+import ThreadPool;
+import Versus;
+
+namespace {
+
+using global_setting::GlobalSetting;
+using tetris_rule::GridResource;
+using tetris_rule::World;
+
+constexpr int kCell = 30;
+constexpr std::uint32_t kSeed = 12345;
+
+// 盤面の形(benchmark の Args から組み立てる)
+struct Board {
+    int rows;
+    int cols;
+    double fill;  // 下から埋める行の割合
+
+    static Board from(const benchmark::State& state) {
+        return Board{static_cast<int>(state.range(0)), static_cast<int>(state.range(1)),
+                     static_cast<double>(state.range(2)) / 100.0};
+    }
+};
+
+GlobalSetting make_setting(const Board& b) {
+    return GlobalSetting{b.cols,
+                         b.rows,
+                         kCell,
+                         kCell,
+                         60,
+                         0.7,
+                         global_setting::FontPtr{},
+                         b.cols * kCell + 300,
+                         b.rows * kCell,
+                         kSeed};
+}
+
+GridResource& grid_of(const World& w) { return w.registry->get<GridResource>(w.grid_singleton); }
+
+// 下から fill の割合の行を、1 行に 1 つ穴を残してランダムに埋める
+void fill_board(GridResource& grid, double fill, std::uint32_t seed) {
+    std::mt19937 rng{seed};
+    const int filled_rows = static_cast<int>(grid.rows * fill);
+    for (int r = grid.rows - 1; r >= grid.rows - filled_rows; --r) {
+        const int hole = static_cast<int>(rng() % static_cast<std::uint32_t>(grid.cols));
+        for (int c = 0; c < grid.cols; ++c) {
+            if (c != hole && rng() % 4 != 0) grid.fill_cell(r, c, PieceType::T);
+        }
+    }
+}
+
+// 盤面を b.fill まで埋めた新しい World
+World make_filled_world(const scene_fw::Env<GlobalSetting>& env, const Board& b) {
+    auto w = tetris_rule::make_world(env, kSeed);
+    if (!w) std::abort();
+    fill_board(grid_of(*w), b.fill, kSeed);
+    return std::move(*w);
+}
+
+// ベンチマーク 1 本ぶんの World と、それを動かす Env
+struct Fixture {
+    GlobalSetting setting;
+    input::Input input{};
+    scene_fw::Env<GlobalSetting> env;
+    World world;
+    Board board;
+
+    explicit Fixture(const Board& b)
+        : setting(make_setting(b)), env{input, setting, 1.0 / 60.0, {}}, board(b) {
+        world = make_filled_world(env, board);
+    }
+};
+
+// 作りたての状態を計測の外でまとめて用意しておく置き場
+//   1 反復ごとに PauseTiming / ResumeTiming で作り直すと、一時停止の方が測りたい処理より重い。
+//   kBatch 個を作っておき、使い切ったときだけ計測を止めて作り直す(使い終えた分の破棄もそこで行う)
+template <class T>
+class FreshBatch {
+   public:
+    static constexpr std::size_t kBatch = 64;
+
+    explicit FreshBatch(std::function<T()> make) : make_(std::move(make)) { refill(); }
+
+    // 次の作りたて。取り出した後も中身はここに残るので、std::swap で入れ替えて使ってもよい
+    T& next(benchmark::State& state) {
+        if (next_ == items_.size()) {
+            state.PauseTiming();
+            refill();
+            state.ResumeTiming();
+        }
+        return items_[next_++];
+    }
+
+   private:
+    std::function<T()> make_;
+    std::vector<T> items_;
+    std::size_t next_{0};
+
+    void refill() {
+        items_.clear();
+        items_.reserve(kBatch);
+        for (std::size_t i = 0; i < kBatch; ++i) items_.push_back(make_());
+        next_ = 0;
+    }
+};
+
+void set_board_counters(benchmark::State& state, const Board& b) {
+    state.counters["rows"] = b.rows;
+    state.counters["cols"] = b.cols;
+    state.counters["fill"] = b.fill;
+}
+
+// -----------------------------------------------------------------
+// step_world: 1 フレーム(11 System + コマンド適用)。ゲームオーバーで作り直す
+// -----------------------------------------------------------------
+void BM_StepWorld(benchmark::State& state) {
+    const Board b = Board::from(state);
+    Fixture fx{b};
+    FreshBatch<World> fresh{[&] { return make_filled_world(fx.env, b); }};
+    for (auto _ : state) {
+        tetris_rule::step_world(fx.world, fx.env);
+        if (tetris_rule::is_gameover(fx.world)) std::swap(fx.world, fresh.next(state));
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_board_counters(state, b);
+}
+
+// -----------------------------------------------------------------
+// can_place_on_grid: 盤面上の全列 × 全向きで判定
+// -----------------------------------------------------------------
+void BM_CanPlaceOnGrid(benchmark::State& state) {
+    const Board b = Board::from(state);
+    Fixture fx{b};
+    const GridResource& grid = grid_of(fx.world);
+    constexpr PieceDirection kDirs[] = {PieceDirection::North, PieceDirection::East,
+                                        PieceDirection::South, PieceDirection::West};
+    std::int64_t checks = 0;
+    for (auto _ : state) {
+        for (int r = 0; r < grid.rows; r += 2) {
+            for (int c = -1; c < grid.cols; ++c) {
+                for (const auto d : kDirs) {
+                    benchmark::DoNotOptimize(
+                        tetris_rule::can_place_on_grid(grid, PieceType::T, d, c, r));
+                    ++checks;
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(checks);
+    set_board_counters(state, b);
+}
+
+// -----------------------------------------------------------------
+// compute_ghost_position: 最上段の各列から落とした位置を求める(ゴースト・ハードドロップの中身)
+// -----------------------------------------------------------------
+void BM_ComputeGhostPosition(benchmark::State& state) {
+    const Board b = Board::from(state);
+    Fixture fx{b};
+    const GridResource& grid = grid_of(fx.world);
+    std::int64_t queries = 0;
+    for (auto _ : state) {
+        for (int t = 0; t < 7; ++t) {
+            const TetriminoMeta meta{static_cast<PieceType>(t), PieceDirection::North,
+                                     PieceStatus::Falling, 0, 0};
+            for (int c = 0; c + 4 <= grid.cols; ++c) {
+                const tetris_rule::Position start{c, 0};
+                benchmark::DoNotOptimize(tetris_rule::compute_ghost_position(grid, start, meta));
+                ++queries;
+            }
+        }
+    }
+    state.SetItemsProcessed(queries);
+    set_board_counters(state, b);
+}
+
+// -----------------------------------------------------------------
+// lineClearSystem_pure: 最下段から cleared 行を揃えた状態で 1 回実行(適用・行詰めを含む)
+// -----------------------------------------------------------------
+void BM_LineClear(benchmark::State& state) {
+    const Board b = Board::from(state);
+    const int cleared = static_cast<int>(state.range(3));
+    Fixture fx{b};
+    FreshBatch<World> fresh{[&] {
+        World w = make_filled_world(fx.env, b);
+        GridResource& grid = grid_of(w);
+        for (int r = grid.rows - 1; r >= grid.rows - cleared; --r) {
+            for (int c = 0; c < grid.cols; ++c) grid.fill_cell(r, c, PieceType::I);
+        }
+        return w;
+    }};
+    for (auto _ : state) {
+        tetris_rule::run_line_clear_system(fresh.next(state), fx.env);
+    }
+    state.counters["cleared_rows"] = cleared;
+    set_board_counters(state, b);
+}
+
+// -----------------------------------------------------------------
+// resolveRotationSystem_pure: 右回転を繰り返す(SRS キック探索を含む)
+// -----------------------------------------------------------------
+void BM_SrsRotation(benchmark::State& state) {
+    const Board b = Board::from(state);
+    Fixture fx{b};
+    for (auto _ : state) {
+        tetris_rule::run_rotation_system(fx.world, fx.env, +1);
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_board_counters(state, b);
+}
+
+// -----------------------------------------------------------------
+// PlacementSearcher::search: 出現位置からの到達可能な最終配置の列挙(7 種を順に)
+// -----------------------------------------------------------------
+void BM_PlacementSearch(benchmark::State& state) {
+    const Board b = Board::from(state);
+    Fixture fx{b};
+    const GridResource& grid = grid_of(fx.world);
+    placement::PlacementSearcher searcher;
+    std::int64_t searches = 0;
+    std::size_t placements = 0;
+    for (auto _ : state) {
+        for (int t = 0; t < 7; ++t) {
+            const placement::PieceState spawn{static_cast<PieceType>(t), PieceDirection::West,
+                                              fx.setting.spawn_col, fx.setting.spawn_row};
+            placements += searcher.search(grid.occ, spawn).size();
+            ++searches;
+        }
+    }
+    state.SetItemsProcessed(searches);
+    state.counters["placements"] =
+        searches ? static_cast<double>(placements) / static_cast<double>(searches) : 0.0;
+    set_board_counters(state, b);
+}
+
+// -----------------------------------------------------------------
+// plan_placement: ホールド込みで depth 手先まで読む(threads > 1 なら 1 手目ごとに並列)
+// -----------------------------------------------------------------
+void BM_PlanPlacement(benchmark::State& state) {
+    const Board b = Board::from(state);
+    placement::SearchOptions opt{};
+    opt.depth = static_cast<int>(state.range(3));
+    WorkStealingPool pool{static_cast<unsigned>(state.range(4) - 1)};
+    Fixture fx{b};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tetris_rule::plan_placement(fx.world, fx.env, opt, &pool));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["depth"] = static_cast<double>(opt.depth);
+    state.counters["threads"] = static_cast<double>(state.range(4));
+    set_board_counters(state, b);
+}
+
+// -----------------------------------------------------------------
+// snapshot: リングへの保存と、保存した状態への復元(1 手戻し・ロールバック 1 回分)
+// -----------------------------------------------------------------
+void BM_SnapshotSaveRestore(benchmark::State& state) {
+    const Board b = Board::from(state);
+    Fixture fx{b};
+    tetris_rule::SnapshotRing ring{8, b.rows, b.cols};
+    std::uint64_t frame = 0;
+    for (auto _ : state) {
+        ring.save(fx.world, frame);
+        benchmark::DoNotOptimize(ring.restore(fx.world, frame));
+        ++frame;
+    }
+    state.SetItemsProcessed(state.iterations());
+    set_board_counters(state, b);
+}
+
+// -----------------------------------------------------------------
+// versus: N 人対戦(人 1 は入力なし + CPU)を 1 フレーム進める。Arg(1) = 1 ならワーカー並列
+//   items = 盤面数。1 盤面あたりの時間(time_per_board, 秒)が人数によらず一定かを見る
+// -----------------------------------------------------------------
+void BM_VersusStep(benchmark::State& state) {
+    const auto players = static_cast<std::size_t>(state.range(0));
+    const bool threaded = state.range(1) != 0;
+    const GlobalSetting setting = make_setting(Board{20, 10, 0.0});
+    input::Input idle{};
+    const scene_fw::Env<GlobalSetting> env{idle, setting, 1.0 / 60.0, {}};
+    versus::MatchOptions opt{};
+    opt.players = players;
+    opt.seed = kSeed;
+    WorkStealingPool pool{threaded ? WorkStealingPool::default_worker_count() : 0u};
+
+    const auto make = [&] {
+        auto m = versus::make_match(env, opt);
+        if (!m) std::abort();
+        return std::move(*m);
+    };
+    versus::Match match = make();
+    FreshBatch<versus::Match> fresh{make};
+    for (auto _ : state) {
+        match.step(env, threaded ? &pool : nullptr);
+        if (match.finished()) std::swap(match, fresh.next(state));
+    }
+    const auto boards = state.iterations() * static_cast<std::int64_t>(players);
+    state.SetItemsProcessed(boards);
+    state.counters["time_per_board"] = benchmark::Counter(
+        static_cast<double>(boards), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// -----------------------------------------------------------------
+// run_schedule: N 個のエンティティへ置換コマンドを発行・適用する(スケジューラ単体)
+// -----------------------------------------------------------------
+struct Counter {
+    std::int64_t value{0};
+};
+struct NoResources {};
+
+CommandList bumpCounters(ReadOnlyView<Counter> rv, WriteCommands<Counter> wr,
+                         const NoResources&) {
+    CommandList out;
+    for (auto e : rv.view<Counter>()) {
+        out.push_back(wr.emplace_or_replace<Counter>(e, Counter{rv.get<Counter>(e).value + 1}));
+    }
+    return out;
+}
+
+void BM_RunScheduleApply(benchmark::State& state) {
+    entt::registry reg;
+    reg.ctx().emplace<CommandArena>();
+    const auto n = state.range(0);
+    for (std::int64_t i = 0; i < n; ++i) reg.emplace<Counter>(reg.create());
+
+    using Schedule = StaticSchedule<NoResources, StaticPhase<&bumpCounters>>;
+    for (auto _ : state) {
+        run_schedule(reg, NoResources{}, Schedule{});
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// -----------------------------------------------------------------
+// refill_bag / take_next: 7-Bag からの取り出し(補充込み)
+// -----------------------------------------------------------------
+void BM_TakeNext(benchmark::State& state) {
+    PieceQueue pq{kSeed};
+    refill_bag(pq);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(take_next(pq));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_RefillBag(benchmark::State& state) {
+    PieceQueue pq{kSeed};
+    for (auto _ : state) {
+        refill_bag(pq);
+        pq.queue.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * 7);
+}
+
+// --board_rows= などの独自フラグを取り出し、残りを Google Benchmark に渡す
+struct BoardFlags {
+    std::vector<std::int64_t> rows{20, 40};
+    std::vector<std::int64_t> cols{10, 40};
+    std::vector<std::int64_t> fill_pct{0, 50, 85};
+};
+
+BoardFlags take_board_flags(int& argc, char** argv) {
+    BoardFlags flags;
+    int out = 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        auto value_of = [&](std::string_view name) -> const char* {
+            return arg.starts_with(name) ? argv[i] + name.size() : nullptr;
+        };
+        if (const char* v = value_of("--board_rows=")) {
+            flags.rows = {std::atoll(v)};
+        } else if (const char* v = value_of("--board_cols=")) {
+            flags.cols = {std::atoll(v)};
+        } else if (const char* v = value_of("--board_fill=")) {
+            flags.fill_pct = {static_cast<std::int64_t>(std::atof(v) * 100.0)};
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argc = out;
+    return flags;
+}
+
+void register_benchmarks(const BoardFlags& f) {
+    const std::vector<std::vector<std::int64_t>> board{f.rows, f.cols, f.fill_pct};
+    benchmark::RegisterBenchmark("BM_StepWorld", BM_StepWorld)->ArgsProduct(board);
+    benchmark::RegisterBenchmark("BM_CanPlaceOnGrid", BM_CanPlaceOnGrid)->ArgsProduct(board);
+    benchmark::RegisterBenchmark("BM_ComputeGhostPosition", BM_ComputeGhostPosition)
+        ->ArgsProduct(board);
+    benchmark::RegisterBenchmark("BM_LineClear", BM_LineClear)
+        ->ArgsProduct({f.rows, f.cols, f.fill_pct, {0, 1, 2, 3, 4}});
+    benchmark::RegisterBenchmark("BM_SrsRotation", BM_SrsRotation)->ArgsProduct(board);
+    benchmark::RegisterBenchmark("BM_PlacementSearch", BM_PlacementSearch)->ArgsProduct(board);
+    benchmark::RegisterBenchmark("BM_PlanPlacement", BM_PlanPlacement)
+        ->ArgsProduct({f.rows, f.cols, f.fill_pct, {1, 2, 3}, {1, 4}})
+        ->UseRealTime();
+    benchmark::RegisterBenchmark("BM_SnapshotSaveRestore", BM_SnapshotSaveRestore)
+        ->ArgsProduct(board);
+    benchmark::RegisterBenchmark("BM_VersusStep", BM_VersusStep)
+        ->ArgsProduct({{2, 4, 8}, {0, 1}})
+        ->UseRealTime();
+    benchmark::RegisterBenchmark("BM_RunScheduleApply", BM_RunScheduleApply)
+        ->RangeMultiplier(8)
+        ->Range(8, 4096);
+    benchmark::RegisterBenchmark("BM_TakeNext", BM_TakeNext);
+    benchmark::RegisterBenchmark("BM_RefillBag", BM_RefillBag);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const BoardFlags flags = take_board_flags(argc, argv);
+    register_benchmarks(flags);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
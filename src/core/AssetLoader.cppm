@@ -0,0 +1,181 @@
+module;
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+export module AssetLoader;
+
+// =============================
+// 非同期アセットローダ
+//   ファイルの中身(バイト列)をメインループの外で読み込み、終わったものを poll() で受け取る。
+//   ネイティブは読み込み専用のワーカースレッド 1 本、Emscripten(pthread なし)は
+//   emscripten_async_wget_data でブラウザに取りに行かせる(どちらもメインスレッドは待たない)。
+//   バイト列の解釈(フォントを開く・テクスチャを作る)は poll() の呼び出し側=メインスレッドで行う。
+// =============================
+
+export namespace assets {
+
+using Bytes = std::vector<std::uint8_t>;
+
+/**
+ * @brief 読み込み 1 件の結果
+ * @param path 要求したパス(Emscripten ではページからの相対 URL)
+ * @param ok 読み込めたか(false のとき error に理由)
+ * @param bytes ファイルの中身
+ * @param elapsed_ms 要求から読み込み完了までの時間
+ */
+struct LoadResult {
+    std::string path;
+    bool ok{false};
+    Bytes bytes;
+    std::string error;
+    double elapsed_ms{0.0};
+};
+
+// ファイル全体を同期で読む(失敗時は空のまま false)
+inline bool read_file(const std::string& path, Bytes& out) {
+    std::ifstream is(path, std::ios::binary | std::ios::ate);
+    if (!is) return false;
+    const auto size = is.tellg();
+    if (size < 0) return false;
+    out.resize(static_cast<std::size_t>(size));
+    is.seekg(0);
+    return static_cast<bool>(is.read(reinterpret_cast<char*>(out.data()), size));
+}
+
+class AssetLoader {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    AssetLoader() : state_(std::make_shared<State>()) {}
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+    ~AssetLoader() {
+        {
+            std::lock_guard lk(state_->mutex);
+            state_->stopping = true;
+        }
+        state_->wake.notify_all();
+        if (worker_.joinable()) worker_.join();
+    }
+
+    // path の読み込みを要求する(すぐ戻る)
+    void request(std::string path) {
+        ++in_flight_;
+#ifdef __EMSCRIPTEN__
+        // コールバックはブラウザのイベントループから(メインスレッドで)呼ばれる
+        auto* job = new WebJob{state_, Job{std::move(path), Clock::now()}};
+        emscripten_async_wget_data(job->job.path.c_str(), job, &AssetLoader::on_web_load,
+                                   &AssetLoader::on_web_error);
+#else
+        {
+            std::lock_guard lk(state_->mutex);
+            state_->jobs.push_back(Job{std::move(path), Clock::now()});
+        }
+        if (!worker_.joinable()) worker_ = std::thread([s = state_] { worker_loop(*s); });
+        state_->wake.notify_one();
+#endif
+    }
+
+    // 前回の poll 以降に終わった読み込み(次の poll まで有効。bytes は持ち出してよい)
+    std::span<LoadResult> poll() {
+        delivered_.clear();
+        {
+            std::lock_guard lk(state_->mutex);
+            delivered_.swap(state_->done);
+        }
+        in_flight_ -= delivered_.size();
+        return delivered_;
+    }
+
+    // 要求済みで、まだ poll で受け取っていない件数
+    [[nodiscard]] std::size_t pending() const noexcept { return in_flight_; }
+
+   private:
+    struct Job {
+        std::string path;
+        Clock::time_point requested;
+    };
+    // ワーカー(またはブラウザのコールバック)とメインスレッドの共有部分
+    struct State {
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<Job> jobs;
+        std::vector<LoadResult> done;
+        bool stopping{false};
+    };
+
+    std::shared_ptr<State> state_;
+    std::thread worker_;                 // 初回の request で起動(Emscripten では使わない)
+    std::vector<LoadResult> delivered_;  // poll が返す結果(done と入れ替えて使い回す)
+    std::size_t in_flight_{0};
+
+    static double ms_since(Clock::time_point t) noexcept {
+        return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+    }
+
+    static void finish(State& s, LoadResult&& r) {
+        std::lock_guard lk(s.mutex);
+        s.done.push_back(std::move(r));
+    }
+
+    static void worker_loop(State& s) {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock lk(s.mutex);
+                s.wake.wait(lk, [&s] { return s.stopping || !s.jobs.empty(); });
+                if (s.stopping) return;
+                job = std::move(s.jobs.front());
+                s.jobs.pop_front();
+            }
+            LoadResult r;
+            r.path = std::move(job.path);
+            r.ok = read_file(r.path, r.bytes);
+            if (!r.ok) r.error = "cannot read " + r.path;
+            r.elapsed_ms = ms_since(job.requested);
+            finish(s, std::move(r));
+        }
+    }
+
+#ifdef __EMSCRIPTEN__
+    struct WebJob {
+        std::shared_ptr<State> state;  // ローダが先に破棄されても安全に書き込める
+        Job job;
+    };
+    static void on_web_load(void* arg, void* data, int size) {
+        std::unique_ptr<WebJob> web{static_cast<WebJob*>(arg)};
+        LoadResult r;
+        r.path = std::move(web->job.path);
+        r.ok = true;
+        const auto* p = static_cast<const std::uint8_t*>(data);
+        r.bytes.assign(p, p + size);
+        r.elapsed_ms = ms_since(web->job.requested);
+        finish(*web->state, std::move(r));
+    }
+    static void on_web_error(void* arg) {
+        std::unique_ptr<WebJob> web{static_cast<WebJob*>(arg)};
+        LoadResult r;
+        r.path = std::move(web->job.path);
+        r.error = "cannot fetch " + r.path;
+        r.elapsed_ms = ms_since(web->job.requested);
+        finish(*web->state, std::move(r));
+    }
+#endif
+};
+
+}  // namespace assets
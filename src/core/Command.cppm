@@ -2,9 +2,16 @@ module;
 #ifndef __EMSCRIPTEN__
 #include "entt_assert_with_stacktrace.hpp"
 #endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <entt/entt.hpp>
 #include <functional>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -12,6 +19,9 @@ module;
 
 export module Command;
 
+import ThreadPool;
+import Profiler;
+
 // ------------------------------
 // 共通ユーティリティ
 // ------------------------------
@@ -24,21 +34,250 @@ struct is_in : std::bool_constant<(std::is_same_v<T, List> || ...)> {};
 template <class T, class... List>
 inline constexpr bool is_in_v = is_in<T, List...>::value;
 
+// コンパイル時の型リスト
+template <class... Ts>
+struct type_list {};
+
+// A と B に共通の型があるか(void は「宣言なし」なので数えない)
+template <class A, class B>
+struct lists_intersect;
+
+template <class... As, class... Bs>
+struct lists_intersect<type_list<As...>, type_list<Bs...>>
+    : std::bool_constant<((!std::is_void_v<As> && is_in_v<As, Bs...>) || ...)> {};
+
 }  // namespace detail
 
+// ------------------------------
+// コマンドアリーナ(フレーム単位のモノトニック確保)
+// ------------------------------
+
+/**
+ * @brief 1 フレーム分のコマンド確保統計
+ * @param commands 適用したコマンド数
+ * @param bytes アリーナから確保したバイト数(CommandList の要素領域＋インラインに収まらない本体)
+ * @param arena_spills 初期バッファに収まらず上流(ヒープ)へ溢れた回数(定常状態では 0 が期待値)
+ *        アリーナ経由の確保だけを数える。コンテナや entt のストレージ伸長は含まない
+ */
+export struct CommandArenaStats {
+    std::size_t commands{0};
+    std::size_t bytes{0};
+    std::size_t arena_spills{0};
+};
+
+namespace detail {
+
+// 確保回数とバイト数を数えるだけの memory_resource
+class CountingResource final : public std::pmr::memory_resource {
+   public:
+    explicit CountingResource(std::pmr::memory_resource* upstream) noexcept
+        : upstream_(upstream) {}
+
+    std::size_t bytes{0};
+    std::size_t allocations{0};
+
+   private:
+    std::pmr::memory_resource* upstream_;
+
+    void* do_allocate(std::size_t n, std::size_t align) override {
+        bytes += n;
+        ++allocations;
+        return upstream_->allocate(n, align);
+    }
+    void do_deallocate(void* p, std::size_t n, std::size_t align) override {
+        upstream_->deallocate(p, n, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// 現在のスレッドでコマンド確保に使う memory_resource(未設定ならヒープ)
+inline std::pmr::memory_resource*& current_command_resource() noexcept {
+    thread_local std::pmr::memory_resource* resource = nullptr;
+    return resource;
+}
+
+}  // namespace detail
+
+/**
+ * @brief フレームごとにリセットするコマンド用アリーナ
+ *
+ * 初期バッファ上のモノトニック確保なので、解放は reset() でまとめて行う。
+ * reset() より長く Command / CommandList を保持してはいけない。
+ */
+export class CommandArena {
+   public:
+    explicit CommandArena(std::size_t initial_bytes = 64 * 1024)
+        : state_(std::make_unique<State>(initial_bytes)) {}
+
+    [[nodiscard]] std::pmr::memory_resource* resource() noexcept { return &state_->front; }
+
+    // フレーム先頭で呼ぶ。確保済み領域を初期バッファへ巻き戻し、統計を 0 にする
+    void reset() noexcept {
+        state_->mono.release();
+        state_->front.bytes = 0;
+        state_->front.allocations = 0;
+        state_->upstream.allocations = 0;
+        state_->upstream.bytes = 0;
+        state_->commands = 0;
+    }
+
+    void count_commands(std::size_t n) noexcept { state_->commands += n; }
+
+    // 直近の reset() 以降の統計
+    [[nodiscard]] CommandArenaStats stats() const noexcept {
+        return CommandArenaStats{state_->commands, state_->front.bytes,
+                                 state_->upstream.allocations};
+    }
+
+   private:
+    struct State {
+        explicit State(std::size_t initial_bytes)
+            : buffer(initial_bytes),
+              upstream(std::pmr::new_delete_resource()),
+              mono(buffer.data(), buffer.size(), &upstream),
+              front(&mono) {}
+        std::vector<std::byte> buffer;
+        detail::CountingResource upstream;  // ヒープへの溢れを数える
+        std::pmr::monotonic_buffer_resource mono;
+        detail::CountingResource front;  // アリーナからの確保量を数える
+        std::size_t commands{0};
+    };
+    std::unique_ptr<State> state_;  // resource のアドレスを安定させるため間接保持
+};
+
+// スコープ中、このスレッドで作る Command / CommandList の確保先を arena にする
+export class CommandArenaScope {
+   public:
+    explicit CommandArenaScope(CommandArena* arena) noexcept
+        : prev_(detail::current_command_resource()) {
+        if (arena) detail::current_command_resource() = arena->resource();
+    }
+    ~CommandArenaScope() { detail::current_command_resource() = prev_; }
+    CommandArenaScope(const CommandArenaScope&) = delete;
+    CommandArenaScope& operator=(const CommandArenaScope&) = delete;
+
+   private:
+    std::pmr::memory_resource* prev_;
+};
+
+export inline std::pmr::memory_resource* command_resource() noexcept {
+    auto* r = detail::current_command_resource();
+    return r ? r : std::pmr::new_delete_resource();
+}
+
 // ------------------------------
 // Command とコマンドユーティリティ
 // ------------------------------
 
 // 汎用 Command：実行時に registry へ遅延適用する副作用
-export struct Command {
-    // 小粒ラムダで十分。パフォーマンスが必要なら小さな関数ラッパへ差し替え可
-    std::function<void(entt::registry&)> apply;
+//   小さな関数オブジェクトはインラインに保持し、収まらないものは現在のアリーナから確保する
+export class Command {
+   public:
+    static constexpr std::size_t kInlineSize = 48;
+
+    Command() noexcept = default;
+
+    template <class F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, Command> &&
+                 std::is_invocable_v<std::decay_t<F>&, entt::registry&>)
+    Command(F&& f) {  // NOLINT(google-explicit-constructor): Command{lambda} で使う
+        using Fn = std::decay_t<F>;
+        if constexpr (fits_inline<Fn>()) {
+            target_ = ::new (static_cast<void*>(storage_)) Fn(std::forward<F>(f));
+        } else {
+            resource_ = command_resource();
+            void* p = resource_->allocate(sizeof(Fn), alignof(Fn));
+            target_ = ::new (p) Fn(std::forward<F>(f));
+        }
+        ops_ = &kOpsFor<Fn>;
+    }
+
+    Command(Command&& other) noexcept { take(other); }
+    Command& operator=(Command&& other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+    Command(const Command&) = delete;
+    Command& operator=(const Command&) = delete;
+    ~Command() { reset(); }
+
+    void apply(entt::registry& r) { ops_->invoke(target_, r); }
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+   private:
+    struct Ops {
+        void (*invoke)(void*, entt::registry&);
+        void (*relocate)(void* dst, void* src) noexcept;  // インライン保持時のみ使用
+        void (*destroy)(void*) noexcept;
+        std::size_t size;
+        std::size_t align;
+    };
+
+    template <class Fn>
+    static constexpr bool fits_inline() {
+        return sizeof(Fn) <= kInlineSize && alignof(Fn) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+    template <class Fn>
+    static constexpr Ops kOpsFor{
+        [](void* p, entt::registry& r) { (*static_cast<Fn*>(p))(r); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        },
+        [](void* p) noexcept { static_cast<Fn*>(p)->~Fn(); },
+        sizeof(Fn),
+        alignof(Fn),
+    };
+
+    alignas(std::max_align_t) std::byte storage_[kInlineSize];
+    void* target_{nullptr};
+    std::pmr::memory_resource* resource_{nullptr};  // 非 null ならアリーナ/ヒープ確保
+    const Ops* ops_{nullptr};
+
+    void take(Command& other) noexcept {
+        ops_ = other.ops_;
+        resource_ = other.resource_;
+        if (!ops_) return;
+        if (resource_) {
+            target_ = other.target_;
+        } else {
+            ops_->relocate(storage_, other.storage_);
+            target_ = storage_;
+        }
+        other.ops_ = nullptr;
+        other.target_ = nullptr;
+        other.resource_ = nullptr;
+    }
+
+    void reset() noexcept {
+        if (!ops_) return;
+        ops_->destroy(target_);
+        if (resource_) resource_->deallocate(target_, ops_->size, ops_->align);
+        ops_ = nullptr;
+        target_ = nullptr;
+        resource_ = nullptr;
+    }
+};
+
+// System が返すコマンド列。要素領域は現在のアリーナ(なければヒープ)から確保する
+export class CommandList : public std::pmr::vector<Command> {
+    using Base = std::pmr::vector<Command>;
+
+   public:
+    CommandList() noexcept : Base(command_resource()) {}
+    using Base::Base;
 };
 
 // コマンドバッファ
 export struct CommandBuffer {
-    std::vector<Command> cmds;
+    CommandList cmds;
     void add(Command c) { cmds.emplace_back(std::move(c)); }
     void clear() { cmds.clear(); }
     void apply_all(entt::registry& r) {
@@ -47,6 +286,38 @@ export struct CommandBuffer {
     }
 };
 
+// ------------------------------
+// フレームイベント(1 フレームの間に起きたことのビット集合)
+//   registry の ctx に置き、コマンドや EnTT のシグナル(on_update など)から raise する。
+//   静的スケジュールの StaticPhaseIf と組み合わせ、起動条件のイベントが無いフレームは
+//   System ごと飛ばす。end_frame() で今フレームの集合を last へ移して空にする
+// ------------------------------
+export template <class Event>
+    requires std::is_enum_v<Event>
+class FrameEvents {
+   public:
+    void raise(Event e) noexcept { pending_ |= bit(e); }
+
+    // end_frame 以降に起きたか(いずれか 1 つでも)
+    template <class... Es>
+    [[nodiscard]] bool any(Es... es) const noexcept {
+        return (pending_ & (bit(es) | ...)) != 0;
+    }
+
+    // 直前に閉じたフレームで起きたか(フレームの外から結果を見る用)
+    [[nodiscard]] bool happened_last_frame(Event e) const noexcept { return (last_ & bit(e)) != 0; }
+
+    void end_frame() noexcept { last_ = std::exchange(pending_, 0u); }
+
+   private:
+    static constexpr std::uint32_t bit(Event e) noexcept {
+        return std::uint32_t{1} << static_cast<unsigned>(e);
+    }
+
+    std::uint32_t pending_{0};
+    std::uint32_t last_{0};
+};
+
 // よく使うコマンドのヘルパ(テンプレートで汎用化)
 export namespace cmd {
 
@@ -67,11 +338,21 @@ Command emplace_or_replace(entt::entity e, Args&&... args) {
 }
 
 // 値を直接渡すオーバーロードも用意(明示 move 向け)
+// 値は Command 本体へ直接ムーブする(別途ヒープに保持しない)
 template <class T>
 Command emplace_or_replace(entt::entity e, T&& value) {
-    auto holder = std::make_unique<std::decay_t<T>>(std::forward<T>(value));
-    return Command{[e, holder = std::move(holder)](entt::registry& r) mutable {
-        r.emplace_or_replace<std::decay_t<T>>(e, std::move(*holder));
+    return Command{[e, value = std::decay_t<T>(std::forward<T>(value))](
+                       entt::registry& r) mutable {
+        r.emplace_or_replace<std::decay_t<T>>(e, std::move(value));
+    }};
+}
+
+// patch<T>(entity, fn): 既存の T をその場で書き換える(コピー＆置換を避ける)
+//   fn: void(T&)。entt の patch 経由なので on_update も発火する
+template <class T, class Fn>
+Command patch(entt::entity e, Fn&& fn) {
+    return Command{[e, fn = std::forward<Fn>(fn)](entt::registry& r) mutable {
+        if (r.all_of<T>(e)) r.patch<T>(e, fn);
     }};
 }
 
@@ -88,16 +369,24 @@ inline Command destroy(entt::entity e) {
     }};
 }
 
-inline Command create_then(std::function<void(entt::registry&, entt::entity)> f) {
-    return Command{[f = std::move(f)](entt::registry& r) {
+// f: void(entt::registry&, entt::entity)
+template <class Fn>
+Command create_then(Fn&& f) {
+    return Command{[f = std::forward<Fn>(f)](entt::registry& r) mutable {
         const auto e = r.create();
         f(r, e);
     }};
 }
 
-}  // namespace cmd
+// ctx の FrameEvents<Event> にイベントを立てる(置かれていなければ何もしない)
+template <class Event>
+Command raise(Event ev) {
+    return Command{[ev](entt::registry& r) {
+        if (auto* events = r.ctx().find<FrameEvents<Event>>()) events->raise(ev);
+    }};
+}
 
-export using CommandList = std::vector<Command>;
+}  // namespace cmd
 
 // ------------------------------
 // System 用の型安全ラッパ
@@ -138,6 +427,15 @@ struct WriteCommands {
         return cmd::emplace_or_replace<T>(e, std::forward<Args>(args)...);
     }
 
+    // patch(その場更新)
+    template <class T, class Fn>
+    Command patch(entt::entity e, Fn&& fn) const {
+        static_assert(detail::is_in_v<T, WriteComponents...>,
+                      "System is not allowed to WRITE this component type");
+        static_assert(std::is_invocable_v<Fn&, T&>, "patch function must be callable as void(T&)");
+        return cmd::patch<T>(e, std::forward<Fn>(fn));
+    }
+
     // remove
     template <class T>
     Command remove(entt::entity e) const {
@@ -149,8 +447,15 @@ struct WriteCommands {
     // destroy はコンポーネント型に依存しないので常に許可するかどうかはポリシー次第
     Command destroy(entt::entity e) const { return cmd::destroy(e); }
 
-    Command create_then(std::function<void(entt::registry&, entt::entity)> f) const {
-        return cmd::create_then(std::move(f));
+    template <class Fn>
+    Command create_then(Fn&& f) const {
+        return cmd::create_then(std::forward<Fn>(f));
+    }
+
+    // イベントはコンポーネントではないので、どの System からでも立ててよい
+    template <class Event>
+    Command raise(Event ev) const {
+        return cmd::raise(ev);
     }
 };
 
@@ -199,15 +504,30 @@ PureSystem<Resources> run_if(PureSystem<Resources> sys, Cond cond) {
     };
 }
 
+// System が READ / WRITE するコンポーネント型(実行時に検査する用の型 ID 集合)
+export struct SystemAccess {
+    std::vector<entt::id_type> reads;
+    std::vector<entt::id_type> writes;
+};
+
 // フェーズ/スケジュール：競合を分けて逐次適用
+//   parallel = true のフェーズは、同じ registry の状態を読んで全 System を実行し、
+//   その後コマンド列を宣言順に適用する(make_parallel_phase で作る)。
+//   実際に複数スレッドで走らせるのは、access が System ごとに揃っていて互いに衝突しないときだけ
 export template <class Resources>
 struct Phase {
     std::vector<PureSystem<Resources>> systems;
+    bool parallel{false};
+    std::vector<SystemAccess> access{};  // systems と同じ並び。空なら並列実行しない
+    std::vector<std::string_view> names{};  // 計測用の System 名(同じ並び。空なら "system")
 };
 
+// executor が null(または Emscripten)のときは parallel フェーズも逐次実行する
+//   (読む状態と適用順は並列時と同じ)
 export template <class Resources>
 struct Schedule {
     std::vector<Phase<Resources>> phases;
+    WorkStealingPool* executor{nullptr};
 };
 
 // System 実装を PureSystem に包むヘルパ
@@ -225,19 +545,299 @@ PureSystem<Resources> make_system(CommandList (*func)(ReadOnlyView<ReadComponent
     };
 }
 
+// ------------------------------
+// System のアクセス集合(コンパイル時)
+//   make_system に渡す関数ポインタ型から READ / WRITE 型リストを取り出す
+// ------------------------------
+export template <class F>
+struct system_access;
+
+export template <class Resources, class... ReadComponents, class... WriteComponents>
+struct system_access<CommandList (*)(ReadOnlyView<ReadComponents...>,
+                                     WriteCommands<WriteComponents...>, const Resources&)> {
+    using resources = Resources;
+    using reads = detail::type_list<ReadComponents...>;
+    using writes = detail::type_list<WriteComponents...>;
+};
+
+// 2 つの System が同じフェーズで並列に走れないか(書き込み対象が相手の読み書き対象と重なる)
+//   生の Command{...} で書く System(WriteCommands<void>)は宣言外の書き込みを検査できない点に注意
+export template <class A, class B>
+inline constexpr bool systems_conflict_v =
+    detail::lists_intersect<typename system_access<A>::writes,
+                            typename system_access<B>::writes>::value ||
+    detail::lists_intersect<typename system_access<A>::writes,
+                            typename system_access<B>::reads>::value ||
+    detail::lists_intersect<typename system_access<A>::reads,
+                            typename system_access<B>::writes>::value;
+
+namespace detail {
+
+template <class First, class... Rest>
+constexpr bool systems_disjoint() {
+    if constexpr (sizeof...(Rest) == 0) {
+        return true;
+    } else {
+        return (!systems_conflict_v<First, Rest> && ...) && systems_disjoint<Rest...>();
+    }
+}
+
+template <class... Ts>
+std::vector<entt::id_type> type_ids(type_list<Ts...>) {
+    std::vector<entt::id_type> out;
+    (
+        [&] {
+            if constexpr (!std::is_void_v<Ts>) out.push_back(entt::type_hash<Ts>::value());
+        }(),
+        ...);
+    return out;
+}
+
+template <class F>
+SystemAccess access_of() {
+    return SystemAccess{type_ids(typename system_access<F>::reads{}),
+                        type_ids(typename system_access<F>::writes{})};
+}
+
+inline bool ids_intersect(const std::vector<entt::id_type>& a,
+                          const std::vector<entt::id_type>& b) noexcept {
+    return std::any_of(a.begin(), a.end(), [&](entt::id_type id) {
+        return std::find(b.begin(), b.end(), id) != b.end();
+    });
+}
+
+// 並列に走らせてよいフェーズか(手組みの Phase{..., true} もここで検査する)
+//   access が欠けている System を含むなら、衝突しないと言えないので false
+template <class Resources>
+bool phase_is_disjoint(const Phase<Resources>& ph) noexcept {
+    if (ph.access.size() != ph.systems.size()) return false;
+    for (std::size_t i = 0; i < ph.access.size(); ++i) {
+        for (std::size_t j = i + 1; j < ph.access.size(); ++j) {
+            const auto& a = ph.access[i];
+            const auto& b = ph.access[j];
+            if (ids_intersect(a.writes, b.writes) || ids_intersect(a.writes, b.reads) ||
+                ids_intersect(a.reads, b.writes)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace detail
+
+// 並列フェーズを作る。READ/WRITE 集合が衝突する System の組はコンパイルエラーにする
+//   例: make_parallel_phase<Res, &scoreSystem, &audioSystem>()
+export template <class Resources, auto... Systems>
+    requires(sizeof...(Systems) > 0)
+Phase<Resources> make_parallel_phase() {
+    static_assert(
+        (std::is_same_v<typename system_access<decltype(Systems)>::resources, Resources> && ...),
+        "All systems in a phase must take the same Resources type");
+    static_assert(detail::systems_disjoint<decltype(Systems)...>(),
+                  "Systems in a parallel phase have conflicting READ/WRITE sets");
+    return Phase<Resources>{{make_system<Resources>(Systems)...},
+                            true,
+                            {detail::access_of<decltype(Systems)>()...},
+                            {profiler::function_name<Systems>()...}};
+}
+
+// 並列フェーズ用のスロット別アリーナ(スロット i = フェーズ内 i 番目の System)
+//   各スロットは同時に 1 スレッドしか触らないので、アリーナ自体は同期不要
+export struct ParallelCommandArenas {
+    std::vector<CommandArena> slots;
+
+    void reset() noexcept {
+        for (auto& a : slots) a.reset();
+    }
+    void reserve_slots(std::size_t n) {
+        while (slots.size() < n) slots.emplace_back(16 * 1024);
+    }
+};
+
+namespace detail {
+
+// registry の ctx が参照しているプロファイラ(なければ null)
+inline profiler::FrameProfiler* attached_profiler(entt::registry& world) noexcept {
+    auto* shared = world.ctx().find<profiler::SharedProfiler>();
+    return shared ? shared->get() : nullptr;
+}
+
+}  // namespace detail
+
 // ------------------------------
 // 実行：各フェーズで System 群 → コマンド一括適用
+//   registry の ctx に CommandArena があれば、フレーム先頭でリセットして全コマンドの確保先にする
+//   parallel フェーズは全 System を同じ状態に対して実行し、宣言順にコマンドを適用する
+//   (executor の有無・スレッド数に関わらず、読む状態も適用順も同じなので結果は決定的)
+//   複数スレッドで走らせるのは、access が揃っていて互いに衝突しないフェーズだけ
+//   プロファイラ有効ビルドでは静的版と同じく System / apply / phase / 全体を区間として記録する
+//   (並列フェーズの System 区間はワーカースレッドから記録される)
 // ------------------------------
 export template <class Resources>
 inline void run_schedule(entt::registry& world, const Resources& res,
                          const Schedule<Resources>& sch) {
+    auto* arena = world.ctx().find<CommandArena>();
+    if (arena) arena->reset();
+    CommandArenaScope scope{arena};
+
+    auto* slot_arenas = world.ctx().find<ParallelCommandArenas>();
+    if (slot_arenas) slot_arenas->reset();
+
+    profiler::FrameProfiler* prof = nullptr;
+    if constexpr (profiler::kEnabled) prof = detail::attached_profiler(world);
+    profiler::ScopedZone frame_zone{prof, "run_schedule", "frame"};
+
+    const entt::registry& view = world;
     for (const auto& ph : sch.phases) {
-        CommandList buf;
-        const entt::registry& view = world;
-        for (const auto& sys : ph.systems) {
-            buf = sys(view, res);  // RVO/ムーブ
-            for (auto& c : buf) c.apply(world);
-            buf.clear();
+        const std::size_t n = ph.systems.size();
+        const auto name_of = [&ph](std::size_t i) -> std::string_view {
+            return i < ph.names.size() ? ph.names[i] : std::string_view{"system"};
+        };
+        const auto run_system = [&](std::size_t i) {
+            profiler::ScopedZone zone{prof, name_of(i), "system"};
+            CommandList out = ph.systems[i](view, res);
+            zone.set_commands(out.size());
+            return out;
+        };
+        const auto apply = [&](CommandList& buf, std::size_t i) {
+            {
+                profiler::ScopedZone zone{prof, name_of(i), "apply"};
+                for (auto& c : buf) c.apply(world);
+            }
+            if (arena) arena->count_commands(buf.size());
+        };
+        // フェーズ名は静的版と同じく先頭の System 名で代表させる
+        profiler::ScopedZone phase_zone{prof, name_of(0), "phase"};
+
+        if (ph.parallel) {
+            std::pmr::vector<std::optional<CommandList>> results(n, command_resource());
+            if (sch.executor && n > 1 && detail::phase_is_disjoint(ph)) {
+                if (arena && !slot_arenas) {
+                    slot_arenas = &world.ctx().emplace<ParallelCommandArenas>();
+                }
+                if (slot_arenas) slot_arenas->reserve_slots(n);
+                sch.executor->parallel_for(n, [&](std::size_t i) {
+                    CommandArenaScope slot_scope{slot_arenas ? &slot_arenas->slots[i] : nullptr};
+                    results[i].emplace(run_system(i));
+                });
+            } else {
+                // 逐次でも、全 System が同じ状態を読んでからまとめて適用する
+                for (std::size_t i = 0; i < n; ++i) results[i].emplace(run_system(i));
+            }
+            for (std::size_t i = 0; i < n; ++i) apply(*results[i], i);
+            continue;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            CommandList buf = run_system(i);  // RVO/ムーブ
+            apply(buf, i);
         }
     }
 }
+
+// ------------------------------
+// 静的スケジュール(コンパイル時に System 列が決まる版)
+//   System を関数ポインタの非型テンプレート引数として持つので、std::function を介さず
+//   直接呼び出される(インライン化可能)。フレームごとの Phase/vector 構築も不要。
+//   例: using MySchedule = StaticSchedule<Res, StaticPhase<&a, &b>, StaticPhase<&c>>;
+//       run_schedule(world, res, MySchedule{});
+//   条件を満たすフレームだけ動かすフェーズは StaticPhaseIf<&cond, &d> と書く
+//   実行時に System 列を組み替えたい場合は Schedule/Phase を使う
+// ------------------------------
+namespace detail {
+
+// 関数ポインタの型から ReadOnlyView / WriteCommands を組み立てて呼ぶ
+template <class Resources, class... ReadComponents, class... WriteComponents>
+inline CommandList call_system(CommandList (*func)(ReadOnlyView<ReadComponents...>,
+                                                   WriteCommands<WriteComponents...>,
+                                                   const Resources&),
+                               const entt::registry& reg, const Resources& res) {
+    return func(ReadOnlyView<ReadComponents...>{reg}, WriteCommands<WriteComponents...>{}, res);
+}
+
+template <auto System, class Resources>
+inline void run_static_system(entt::registry& world, const Resources& res, CommandArena* arena,
+                              profiler::FrameProfiler* prof) {
+    const entt::registry& view = world;
+    if constexpr (profiler::kEnabled) {
+        if (prof) {
+            // System 本体(コマンド生成)とコマンド適用を別の区間として測る
+            constexpr std::string_view name = profiler::function_name<System>();
+            CommandList buf = [&] {
+                profiler::ScopedZone zone{prof, name, "system"};
+                CommandList out = call_system(System, view, res);
+                zone.set_commands(out.size());
+                return out;
+            }();
+            {
+                profiler::ScopedZone zone{prof, name, "apply"};
+                for (auto& c : buf) c.apply(world);
+            }
+            if (arena) arena->count_commands(buf.size());
+            return;
+        }
+    }
+    CommandList buf = call_system(System, view, res);
+    for (auto& c : buf) c.apply(world);
+    if (arena) arena->count_commands(buf.size());
+}
+
+// フェーズ名(計測用): 先頭の System 名で代表させる
+template <auto First, auto...>
+inline constexpr std::string_view phase_name = profiler::function_name<First>();
+
+}  // namespace detail
+
+// System を宣言順に逐次実行・適用するフェーズ
+export template <auto... Systems>
+struct StaticPhase {
+    template <class Resources>
+    static void run(entt::registry& world, const Resources& res, CommandArena* arena,
+                    profiler::FrameProfiler* prof = nullptr) {
+        static_assert(
+            (std::is_same_v<typename system_access<decltype(Systems)>::resources, Resources> &&
+             ...),
+            "All systems in a StaticPhase must take the schedule's Resources type");
+        if constexpr (profiler::kEnabled) {
+            profiler::ScopedZone zone{prof, detail::phase_name<Systems...>, "phase"};
+            (detail::run_static_system<Systems>(world, res, arena, prof), ...);
+        } else {
+            (detail::run_static_system<Systems>(world, res, arena, nullptr), ...);
+        }
+    }
+};
+
+// 条件付きフェーズ(run_if の静的版): Cond(registry, res) が true のフレームだけ実行する
+//   Cond は bool (*)(const entt::registry&, const Resources&)。FrameEvents を見て
+//   「何が起きたら動くか」を System ごとに宣言するのに使う
+export template <auto Cond, auto... Systems>
+struct StaticPhaseIf {
+    template <class Resources>
+    static void run(entt::registry& world, const Resources& res, CommandArena* arena,
+                    profiler::FrameProfiler* prof = nullptr) {
+        static_assert(std::is_invocable_r_v<bool, decltype(Cond), const entt::registry&,
+                                            const Resources&>,
+                      "StaticPhaseIf condition must be callable as (registry, Resources)");
+        if (!Cond(std::as_const(world), res)) return;
+        StaticPhase<Systems...>::run(world, res, arena, prof);
+    }
+};
+
+export template <class Resources, class... Phases>
+struct StaticSchedule {};
+
+// 静的スケジュールの実行(CommandArena の扱いは動的版と同じ)
+//   プロファイラ有効ビルドでは、registry の ctx に SharedProfiler があれば
+//   System / コマンド適用 / フェーズ / スケジュール全体を区間として記録する
+export template <class Resources, class... Phases>
+inline void run_schedule(entt::registry& world, const Resources& res,
+                         StaticSchedule<Resources, Phases...>) {
+    auto* arena = world.ctx().find<CommandArena>();
+    if (arena) arena->reset();
+    CommandArenaScope scope{arena};
+
+    profiler::FrameProfiler* prof = nullptr;
+    if constexpr (profiler::kEnabled) prof = detail::attached_profiler(world);
+    profiler::ScopedZone zone{prof, "run_schedule", "frame"};
+    (Phases::run(world, res, arena, prof), ...);
+}
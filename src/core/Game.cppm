@@ -1,9 +1,20 @@
 module;
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <functional>  // 追加
 #include <iostream>    // エラーログ用
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <variant>
 #include <vector>  // 追加
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -12,9 +23,42 @@ module;
 export module Game;
 import SceneFramework; // 新規
 import Input;
+import LatencyHistogram;
+import TripleBuffer;
+
+// =============================
+// 入力レイテンシの計測結果
+//   input_to_sim:     キーイベント発生 → そのエッジを消費するシミュレーション 1 ステップ目の開始
+//   input_to_present: キーイベント発生 → そのステップの結果を描画し終えた(present が返った)時点
+//   いずれもナノ秒。dropped_steps は追いつき上限を超えて捨てた固定ステップ数
+// =============================
+export struct InputLatencyStats {
+    LatencyHistogram input_to_sim;
+    LatencyHistogram input_to_present;
+    std::uint64_t dropped_steps{0};
+};
+
+// 描画用の写しの型(写しを出せないシーン実装では使わないので空)
+template <class Setting, class SceneImpl>
+struct SceneSnapshotTypes {
+    using Snapshot = std::monostate;
+    using RenderState = std::monostate;
+};
+template <class Setting, class SceneImpl>
+    requires scene_fw::SnapshotSceneAPI<SceneImpl, Setting>
+struct SceneSnapshotTypes<Setting, SceneImpl> {
+    using Snapshot = typename SceneImpl::Snapshot;
+    using RenderState = typename SceneImpl::RenderState;
+};
 
 // =============================
 // フレーム処理(Game 本体)
+//   シーン実装が描画用の写しを出せて、固定刻みで進めるなら(Emscripten を除く)、
+//   シミュレーションは専用スレッドで固定刻みのまま進み、1 ステップ群ごとに写しを
+//   トリプルバッファへ公開する。メインスレッド(SDL のウィンドウ・レンダラを作ったスレッド)は
+//   入力を集めて渡し、届いている最新の写しを描いて表示するだけなので、VSync で present が
+//   待たされてもシミュレーションの刻みは乱れない。それ以外は従来どおり 1 スレッドで
+//   入力 → 更新 → 描画を順に行う。
 // =============================
 
 export template <class Setting, class SceneImpl>
@@ -29,8 +73,8 @@ class Game final {
     explicit Game(SettingFactory make_setting, int canvas_width, int canvas_height)
         : window_(nullptr, SDL_DestroyWindow),
           renderer_(nullptr, SDL_DestroyRenderer),
-          input_(nullptr),
-          setting_(nullptr) {
+          setting_(nullptr),
+          startup_counter_(SDL_GetPerformanceCounter()) {
         // SDLの初期化
         if (SDL_Init(SDL_INIT_VIDEO) < 0) {
             std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
@@ -89,9 +133,18 @@ class Game final {
         scene_ = std::move(initial_scene.value());
 
         initialized_ = true;
+        if constexpr (kSimulationThreadSupported) {
+            if (wants_simulation_thread()) start_simulation_thread();
+        }
     }
 
     ~Game() {
+        // シミュレーションスレッドを止める(写しが抱える Setting もここで手放す)
+        running_ = false;
+        if (sim_ && sim_->thread.joinable()) sim_->thread.join();
+        sim_.reset();
+        // Setting が renderer に紐づくリソース(テクスチャキャッシュ等)を持ちうるので先に手放す
+        setting_.reset();
         renderer_.reset();
         window_.reset();
         SDL_Quit();
@@ -100,14 +153,134 @@ class Game final {
     [[nodiscard]] bool isRunning() const { return running_; }
     [[nodiscard]] bool isInitialized() const { return initialized_; }
 
+    // 1 回の描画あたりに実行する固定ステップの上限(これを超えた遅れは捨てる)
+    static constexpr int kMaxCatchUpSteps = 5;
+
+    [[nodiscard]] const InputLatencyStats& latency() const noexcept { return latency_; }
+
+    // シミュレーションを別スレッドで進めているか
+    [[nodiscard]] bool simulation_threaded() const noexcept { return sim_ != nullptr; }
+
+    // 起動から最初のフレームを表示し終えるまで(ms)。まだ表示していなければ nullopt
+    //   ネイティブは Game の生成(SDL 初期化の前)から、Emscripten はページの読み込み開始から
+    [[nodiscard]] std::optional<double> time_to_first_frame_ms() const noexcept {
+        return time_to_first_frame_ms_;
+    }
+
     void tick(double delta_time_seconds) {
+        if (sim_) {
+            this->tick_threaded(delta_time_seconds);
+            return;
+        }
         this->processInput();
+        const input::Input& input = inputs_[current_input_];
+
+        // --- シミュレーション ---
+        //     Setting が固定刻みを指定していれば、実時間を貯めて 0..kMaxCatchUpSteps 回進める。
+        //     指定がなければ従来どおり描画 1 回につき実時間 dt で 1 回
+        double step = 0.0;
+        if constexpr (requires(const Setting& s) {
+                          { s.fixed_step_seconds() } -> std::convertible_to<double>;
+                      }) {
+            step = setting_->fixed_step_seconds();
+        }
+        int steps = 0;
+        if (step > 0.0) {
+            accumulator_ += delta_time_seconds;
+            while (accumulator_ >= step && steps < kMaxCatchUpSteps) {
+                this->simulate(step);
+                accumulator_ -= step;
+                ++steps;
+            }
+            if (accumulator_ >= step) {
+                // 追いつけない分は捨てる(ステップが描画を食い潰す悪循環を防ぐ)
+                latency_.dropped_steps += static_cast<std::uint64_t>(accumulator_ / step);
+                accumulator_ = 0.0;
+            }
+        } else {
+            this->simulate(delta_time_seconds);
+        }
 
-        // --- このフレーム用の Env を 1 度だけ構築し、update / render で共用する ---
-        scene_fw::Env<Setting> env{*input_, *setting_, delta_time_seconds};
-
-        this->update(env);
+        // --- 描画 ---
+        //     update / before_draw で Setting が差し替わりうるので、Env は描画直前に作り直す
+        this->before_draw(input, step > 0.0 ? step : delta_time_seconds);
+        scene_fw::Env<Setting> env{input, *setting_, step > 0.0 ? step : delta_time_seconds};
         this->render(env);
+        if (latency_pending_) {
+            latency_.input_to_present.record(ticks_to_ns(SDL_GetPerformanceCounter() -
+                                                         input_event_counter_));
+            latency_pending_ = false;
+        }
+        this->after_present(delta_time_seconds);
+    }
+
+   private:
+    using Snapshot = typename SceneSnapshotTypes<Setting, SceneImpl>::Snapshot;
+    using RenderState = typename SceneSnapshotTypes<Setting, SceneImpl>::RenderState;
+
+#ifdef __EMSCRIPTEN__
+    static constexpr bool kSimulationThreadSupported = false;  // pthread なしのビルド
+#else
+    static constexpr bool kSimulationThreadSupported =
+        scene_fw::SnapshotSceneAPI<SceneImpl, Setting>;
+#endif
+
+    /**
+     * @brief シミュレーション側が公開する 1 枚
+     * @param snapshot シーンの見た目
+     * @param setting そのときの Setting(フォントの差し替えなども描画側へこれで届く)
+     * @param dt 固定刻み
+     * @param input_event_counter まだ画面に出ていない入力のうち最も古いものの時刻(0 = なし)
+     * @param input_to_sim_ns ↑ の入力がシミュレーションに消費されるまでの時間
+     * @param dropped_steps 追いつき上限を超えて捨てた固定ステップ数の累計
+     */
+    struct RenderFrame {
+        Snapshot snapshot{};
+        std::shared_ptr<const Setting> setting;
+        double dt{0.0};
+        std::uint64_t input_event_counter{0};
+        std::uint64_t input_to_sim_ns{0};
+        std::uint64_t dropped_steps{0};
+    };
+
+    // シミュレーションスレッドと、メインスレッドとの受け渡し
+    struct SimulationThread {
+        TripleBuffer<RenderFrame> frames;
+        RenderState render_state{};  // メインスレッドのみ
+
+        // メインスレッド → シミュレーション: 最新の入力(エッジは 1 回だけ渡す)
+        std::mutex input_mutex;
+        input::Input input;
+        bool input_consumed{true};
+        std::uint64_t input_event_counter{0};
+        bool input_event_pending{false};
+
+        // メインスレッド → シミュレーション: before_draw が予約した Setting の差し替え
+        //   (input_mutex で守る。シミュレーション側が次のステップで適用する)
+        std::vector<typename scene_fw::Env<Setting>::SettingPatch> setting_patches;
+
+        // メインスレッド → シミュレーション: 表示し終えた入力の時刻
+        std::atomic<std::uint64_t> presented_event{0};
+
+        // シミュレーションスレッドのみ
+        std::uint64_t unshown_event{0};
+        std::uint64_t unshown_to_sim_ns{0};
+        std::uint64_t dropped_steps{0};
+
+        std::thread thread;
+    };
+
+    // 描画 1 回ぶんの後始末(初回表示の時刻・FPS とレイテンシのログ)
+    void after_present(double delta_time_seconds) {
+        if (!time_to_first_frame_ms_) {
+#ifdef __EMSCRIPTEN__
+            time_to_first_frame_ms_ = emscripten_get_now();  // performance.now()
+#else
+            time_to_first_frame_ms_ =
+                ns_to_ms(ticks_to_ns(SDL_GetPerformanceCounter() - startup_counter_));
+#endif
+            SDL_Log("Time to first frame: %.1f ms", *time_to_first_frame_ms_);
+        }
 
         // --- FPS の集計と出力 ---
         fps_elapsed_seconds_ += delta_time_seconds;
@@ -120,6 +293,15 @@ class Game final {
 
             // SDL のログ機構(emscripten でもブラウザコンソールに出ます)
             SDL_Log("FPS: %.2f  (%.2f ms/frame)", fps, ms_per_frame);
+            if (latency_.input_to_present.count() > 0) {
+                SDL_Log("input->sim p50 %.2f ms p99 %.2f ms | input->present p50 %.2f ms "
+                        "p99 %.2f ms | dropped steps %llu",
+                        ns_to_ms(latency_.input_to_sim.percentile(0.50)),
+                        ns_to_ms(latency_.input_to_sim.percentile(0.99)),
+                        ns_to_ms(latency_.input_to_present.percentile(0.50)),
+                        ns_to_ms(latency_.input_to_present.percentile(0.99)),
+                        static_cast<unsigned long long>(latency_.dropped_steps));
+            }
 
             // 次の区間のためにリセット
             fps_elapsed_seconds_ = 0.0;
@@ -127,24 +309,63 @@ class Game final {
         }
     }
 
-   private:
     std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)> window_;
     std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> renderer_;
 
     // ユーザー定義 Scene 型
     typename SceneImpl::Scene scene_;
 
-    std::shared_ptr<const input::Input> input_;
+    // 入力スナップショットのダブルバッファ(前フレーム/今フレーム)。毎フレームの確保はしない
+    std::array<input::Input, 2> inputs_{};
+    std::size_t current_input_ = 0;
+    bool input_consumed_ = true;  // 今の入力スナップショットのエッジをシミュレーションが使ったか
+
+    // 固定刻みループ・入力レイテンシ計測
+    double accumulator_ = 0.0;
+    std::uint64_t input_event_counter_ = 0;  // 未消費のキーイベントのうち最も古いものの時刻
+    bool input_event_pending_ = false;       // ↑ が有効か
+    bool latency_pending_ = false;           // 消費済み・未描画の入力があるか
+    InputLatencyStats latency_;
     std::shared_ptr<const Setting> setting_;  // ここが型パラメータ化
-    bool running_ = true;
+    std::uint64_t startup_counter_;           // Game 生成時の高分解能カウンタ
+    std::optional<double> time_to_first_frame_ms_;
+    std::atomic<bool> running_{true};  // シミュレーションスレッドも見る
     bool initialized_ = false;
     double fps_elapsed_seconds_ = 0.0;
     uint32_t fps_frame_count_ = 0;
 
+    // シミュレーションスレッド(使わないときは null)
+    std::unique_ptr<SimulationThread> sim_;
+    std::uint64_t last_presented_event_ = 0;  // 直近に表示まで計測した入力の時刻
+
     // --- 追加: Setting 更新パッチの一時保管場所 ---
     using SettingPatch = typename scene_fw::Env<Setting>::SettingPatch;
     std::vector<SettingPatch> pending_setting_patches_;
 
+    static std::uint64_t ticks_to_ns(std::uint64_t ticks) noexcept {
+        static const double ns_per_tick = 1e9 / static_cast<double>(SDL_GetPerformanceFrequency());
+        return static_cast<std::uint64_t>(static_cast<double>(ticks) * ns_per_tick);
+    }
+    static double ns_to_ms(std::uint64_t ns) noexcept { return static_cast<double>(ns) / 1e6; }
+
+    // シミュレーションを dt 秒ぶん 1 回進める
+    //   押下/解放エッジは最初の 1 回だけが受け取り、同じ描画フレーム内の 2 回目以降には見せない
+    void simulate(double dt) {
+        input::Input& input = inputs_[current_input_];
+        if (input_event_pending_) {
+            latency_.input_to_sim.record(
+                ticks_to_ns(SDL_GetPerformanceCounter() - input_event_counter_));
+            input_event_pending_ = false;
+            latency_pending_ = true;
+        }
+
+        scene_fw::Env<Setting> env{input, *setting_, dt};
+        this->update(env);
+
+        input.key_states.clear_edges();
+        input_consumed_ = true;
+    }
+
     // Env を受け取る形に変更
     void update(scene_fw::Env<Setting>& env) {
         // --- Env に更新予約のキュー関数をセット ---
@@ -156,14 +377,29 @@ class Game final {
         scene_ = SceneImpl::step(std::move(scene_), env);
 
         // --- Game 側で適用タイミングを制御：update 終了時に一括適用 ---
-        if (!pending_setting_patches_.empty()) {
-            // 複数予約されている場合は順次適用(関数合成相当)
-            for (auto& patch : pending_setting_patches_) {
-                // null 安全: patch は必ず新しい共有ポインタを返す想定
-                setting_ = patch(setting_);
-            }
-            pending_setting_patches_.clear();
+        this->apply_setting_patches();
+    }
+
+    void apply_setting_patches() {
+        if (pending_setting_patches_.empty()) return;
+        // 複数予約されている場合は順次適用(関数合成相当)
+        for (auto& patch : pending_setting_patches_) {
+            // null 安全: patch は必ず新しい共有ポインタを返す想定
+            setting_ = patch(setting_);
+        }
+        pending_setting_patches_.clear();
+    }
+
+    // 1 スレッドで回すときの描画前の下準備(予約された差し替えはこの描画から効く)
+    void before_draw(const input::Input& input, double dt) {
+        if constexpr (scene_fw::MainThreadSceneAPI<SceneImpl, Setting>) {
+            scene_fw::Env<Setting> env{input, *setting_, dt};
+            env.queue_setting_update = [this](SettingPatch patch) {
+                pending_setting_patches_.push_back(std::move(patch));
+            };
+            SceneImpl::before_draw(env);
         }
+        this->apply_setting_patches();  // env が参照する Setting を手放すのは呼び終えてから
     }
 
     // Env を引数に追加
@@ -171,38 +407,184 @@ class Game final {
         SceneImpl::draw(scene_, renderer_.get(), env);
     }
 
+    // ------------------------------
+    // シミュレーションスレッド
+    // ------------------------------
+
+    // Setting が固定刻みを指定していて、無効にされていなければ使う
+    bool wants_simulation_thread() const {
+        double step = 0.0;
+        if constexpr (requires(const Setting& s) {
+                          { s.fixed_step_seconds() } -> std::convertible_to<double>;
+                      }) {
+            step = setting_->fixed_step_seconds();
+        }
+        if (step <= 0.0) return false;
+        if constexpr (requires(const Setting& s) {
+                          { s.simulation_thread() } -> std::convertible_to<bool>;
+                      }) {
+            return setting_->simulation_thread();
+        }
+        return true;
+    }
+
+    void start_simulation_thread() {
+        sim_ = std::make_unique<SimulationThread>();
+        // 最初の 1 枚は起動前に出しておく(描画側は空の画面を待たない)
+        this->publish_frame(setting_->fixed_step_seconds());
+        sim_->thread = std::thread([this] { this->simulation_loop(); });
+        SDL_Log("Simulation runs on its own thread");
+    }
+
+    // シミュレーションスレッド本体: 実時間を貯めて固定刻みで進め、進めたら写しを公開する
+    //   scene_ / setting_ / 設定パッチはこの間このスレッドだけが触る
+    void simulation_loop() {
+        std::uint64_t last = SDL_GetPerformanceCounter();
+        double accumulator = 0.0;
+        input::Input input{};
+        while (running_.load(std::memory_order_relaxed)) {
+            const std::uint64_t now = SDL_GetPerformanceCounter();
+            accumulator += static_cast<double>(ticks_to_ns(now - last)) / 1e9;
+            last = now;
+
+            const double step = setting_->fixed_step_seconds();
+            int steps = 0;
+            while (accumulator >= step && steps < kMaxCatchUpSteps) {
+                this->take_input(input);
+                scene_fw::Env<Setting> env{input, *setting_, step};
+                this->update(env);
+                accumulator -= step;
+                ++steps;
+            }
+            if (accumulator >= step) {
+                sim_->dropped_steps += static_cast<std::uint64_t>(accumulator / step);
+                accumulator = 0.0;
+            }
+            if (steps > 0) this->publish_frame(step);
+
+            // 次の刻みまで眠る(描画は別スレッドなので待っても表示は止まらない)
+            const double wait = setting_->fixed_step_seconds() - accumulator;
+            if (wait > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+        }
+    }
+
+    // メインスレッドが渡した最新の入力を受け取る(エッジは最初に受け取った 1 ステップだけが見る)
+    void take_input(input::Input& out) {
+        SimulationThread& s = *sim_;
+        std::uint64_t event_counter = 0;
+        bool event = false;
+        {
+            std::lock_guard lk(s.input_mutex);
+            out = s.input;
+            if (s.input_consumed) out.key_states.clear_edges();
+            s.input_consumed = true;
+            event = std::exchange(s.input_event_pending, false);
+            event_counter = s.input_event_counter;
+            // 描画側が予約した差し替えは、このステップの予約と一緒に update の終わりで適用する
+            for (auto& patch : s.setting_patches) {
+                pending_setting_patches_.push_back(std::move(patch));
+            }
+            s.setting_patches.clear();
+        }
+        // 表示し終えた入力は忘れ、まだ画面に出ていない最も古い入力を次の写しに付ける
+        if (s.unshown_event != 0 &&
+            s.presented_event.load(std::memory_order_acquire) == s.unshown_event) {
+            s.unshown_event = 0;
+        }
+        if (event && s.unshown_event == 0) {
+            s.unshown_event = event_counter;
+            s.unshown_to_sim_ns = ticks_to_ns(SDL_GetPerformanceCounter() - event_counter);
+        }
+    }
+
+    void publish_frame(double step) {
+        SimulationThread& s = *sim_;
+        RenderFrame& f = s.frames.back();
+        SceneImpl::publish(scene_, f.snapshot);
+        f.setting = setting_;
+        f.dt = step;
+        f.input_event_counter = s.unshown_event;
+        f.input_to_sim_ns = s.unshown_to_sim_ns;
+        f.dropped_steps = s.dropped_steps;
+        s.frames.publish();
+    }
+
+    // メインスレッド側の 1 回: 入力を渡し、最新の写しを描いて表示する
+    void tick_threaded(double delta_time_seconds) {
+        SimulationThread& s = *sim_;
+        this->processInput();
+        {
+            std::lock_guard lk(s.input_mutex);
+            input::Input& next = inputs_[current_input_];
+            if (!s.input_consumed) next.key_states.merge_edges(s.input.key_states);
+            s.input = next;
+            s.input_consumed = false;
+            if (input_event_pending_ && !s.input_event_pending) {
+                s.input_event_counter = input_event_counter_;
+                s.input_event_pending = true;
+            }
+            input_event_pending_ = false;
+        }
+        input_consumed_ = true;  // 取りこぼしの合流は受け渡し側で済ませた
+
+        s.frames.acquire();
+        const RenderFrame& f = s.frames.front();
+        if (!f.setting) return;
+        if constexpr (scene_fw::MainThreadSceneAPI<SceneImpl, Setting>) {
+            // 描画の直前にメインスレッドで下準備(差し替えは次のステップ以降の写しで届く)
+            scene_fw::Env<Setting> env{inputs_[current_input_], *f.setting, f.dt};
+            env.queue_setting_update = [&s](SettingPatch patch) {
+                std::lock_guard lk(s.input_mutex);
+                s.setting_patches.push_back(std::move(patch));
+            };
+            SceneImpl::before_draw(env);
+        }
+        if constexpr (scene_fw::SnapshotSceneAPI<SceneImpl, Setting>) {
+            scene_fw::Env<Setting> env{inputs_[current_input_], *f.setting, f.dt};
+            SceneImpl::draw_snapshot(f.snapshot, s.render_state, renderer_.get(), env);
+        }
+
+        if (f.input_event_counter != 0 && f.input_event_counter != last_presented_event_) {
+            latency_.input_to_sim.record(f.input_to_sim_ns);
+            latency_.input_to_present.record(
+                ticks_to_ns(SDL_GetPerformanceCounter() - f.input_event_counter));
+            last_presented_event_ = f.input_event_counter;
+            s.presented_event.store(f.input_event_counter, std::memory_order_release);
+        }
+        latency_.dropped_steps = f.dropped_steps;
+        this->after_present(delta_time_seconds);
+    }
+
     void processInput() {
         // ポーリングはGameのみが担当し、他のモジュールは入力状態を受け取るだけにする
-        const auto input = poll_input(input_);
+        const std::size_t next = current_input_ ^ 1;
+        poll_input(inputs_[current_input_], inputs_[next]);
+        if (!input_consumed_) {
+            // 前の描画フレームではシミュレーションが進まなかった: そのエッジを取りこぼさない
+            inputs_[next].key_states.merge_edges(inputs_[current_input_].key_states);
+        }
+        input_consumed_ = false;
+        current_input_ = next;
         //  ゲーム全体の入力処理はここだけ
         //  SDL_Keycode をそのまま利用し、利用側で任意の enum にマッピング可能とする
-        if (input->pressed(SDLK_q)) {
+        if (inputs_[current_input_].pressed(SDLK_q)) {
             running_ = false;
         }
-        input_ = input;
         // scene 側への明示的な伝播は不要(Env に束ねて update に渡す)
     }
 
     /**
      * 抽象入力を取得する関数
      * @param previous_input 以前の入力状態(エッジ検出のために使用)
-     * @return 新しい入力状態
+     * @param input 今フレームの入力状態の書き込み先(ダブルバッファの裏側)
      *
      * SDL のキーコード(SDL_Keycode)をそのまま保持し、
      * 抽象キー(enum等)へのマッピングは利用側で行う方針とします。
+     * キーコードはイベント取り込み時に 1 度だけスロットへ変換し、
+     * エッジは前フレームとの XOR で求める(確保なし)。
      */
-    std::shared_ptr<const input::Input> poll_input(
-        std::shared_ptr<const input::Input> previous_input) {
-        // 初回フレームなど、previous_input が null の場合に備える
-        if (!previous_input) {
-            previous_input = std::make_shared<const input::Input>();
-        }
-
-        auto input = std::make_shared<input::Input>(*previous_input);  // コピーして操作対象にする
-        for (auto& [_, state] : input->key_states) {
-            state.is_pressed = false;
-            state.is_released = false;
-        }
+    void poll_input(const input::Input& previous_input, input::Input& input) {
+        input.key_states.begin_frame(previous_input.key_states);
 
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
@@ -214,23 +596,25 @@ class Game final {
 
             if (event.type != SDL_KEYDOWN && event.type != SDL_KEYUP) continue;
 
-            const SDL_Keycode code = event.key.keysym.sym;
-            input::InputState& state = input->key_states[code];
+            if (!input_event_pending_ && event.key.repeat == 0) {
+                // イベントの発生時刻(ms 精度)をキューでの待ち時間として高分解能カウンタに換算する
+                const std::uint64_t now = SDL_GetPerformanceCounter();
+                const Uint32 waited_ms = SDL_GetTicks() - event.key.timestamp;
+                const std::uint64_t waited =
+                    static_cast<std::uint64_t>(waited_ms) * SDL_GetPerformanceFrequency() / 1000;
+                input_event_counter_ = now > waited ? now - waited : now;
+                input_event_pending_ = true;
+            }
 
+            const SDL_Keycode code = event.key.keysym.sym;
             if (event.type == SDL_KEYDOWN) {
-                if (!state.is_held) {
-                    state.is_pressed = true;
-                }
-                state.is_held = true;
+                input.key_states.key_down(code);
             } else {  // SDL_KEYUP
-                if (state.is_held) {
-                    state.is_held = false;
-                    state.is_released = true;
-                }
+                input.key_states.key_up(code);
             }
         }
 
-        return input;
+        input.key_states.end_frame(previous_input.key_states);
     }
 };
 
@@ -238,15 +622,19 @@ class Game final {
 // ランナー: main から呼ぶだけにする
 // =============================
 struct GameRunner {
+    // 高分解能カウンタの差を秒に(SDL_GetTicks の 1ms 刻みでは固定刻みの積算がぶれる)
+    static double seconds_between(Uint64 from, Uint64 to) noexcept {
+        return static_cast<double>(to - from) / static_cast<double>(SDL_GetPerformanceFrequency());
+    }
+
 #ifdef __EMSCRIPTEN__
     template <class GameT>
     static void main_loop(void* arg) {
         GameT* game = static_cast<GameT*>(arg);
-        static Uint32 last_time = SDL_GetTicks();
-        Uint32 current_time = SDL_GetTicks();
-        double delta_time = (current_time - last_time) / 1000.0;
+        static Uint64 last_time = SDL_GetPerformanceCounter();
+        const Uint64 current_time = SDL_GetPerformanceCounter();
+        game->tick(seconds_between(last_time, current_time));
         last_time = current_time;
-        game->tick(delta_time);
     }
 #endif
 
@@ -272,12 +660,11 @@ struct GameRunner {
             return 1;
         }
 
-        Uint32 last_time = SDL_GetTicks();
+        Uint64 last_time = SDL_GetPerformanceCounter();
         while (game.isRunning()) {
-            Uint32 current_time = SDL_GetTicks();
-            double delta_time = (current_time - last_time) / 1000.0;
+            const Uint64 current_time = SDL_GetPerformanceCounter();
+            game.tick(seconds_between(last_time, current_time));
             last_time = current_time;
-            game.tick(delta_time);
         }
 
         return 0;
@@ -1,5 +1,7 @@
 module;
 #include <SDL2/SDL.h>
+#include <bitset>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -51,13 +53,137 @@ export struct InputState {
     bool is_held = false;
 };
 
+// =============================
+// キースロット
+//   SDL_Keycode を固定長ビット列の添字へ O(1) で写す。
+//   - 0..127          : ASCII 由来のキーコード(SDLK_a, SDLK_SPACE など)はそのまま
+//   - 128..128+512-1  : スキャンコード由来のキーコード(矢印・F キーなど)はスキャンコード + 128
+//   どちらにも当たらないキーコード(配列依存の非 ASCII 文字など)は kNoSlot とし、無視する。
+// =============================
+
+export inline constexpr std::size_t kKeySlots = 128 + SDL_NUM_SCANCODES;
+export inline constexpr std::size_t kNoSlot = kKeySlots;
+
+export constexpr std::size_t key_slot(SDL_Keycode k) noexcept {
+    if (k >= 0 && k < 128) return static_cast<std::size_t>(k);
+    if ((k & SDLK_SCANCODE_MASK) != 0) {
+        const auto sc = static_cast<std::size_t>(k & ~SDLK_SCANCODE_MASK);
+        if (sc < SDL_NUM_SCANCODES) return 128 + sc;
+    }
+    return kNoSlot;
+}
+
+export constexpr SDL_Keycode slot_key(std::size_t slot) noexcept {
+    if (slot < 128) return static_cast<SDL_Keycode>(slot);
+    return static_cast<SDL_Keycode>(slot - 128) | SDLK_SCANCODE_MASK;
+}
+
+export using KeyBits = std::bitset<kKeySlots>;
+
+/**
+ * @brief 全キーの状態をビット列で持つ固定長スナップショット(ヒープ確保なし)
+ *
+ * 1 フレーム分の取り込み手順:
+ *   begin_frame(prev) → key_down / key_up をイベント順に → end_frame(prev)
+ * 押下/解放エッジは前フレームとの held の XOR から求める。
+ * 同一フレーム内で状態が 2 回以上反転したキー(押して離した等)は XOR では消えるので、
+ * 取り込み中に印を付けておき、両エッジを立てる(旧実装のイベント単位の判定と同じ結果)。
+ */
+export class KeyStates {
+   public:
+    KeyStates() = default;
+
+    // 旧表現(SDL_Keycode → InputState のマップ)からの変換(テスト・互換用)
+    KeyStates(const std::unordered_map<SDL_Keycode, InputState>& states) {
+        for (const auto& [key, state] : states) set(key, state);
+    }
+
+    // --- 取り込み ---
+    void begin_frame(const KeyStates& prev) noexcept {
+        held_ = prev.held_;
+        pressed_.reset();
+        released_.reset();
+        touched_.reset();
+        bounced_.reset();
+    }
+    void key_down(SDL_Keycode k) noexcept { toggle_to(key_slot(k), true); }
+    void key_up(SDL_Keycode k) noexcept { toggle_to(key_slot(k), false); }
+    void end_frame(const KeyStates& prev) noexcept {
+        const KeyBits changed = held_ ^ prev.held_;
+        pressed_ = (changed & held_) | bounced_;
+        released_ = (changed & prev.held_) | bounced_;
+    }
+
+    // --- 参照(O(1)) ---
+    [[nodiscard]] bool pressed_at(std::size_t slot) const noexcept {
+        return slot < kKeySlots && pressed_[slot];
+    }
+    [[nodiscard]] bool released_at(std::size_t slot) const noexcept {
+        return slot < kKeySlots && released_[slot];
+    }
+    [[nodiscard]] bool held_at(std::size_t slot) const noexcept {
+        return slot < kKeySlots && held_[slot];
+    }
+    [[nodiscard]] const KeyBits& pressed_bits() const noexcept { return pressed_; }
+    [[nodiscard]] const KeyBits& released_bits() const noexcept { return released_; }
+    [[nodiscard]] const KeyBits& held_bits() const noexcept { return held_; }
+
+    [[nodiscard]] InputState get(SDL_Keycode k) const noexcept {
+        const std::size_t s = key_slot(k);
+        return InputState{pressed_at(s), released_at(s), held_at(s)};
+    }
+    // 状態を直接書き込む(ボットやテストからの注入用)
+    void set(SDL_Keycode k, InputState state) noexcept {
+        const std::size_t s = key_slot(k);
+        if (s == kNoSlot) return;
+        pressed_[s] = state.is_pressed;
+        released_[s] = state.is_released;
+        held_[s] = state.is_held;
+    }
+    // 押下/解放エッジだけを落とす(held は残す)
+    void clear_edges() noexcept {
+        pressed_.reset();
+        released_.reset();
+    }
+    // まだ誰にも消費されていない(シミュレーションが 1 度も進まなかった)フレームのエッジを引き継ぐ
+    void merge_edges(const KeyStates& unconsumed) noexcept {
+        pressed_ |= unconsumed.pressed_;
+        released_ |= unconsumed.released_;
+    }
+
+    // いずれかのビットが立っているキーを、スロット順に fn(SDL_Keycode, InputState) で列挙する
+    template <class Fn>
+    void for_each(Fn&& fn) const {
+        const KeyBits any = pressed_ | released_ | held_;
+        if (any.none()) return;
+        for (std::size_t s = 0; s < kKeySlots; ++s) {
+            if (any[s]) fn(slot_key(s), InputState{pressed_[s], released_[s], held_[s]});
+        }
+    }
+
+   private:
+    KeyBits pressed_;
+    KeyBits released_;
+    KeyBits held_;
+    // 取り込み中の作業用: このフレームで一度でも反転したキー / 2 回以上反転したキー
+    KeyBits touched_;
+    KeyBits bounced_;
+
+    void toggle_to(std::size_t s, bool down) noexcept {
+        if (s == kNoSlot || held_[s] == down) return;  // キーリピート等の重複イベントは無視
+        held_[s] = down;
+        if (touched_[s]) bounced_.set(s);
+        touched_.set(s);
+    }
+};
+
 }  // namespace input
 
 namespace input {
 
 /**
  * 入力状態を表現する構造体
- * - key_states: 各キー(SDL_Keycode)の状態を保持するマップ
+ * - key_states: 各キー(SDL_Keycode)の状態を保持する固定長ビット列(KeyStates)
  * - clear_frame_state: フレーム状態をクリアした新インスタンスを返す
  * - to_string: 入力状態を文字列に変換する
  *
@@ -71,49 +197,27 @@ namespace input {
  *    必要に応じて呼び出し側で SDL_Keycode の配列・enum を定義してご利用ください。
  */
 export struct Input {
-    // SDL_Keycode をそのままキーとして扱う
-    std::unordered_map<SDL_Keycode, InputState> key_states;
+    // SDL_Keycode をスロット化したビット列として扱う
+    KeyStates key_states;
 
     // フレーム状態をクリアした新インスタンスを返す
     [[nodiscard]] std::shared_ptr<const Input> clear_frame_state() const {
         auto next = std::make_shared<Input>(*this);
-        for (auto& [_, state] : next->key_states) {
-            state.is_pressed = false;
-            state.is_released = false;
-        }
+        next->key_states.clear_edges();
         return next;
     }
 
     // --- 低レベル: 単一キー(SDL_Keycode)の状態取得 ---
-    [[nodiscard]] bool pressed(SDL_Keycode k) const {
-        if (auto it = key_states.find(k); it != key_states.end()) return it->second.is_pressed;
-        return false;
-    }
+    [[nodiscard]] bool pressed(SDL_Keycode k) const { return key_states.pressed_at(key_slot(k)); }
     [[nodiscard]] bool released(SDL_Keycode k) const {
-        if (auto it = key_states.find(k); it != key_states.end()) return it->second.is_released;
-        return false;
-    }
-    [[nodiscard]] bool held(SDL_Keycode k) const {
-        if (auto it = key_states.find(k); it != key_states.end()) return it->second.is_held;
-        return false;
+        return key_states.released_at(key_slot(k));
     }
+    [[nodiscard]] bool held(SDL_Keycode k) const { return key_states.held_at(key_slot(k)); }
 
     // --- 中レベル: 全体/集合の簡易判定 ---
-    [[nodiscard]] bool any_pressed() const {
-        for (const auto& [_, s] : key_states)
-            if (s.is_pressed) return true;
-        return false;
-    }
-    [[nodiscard]] bool any_released() const {
-        for (const auto& [_, s] : key_states)
-            if (s.is_released) return true;
-        return false;
-    }
-    [[nodiscard]] bool any_held() const {
-        for (const auto& [_, s] : key_states)
-            if (s.is_held) return true;
-        return false;
-    }
+    [[nodiscard]] bool any_pressed() const { return key_states.pressed_bits().any(); }
+    [[nodiscard]] bool any_released() const { return key_states.released_bits().any(); }
+    [[nodiscard]] bool any_held() const { return key_states.held_bits().any(); }
 
     // --- 高レベル: 優先順で最初に該当したキーを返す ---
     // 呼び出し側が優先順コンテナを用意して渡す形にします。
@@ -143,12 +247,7 @@ export struct Input {
      */
     [[nodiscard]]
     std::optional<InputState> get_input_key() const {
-        InputState acc{};
-        for (const auto& [_, s] : key_states) {
-            acc.is_pressed = acc.is_pressed || s.is_pressed;
-            acc.is_released = acc.is_released || s.is_released;
-            acc.is_held = acc.is_held || s.is_held;
-        }
+        const InputState acc{any_pressed(), any_released(), any_held()};
         if (acc.is_pressed || acc.is_released || acc.is_held) return acc;
         return std::nullopt;
     }
@@ -156,12 +255,12 @@ export struct Input {
     [[nodiscard]]
     std::string to_string() const {
         std::string result;
-        for (const auto& [key, state] : key_states) {
+        key_states.for_each([&result](SDL_Keycode key, InputState state) {
             result += "Key: " + std::to_string(static_cast<int>(key)) +
                       ", Pressed: " + std::to_string(state.is_pressed) +
                       ", Released: " + std::to_string(state.is_released) +
                       ", Held: " + std::to_string(state.is_held) + "\n";
-        }
+        });
         return result;
     }
 };
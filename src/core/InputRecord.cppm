@@ -0,0 +1,317 @@
+module;
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <tl/expected.hpp>
+#include <utility>
+#include <vector>
+export module InputRecord;
+
+import Input;
+
+// =============================
+// 入力記録 / 再生
+//   1 フレーム分の input::Input を「押した／離した」エッジだけの列として記録する。
+//   held は直前フレームからエッジで再構成できるので保存しない
+//   (記録開始時点で既に押されていたキーだけは最初のフレームに hold として残す)。
+//
+//   形式(リトルエンディアン):
+//     "TRIR" | version:u8 | seed:u32 | frame_rate:u16 | columns:u16 | rows:u16
+//     | drop_rate:f64 | lock_delay_sec:f64 | spawn_col:i16 | spawn_row:i16
+//     | max_drops_per_frame:u16 | max_rotation_locks:u16
+//     以降フレームごとに: edge_count:varint, edge:varint * edge_count
+//       edge = (keycode << 2) | kind   (kind: 0 = 押下, 1 = 解放, 2 = 押されたまま開始)
+//   入力のないフレームは 1 バイト。
+// =============================
+
+export namespace input_record {
+
+inline constexpr char kMagic[4] = {'T', 'R', 'I', 'R'};
+inline constexpr std::uint8_t kVersion = 2;  // 2: ルール設定をヘッダに含める
+
+/**
+ * @brief 記録の前提条件(再生結果を左右する設定はすべてここに入れる)
+ * @param seed 7-Bag の乱数シード
+ * @param frame_rate 1 フレーム = 1 / frame_rate 秒の固定刻み
+ * @param columns, rows 盤面の大きさ
+ * @param drop_rate 自動落下速度(セル／秒)
+ * @param lock_delay_sec ロック遅延(秒)
+ * @param spawn_col, spawn_row スポーン位置
+ * @param max_drops_per_frame 1 フレームあたりの最大ドロップセル数
+ * @param max_rotation_locks 1 回の回転操作あたりの最大ロック回数
+ */
+struct RecordingHeader {
+    std::uint32_t seed{0};
+    std::uint16_t frame_rate{60};
+    std::uint16_t columns{10};
+    std::uint16_t rows{20};
+    double drop_rate{0.0};
+    double lock_delay_sec{0.3};
+    std::int16_t spawn_col{3};
+    std::int16_t spawn_row{0};
+    std::uint16_t max_drops_per_frame{6};
+    std::uint16_t max_rotation_locks{15};
+
+    bool operator==(const RecordingHeader&) const = default;
+};
+
+/**
+ * @brief 同じ記録先で何ゲームも記録するときのファイル名
+ *
+ * 最初のゲームは base そのまま、2 ゲーム目以降は拡張子の前に番号を入れる
+ * (例: run.trir, run.2.trir, run.3.trir)。再スタートで前のゲームの記録を上書きしない。
+ */
+inline std::string numbered_path(const std::string& base, std::uint32_t game) {
+    if (game <= 1) return base;
+    const auto slash = base.find_last_of("/\\");
+    const auto dot = base.find_last_of('.');
+    const bool has_ext = dot != std::string::npos && dot != 0 &&
+                         (slash == std::string::npos || dot > slash + 1);
+    const std::string n = "." + std::to_string(game);
+    return has_ext ? base.substr(0, dot) + n + base.substr(dot) : base + n;
+}
+
+namespace detail {
+
+inline void put_varint(std::vector<std::uint8_t>& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+inline bool get_varint(const std::vector<std::uint8_t>& in, std::size_t& pos, std::uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) return false;
+        const std::uint8_t b = in[pos++];
+        v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+template <class T>
+void put_le(std::vector<std::uint8_t>& out, T v) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<std::uint8_t>(static_cast<std::uint64_t>(v) >> (8 * i)));
+    }
+}
+
+template <class T>
+T get_le(const std::vector<std::uint8_t>& in, std::size_t pos) {
+    std::uint64_t v = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        v |= static_cast<std::uint64_t>(in[pos + i]) << (8 * i);
+    }
+    return static_cast<T>(v);
+}
+
+inline void put_f64(std::vector<std::uint8_t>& out, double v) {
+    put_le(out, std::bit_cast<std::uint64_t>(v));
+}
+
+inline double get_f64(const std::vector<std::uint8_t>& in, std::size_t pos) {
+    return std::bit_cast<double>(get_le<std::uint64_t>(in, pos));
+}
+
+inline constexpr std::size_t kHeaderSize = 4 + 1 + 4 + 2 + 2 + 2 + 8 + 8 + 2 + 2 + 2 + 2;
+
+inline constexpr std::uint64_t kPress = 0;
+inline constexpr std::uint64_t kRelease = 1;
+inline constexpr std::uint64_t kHold = 2;
+
+}  // namespace detail
+
+/**
+ * @brief フレームごとの入力エッジを記録する
+ *
+ * flush_path を指定した場合は破棄時にファイルへ書き出す(World の ctx に置いて使う想定)。
+ */
+class InputRecorder {
+   public:
+    explicit InputRecorder(RecordingHeader header, std::string flush_path = {})
+        : flush_path_(std::move(flush_path)) {
+        bytes_.reserve(4096);
+        bytes_.insert(bytes_.end(), std::begin(kMagic), std::end(kMagic));
+        bytes_.push_back(kVersion);
+        detail::put_le(bytes_, header.seed);
+        detail::put_le(bytes_, header.frame_rate);
+        detail::put_le(bytes_, header.columns);
+        detail::put_le(bytes_, header.rows);
+        detail::put_f64(bytes_, header.drop_rate);
+        detail::put_f64(bytes_, header.lock_delay_sec);
+        detail::put_le(bytes_, header.spawn_col);
+        detail::put_le(bytes_, header.spawn_row);
+        detail::put_le(bytes_, header.max_drops_per_frame);
+        detail::put_le(bytes_, header.max_rotation_locks);
+    }
+
+    InputRecorder(InputRecorder&& other) noexcept
+        : bytes_(std::move(other.bytes_)),
+          flush_path_(std::exchange(other.flush_path_, {})),
+          frames_(other.frames_) {}
+    InputRecorder& operator=(InputRecorder&& other) noexcept {
+        if (this != &other) {
+            flush();
+            bytes_ = std::move(other.bytes_);
+            flush_path_ = std::exchange(other.flush_path_, {});
+            frames_ = other.frames_;
+        }
+        return *this;
+    }
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+    ~InputRecorder() { flush(); }
+
+    // このフレームの押下／解放エッジを追記する
+    void record_frame(const input::Input& in) {
+        edges_.clear();
+        using namespace detail;
+        // for_each はスロット順 = キーコード昇順に列挙するので、並べ替えは不要
+        in.key_states.for_each([this](SDL_Keycode key, input::InputState s) {
+            const auto code = static_cast<std::uint64_t>(static_cast<std::uint32_t>(key)) << 2;
+            if (s.is_pressed && s.is_released) {
+                // 同一フレーム内で押して離した(held=false)か、離して押し直した(held=true)
+                if (s.is_held) {
+                    edges_.push_back(code | kRelease);
+                    edges_.push_back(code | kPress);
+                } else {
+                    edges_.push_back(code | kPress);
+                    edges_.push_back(code | kRelease);
+                }
+            } else if (s.is_pressed) {
+                edges_.push_back(code | kPress);
+            } else if (s.is_released) {
+                edges_.push_back(code | kRelease);
+            } else if (s.is_held && frames_ == 0) {
+                edges_.push_back(code | kHold);
+            }
+        });
+
+        detail::put_varint(bytes_, edges_.size());
+        for (auto e : edges_) detail::put_varint(bytes_, e);
+        ++frames_;
+    }
+
+    [[nodiscard]] const std::vector<std::uint8_t>& bytes() const noexcept { return bytes_; }
+    [[nodiscard]] std::size_t frames() const noexcept { return frames_; }
+
+    [[nodiscard]] bool save(const std::string& path) const {
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        if (!os) return false;
+        os.write(reinterpret_cast<const char*>(bytes_.data()),
+                 static_cast<std::streamsize>(bytes_.size()));
+        return static_cast<bool>(os);
+    }
+
+   private:
+    std::vector<std::uint8_t> bytes_;
+    std::vector<std::uint64_t> edges_;  // record_frame 用の作業領域
+    std::string flush_path_;
+    std::size_t frames_{0};
+
+    void flush() noexcept {
+        if (flush_path_.empty()) return;
+        if (!save(flush_path_)) {
+            SDL_Log("Failed to write input recording: %s", flush_path_.c_str());
+        }
+        flush_path_.clear();
+    }
+};
+
+/**
+ * @brief 記録を先頭から 1 フレームずつ input::Input へ復元する
+ */
+class InputReplayer {
+   public:
+    static tl::expected<InputReplayer, std::string> from_bytes(std::vector<std::uint8_t> bytes) {
+        if (bytes.size() < detail::kHeaderSize ||
+            !std::equal(std::begin(kMagic), std::end(kMagic), bytes.begin())) {
+            return tl::make_unexpected("not an input recording");
+        }
+        if (bytes[4] != kVersion) {
+            return tl::make_unexpected("unsupported recording version " + std::to_string(bytes[4]));
+        }
+        RecordingHeader h{};
+        h.seed = detail::get_le<std::uint32_t>(bytes, 5);
+        h.frame_rate = detail::get_le<std::uint16_t>(bytes, 9);
+        h.columns = detail::get_le<std::uint16_t>(bytes, 11);
+        h.rows = detail::get_le<std::uint16_t>(bytes, 13);
+        h.drop_rate = detail::get_f64(bytes, 15);
+        h.lock_delay_sec = detail::get_f64(bytes, 23);
+        h.spawn_col = detail::get_le<std::int16_t>(bytes, 31);
+        h.spawn_row = detail::get_le<std::int16_t>(bytes, 33);
+        h.max_drops_per_frame = detail::get_le<std::uint16_t>(bytes, 35);
+        h.max_rotation_locks = detail::get_le<std::uint16_t>(bytes, 37);
+        if (h.frame_rate == 0) return tl::make_unexpected("frame_rate must be positive");
+        if (h.columns == 0 || h.rows == 0) {
+            return tl::make_unexpected("board size must be positive");
+        }
+        return InputReplayer{h, std::move(bytes)};
+    }
+
+    static tl::expected<InputReplayer, std::string> load(const std::string& path) {
+        std::ifstream is(path, std::ios::binary);
+        if (!is) return tl::make_unexpected("cannot open " + path);
+        std::vector<std::uint8_t> bytes{std::istreambuf_iterator<char>(is),
+                                        std::istreambuf_iterator<char>()};
+        return from_bytes(std::move(bytes));
+    }
+
+    [[nodiscard]] const RecordingHeader& header() const noexcept { return header_; }
+    [[nodiscard]] bool at_end() const noexcept { return pos_ >= bytes_.size(); }
+
+    // 次フレームの入力を io に反映する(Game::poll_input と同じ遷移)。末尾・破損時は false
+    bool next_frame(input::Input& io) {
+        if (at_end()) return false;
+        // 前フレームの held を控えておき、Game::poll_input と同じく XOR でエッジを求める
+        input::KeyStates prev = io.key_states;
+        io.key_states.begin_frame(prev);
+        std::uint64_t count = 0;
+        if (!detail::get_varint(bytes_, pos_, count)) return fail();
+        for (std::uint64_t i = 0; i < count; ++i) {
+            std::uint64_t e = 0;
+            if (!detail::get_varint(bytes_, pos_, e)) return fail();
+            const auto key = static_cast<SDL_Keycode>(static_cast<std::uint32_t>(e >> 2));
+            switch (e & 3) {
+                case detail::kPress:
+                    io.key_states.key_down(key);
+                    break;
+                case detail::kRelease:
+                    io.key_states.key_up(key);
+                    break;
+                case detail::kHold:
+                    // 記録開始時点で押されていたキー: エッジは立てない
+                    prev.set(key, input::InputState{false, false, true});
+                    io.key_states.key_down(key);
+                    break;
+                default:
+                    return fail();
+            }
+        }
+        io.key_states.end_frame(prev);
+        return true;
+    }
+
+   private:
+    InputReplayer(RecordingHeader h, std::vector<std::uint8_t> bytes)
+        : header_(h), bytes_(std::move(bytes)), pos_(detail::kHeaderSize) {}
+
+    RecordingHeader header_;
+    std::vector<std::uint8_t> bytes_;
+    std::size_t pos_;
+
+    bool fail() noexcept {
+        pos_ = bytes_.size();
+        return false;
+    }
+};
+
+}  // namespace input_record
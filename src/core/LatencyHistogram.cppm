@@ -0,0 +1,76 @@
+module;
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+export module LatencyHistogram;
+
+// =============================
+// 対数バケットのレイテンシヒストグラム
+//   2 のべき乗ごとに 8 分割したバケット(相対誤差 1/8 以内)に数えるだけなので、
+//   記録は O(1)・確保なし。スレッドごとに持って最後に merge する想定。
+// =============================
+
+export class LatencyHistogram {
+   public:
+    static constexpr int kSubBits = 3;
+    static constexpr std::size_t kSub = std::size_t{1} << kSubBits;
+    static constexpr std::size_t kBuckets = 64 * kSub;
+
+    void record(std::uint64_t ns) noexcept {
+        ++buckets_[bucket_of(ns)];
+        ++count_;
+        sum_ += ns;
+        max_ = std::max(max_, ns);
+    }
+
+    void merge(const LatencyHistogram& other) noexcept {
+        for (std::size_t i = 0; i < kBuckets; ++i) buckets_[i] += other.buckets_[i];
+        count_ += other.count_;
+        sum_ += other.sum_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    void clear() noexcept { *this = LatencyHistogram{}; }
+
+    [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] std::uint64_t max() const noexcept { return max_; }
+    [[nodiscard]] double mean() const noexcept {
+        return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0;
+    }
+
+    // q ∈ [0, 1] の分位点(該当バケットの中央値で近似)
+    [[nodiscard]] std::uint64_t percentile(double q) const noexcept {
+        if (count_ == 0) return 0;
+        q = std::clamp(q, 0.0, 1.0);
+        const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(count_ - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i];
+            if (seen >= rank) return std::min(midpoint_of(i), max_);
+        }
+        return max_;
+    }
+
+   private:
+    std::array<std::uint64_t, kBuckets> buckets_{};
+    std::uint64_t count_{0};
+    std::uint64_t sum_{0};
+    std::uint64_t max_{0};
+
+    static constexpr std::size_t bucket_of(std::uint64_t v) noexcept {
+        if (v < kSub) return static_cast<std::size_t>(v);
+        const int msb = std::bit_width(v) - 1;
+        const int shift = msb - kSubBits;
+        const auto sub = static_cast<std::size_t>((v >> shift) & (kSub - 1));
+        return static_cast<std::size_t>(shift + 1) * kSub + sub;
+    }
+
+    static constexpr std::uint64_t midpoint_of(std::size_t idx) noexcept {
+        if (idx < kSub) return idx;
+        const auto shift = static_cast<int>(idx / kSub) - 1;
+        const std::uint64_t lower = (kSub + idx % kSub) << shift;
+        return lower + ((std::uint64_t{1} << shift) >> 1);
+    }
+};
@@ -0,0 +1,95 @@
+module;
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+export module LockFreeQueue;
+
+// =============================
+// 固定長ロックフリーキュー(複数生産者・単一消費者)
+//   リングの各枠に通し番号(sequence)を持たせ、生産者は書き込み位置を CAS で確保してから
+//   値を書き、sequence を進めて公開する(Vyukov の有界キュー)。消費者は 1 スレッドだけなので
+//   取り出し位置は CAS なしで進める。容量は生成時に確保したきりで、push / pop は確保しない。
+//   満杯なら try_push は false を返す(待たない)。
+// =============================
+
+export template <class T>
+class MpscQueue {
+    static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>,
+                  "MpscQueue requires nothrow move/destroy");
+
+   public:
+    // capacity は 2 の冪へ切り上げる(最小 2)
+    explicit MpscQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1),
+          slots_(std::make_unique<Slot[]>(mask_ + 1)) {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // 取り出されずに残った値を破棄する(生産者・消費者とも止まっている前提)
+    ~MpscQueue() {
+        for (; slots_[head_ & mask_].sequence.load(std::memory_order_relaxed) == head_ + 1;
+             ++head_) {
+            std::launder(reinterpret_cast<T*>(slots_[head_ & mask_].storage))->~T();
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    // どのスレッドからでも呼べる。満杯なら false
+    template <class U>
+    bool try_push(U&& value) noexcept(std::is_nothrow_constructible_v<T, U&&>) {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                // 空き枠: 位置を確保できたら書き込んで公開する
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    ::new (static_cast<void*>(slot.storage)) T(std::forward<U>(value));
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // 1 周前の値がまだ取り出されていない＝満杯
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);  // 他の生産者に先を越された
+            }
+        }
+    }
+
+    // 消費者スレッド(1 つ)だけが呼ぶ。空なら false
+    bool try_pop(T& out) noexcept {
+        Slot& slot = slots_[head_ & mask_];
+        const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq != head_ + 1) return false;
+        T* value = std::launder(reinterpret_cast<T*>(slot.storage));
+        out = std::move(*value);
+        value->~T();
+        slot.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+   private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    // 生産者が奪い合う位置と消費者だけが触る位置は別のキャッシュラインに置く
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::size_t head_{0};
+};
@@ -0,0 +1,310 @@
+module;
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// CMake の -DTETRIS_PROFILING=ON で 1 になる(モジュールはマクロを輸出できないので、
+// 以降は constexpr bool profiler::kEnabled で分岐する)
+#ifndef TETRIS_PROFILING
+#define TETRIS_PROFILING 0
+#endif
+
+export module Profiler;
+
+// =============================
+// フレームプロファイラ
+//   System ごとの実行時間とコマンド数、フェーズ、コマンド適用、描画、present を区間(zone)として記録し、
+//   直近 kWindow 回の p50/p95/p99 と Chrome/Perfetto のトレース JSON を出せるようにする。
+//   計測箇所は `if constexpr (profiler::kEnabled)` で囲むので、無効ビルドでは何も残らない。
+//   時計は std::chrono::steady_clock(ネイティブ/Emscripten 共通)。
+//   プロファイラは Game ごとに 1 つ(設定が持つ)。World は SharedProfiler として ctx で
+//   参照するだけなので、作り直した World も同じトレースへ書き続ける。
+//   トレースの区間は記録したスレッドごとのレーン(tid)に並ぶ(シミュレーションと描画が別の段になる)。
+// =============================
+
+export namespace profiler {
+
+inline constexpr bool kEnabled = TETRIS_PROFILING != 0;
+
+// コマンド数を持たない区間
+inline constexpr std::uint64_t kNoCount = ~std::uint64_t{0};
+
+/**
+ * @brief 関数ポインタの非型テンプレート引数から、修飾なしの関数名をコンパイル時に得る
+ *   例: function_name<&gravitySystem_pure>() == "gravitySystem_pure"
+ */
+template <auto Fn>
+constexpr std::string_view function_name() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    constexpr std::string_view sig = __FUNCSIG__;
+    constexpr std::string_view open = "function_name<";
+    constexpr std::size_t begin = sig.find(open) + open.size();
+    constexpr std::size_t end = sig.rfind(">(void)");
+#else
+    // GCC:   "... function_name() [with auto Fn = ns::f; ...]"
+    // Clang: "... function_name() [Fn = &ns::f]"
+    constexpr std::string_view sig = __PRETTY_FUNCTION__;
+    constexpr std::string_view open = "Fn = ";
+    constexpr std::size_t begin = sig.find(open) + open.size();
+    constexpr std::size_t end = sig.find_first_of(";]", begin);
+#endif
+    std::string_view name = sig.substr(begin, end - begin);
+    if (const auto amp = name.find('&'); amp != std::string_view::npos) {
+        name.remove_prefix(amp + 1);
+    }
+    if (const auto at = name.find('@'); at != std::string_view::npos) {
+        name = name.substr(0, at);  // モジュール所属の印(Clang)
+    }
+    if (const auto colon = name.rfind("::"); colon != std::string_view::npos) {
+        name.remove_prefix(colon + 2);
+    }
+    if (!name.empty() && name.back() == ')') name.remove_suffix(1);
+    return name;
+}
+
+/**
+ * @brief 区間ごとの集計
+ * @param name 区間名(System 名・"render_world" など)
+ * @param category 区間の種類("system" / "phase" / "apply" / "render" ...)
+ * @param samples 累計の記録回数
+ * @param p50_ns, p95_ns, p99_ns 直近 kWindow 回の分位点
+ * @param last_commands 直近のコマンド数(コマンドを持たない区間は kNoCount)
+ */
+struct ZoneSummary {
+    std::string_view name;
+    std::string_view category;
+    std::uint64_t samples{0};
+    std::uint64_t p50_ns{0};
+    std::uint64_t p95_ns{0};
+    std::uint64_t p99_ns{0};
+    std::uint64_t last_commands{kNoCount};
+};
+
+class FrameProfiler {
+   public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t kWindow = 256;
+
+    /**
+     * @param trace_path 破棄時にトレース JSON を書き出す先(空なら書き出さない)
+     * @param max_trace_events トレースに残す区間数の上限(超えた分は捨てる。集計は続く)
+     */
+    explicit FrameProfiler(std::string trace_path = {}, std::size_t max_trace_events = 1 << 18)
+        : trace_path_(std::move(trace_path)),
+          max_trace_events_(max_trace_events),
+          epoch_(Clock::now()) {}
+
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+    ~FrameProfiler() {
+        if (!trace_path_.empty() && !write_trace(trace_path_)) {
+            std::fprintf(stderr, "Failed to write frame trace: %s\n", trace_path_.c_str());
+        }
+    }
+
+    // 生成時刻からの経過ナノ秒
+    [[nodiscard]] std::uint64_t now_ns() const noexcept {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch_).count());
+    }
+
+    // 区間を 1 つ記録する(並列フェーズから同時に呼ばれてもよい)
+    //   name / category は静的な文字列(関数名・リテラル)であること
+    void record(std::string_view name, std::string_view category, std::uint64_t start_ns,
+                std::uint64_t dur_ns, std::uint64_t commands = kNoCount) {
+        std::lock_guard lock{mutex_};
+        Zone& z = zone(name, category);
+        z.window[z.samples % kWindow] = dur_ns;
+        ++z.samples;
+        z.last_commands = commands;
+        if (trace_.size() < max_trace_events_) {
+            trace_.push_back(TraceEvent{name, category, start_ns, dur_ns, commands, frame_,
+                                        lane_of(std::this_thread::get_id())});
+        }
+    }
+
+    // 定期レポートの間隔(フレーム数)。0 なら出さない(既定)
+    void report_every(std::uint64_t frames) noexcept {
+        std::lock_guard lock{mutex_};
+        report_interval_ = frames;
+    }
+
+    // 1 フレーム閉じる。report_every の間隔に達したら true(呼び出し側が report() を出す)
+    bool end_frame() noexcept {
+        std::lock_guard lock{mutex_};
+        ++frame_;
+        return report_interval_ != 0 && frame_ % report_interval_ == 0;
+    }
+    [[nodiscard]] std::uint64_t frames() const noexcept {
+        std::lock_guard lock{mutex_};
+        return frame_;
+    }
+
+    // 区間ごとの集計(初めて記録された順)
+    [[nodiscard]] std::vector<ZoneSummary> summaries() const {
+        std::lock_guard lock{mutex_};
+        std::vector<ZoneSummary> out;
+        out.reserve(zones_.size());
+        std::vector<std::uint64_t> sorted;
+        for (const auto& z : zones_) {
+            const auto n = static_cast<std::ptrdiff_t>(std::min<std::uint64_t>(z.samples, kWindow));
+            sorted.assign(z.window.begin(), z.window.begin() + n);
+            std::sort(sorted.begin(), sorted.end());
+            auto pct = [&sorted](double q) -> std::uint64_t {
+                if (sorted.empty()) return 0;
+                return sorted[static_cast<std::size_t>(q * static_cast<double>(sorted.size() - 1))];
+            };
+            out.push_back(ZoneSummary{z.name, z.category, z.samples, pct(0.50), pct(0.95),
+                                      pct(0.99), z.last_commands});
+        }
+        return out;
+    }
+
+    // 人が読む 1 区間 1 行の要約(単位は µs)
+    [[nodiscard]] std::string report() const {
+        std::string out;
+        char line[192];
+        for (const auto& s : summaries()) {
+            std::snprintf(line, sizeof(line), "%-8.*s %-32.*s p50 %8.1f p95 %8.1f p99 %8.1f",
+                          static_cast<int>(s.category.size()), s.category.data(),
+                          static_cast<int>(s.name.size()), s.name.data(),
+                          static_cast<double>(s.p50_ns) / 1e3, static_cast<double>(s.p95_ns) / 1e3,
+                          static_cast<double>(s.p99_ns) / 1e3);
+            out += line;
+            if (s.last_commands != kNoCount) {
+                out += " cmds " + std::to_string(s.last_commands);
+            }
+            out += '\n';
+        }
+        return out;
+    }
+
+    // Chrome Trace Event Format("X" 完了イベント)。chrome://tracing / ui.perfetto.dev で開ける
+    //   tid は記録したスレッドのレーン(最初に記録したスレッドから 1, 2, ...)
+    [[nodiscard]] std::string trace_json() const {
+        std::lock_guard lock{mutex_};
+        std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        char num[96];
+        bool first = true;
+        for (const auto& e : trace_) {
+            if (!first) out += ',';
+            first = false;
+            out += "{\"name\":\"";
+            append_escaped(out, e.name);
+            out += "\",\"cat\":\"";
+            append_escaped(out, e.category);
+            std::snprintf(num, sizeof(num),
+                          "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                          e.lane, static_cast<double>(e.start_ns) / 1e3,
+                          static_cast<double>(e.dur_ns) / 1e3);
+            out += num;
+            out += ",\"args\":{\"frame\":" + std::to_string(e.frame);
+            if (e.commands != kNoCount) out += ",\"commands\":" + std::to_string(e.commands);
+            out += "}}";
+        }
+        out += "]}\n";
+        return out;
+    }
+
+    [[nodiscard]] bool write_trace(const std::string& path) const {
+        std::ofstream os(path, std::ios::trunc);
+        if (!os) return false;
+        os << trace_json();
+        return static_cast<bool>(os);
+    }
+
+   private:
+    struct Zone {
+        std::string_view name;
+        std::string_view category;
+        std::uint64_t samples{0};
+        std::uint64_t last_commands{kNoCount};
+        std::array<std::uint64_t, kWindow> window{};  // 直近 kWindow 回の所要時間(リング)
+    };
+    struct TraceEvent {
+        std::string_view name;
+        std::string_view category;
+        std::uint64_t start_ns;
+        std::uint64_t dur_ns;
+        std::uint64_t commands;
+        std::uint64_t frame;
+        unsigned lane;
+    };
+
+    std::string trace_path_;
+    std::size_t max_trace_events_;
+    Clock::time_point epoch_;
+    mutable std::mutex mutex_;
+    std::vector<Zone> zones_;  // 区間は高々数十なので線形探索で十分
+    std::vector<TraceEvent> trace_;
+    std::vector<std::thread::id> lanes_;  // 記録したスレッド(添字 + 1 がレーン)
+    std::uint64_t frame_{0};
+    std::uint64_t report_interval_{0};
+
+    Zone& zone(std::string_view name, std::string_view category) {
+        for (auto& z : zones_) {
+            if (z.name == name && z.category == category) return z;
+        }
+        zones_.push_back(Zone{name, category});
+        return zones_.back();
+    }
+
+    unsigned lane_of(std::thread::id id) {
+        for (std::size_t i = 0; i < lanes_.size(); ++i) {
+            if (lanes_[i] == id) return static_cast<unsigned>(i + 1);
+        }
+        lanes_.push_back(id);
+        return static_cast<unsigned>(lanes_.size());
+    }
+
+    static void append_escaped(std::string& out, std::string_view s) {
+        for (const char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+    }
+};
+
+// registry の ctx に置く参照(本体の持ち主は設定。最後の参照が消えたときにトレースを書き出す)
+using SharedProfiler = std::shared_ptr<FrameProfiler>;
+
+/**
+ * @brief スコープの入口から出口までを 1 区間として記録する
+ *   profiler が null、または kEnabled == false なら何もしない
+ */
+class ScopedZone {
+   public:
+    ScopedZone(FrameProfiler* profiler, std::string_view name, std::string_view category) noexcept
+        : profiler_(kEnabled ? profiler : nullptr), name_(name), category_(category) {
+        if (profiler_) start_ = profiler_->now_ns();
+    }
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+    ~ScopedZone() {
+        if (profiler_) {
+            profiler_->record(name_, category_, start_, profiler_->now_ns() - start_, commands_);
+        }
+    }
+
+    void set_commands(std::uint64_t n) noexcept { commands_ = n; }
+
+   private:
+    FrameProfiler* profiler_;
+    std::string_view name_;
+    std::string_view category_;
+    std::uint64_t start_{0};
+    std::uint64_t commands_{kNoCount};
+};
+
+}  // namespace profiler
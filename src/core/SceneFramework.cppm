@@ -1,5 +1,6 @@
 module;
 #include <SDL2/SDL.h>
+#include <concepts>
 #include <functional>  // 追加
 #include <memory>
 #include <tl/expected.hpp>
@@ -63,4 +64,29 @@ concept SceneAPI =
         { Impl::draw(cs, r, env) } -> std::same_as<void>;
     };
 
+// ★ 追加: 描画用の写しを出せるシーン実装
+//   Snapshot はシーンの見た目だけを写した値(シーン本体やその World を参照しない)、
+//   RenderState は描画側だけが持つ状態(頂点キャッシュなど)。
+//   publish はシミュレーション側で呼ばれ、draw_snapshot は描画側で呼ばれる。
+//   満たしていれば Game はシミュレーションを描画と別のスレッドで進められる
+template <class Impl, class Setting>
+concept SnapshotSceneAPI =
+    SceneAPI<Impl, Setting> && std::default_initializable<typename Impl::Snapshot> &&
+    std::default_initializable<typename Impl::RenderState> &&
+    requires(const typename Impl::Scene& cs, typename Impl::Snapshot& out,
+             const typename Impl::Snapshot& snap, typename Impl::RenderState& rs,
+             SDL_Renderer* const r, const Env<Setting>& env) {
+        { Impl::publish(cs, out) } -> std::same_as<void>;
+        { Impl::draw_snapshot(snap, rs, r, env) } -> std::same_as<void>;
+    };
+
+// ★ 追加: 描画の直前にメインスレッドで下準備をするシーン実装(任意)
+//   before_draw は、シミュレーションを別スレッドで進めていても描画側のスレッドで呼ばれる
+//   (SDL_ttf など、ウィンドウを作ったスレッドでしか触れないものをここで扱う)。
+//   env.update_setting で予約した差し替えは、シミュレーション側の次のステップで適用される
+template <class Impl, class Setting>
+concept MainThreadSceneAPI = SceneAPI<Impl, Setting> && requires(const Env<Setting>& env) {
+    { Impl::before_draw(env) } -> std::same_as<void>;
+};
+
 }  // namespace scene_fw
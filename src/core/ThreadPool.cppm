@@ -0,0 +1,194 @@
+module;
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+export module ThreadPool;
+
+// =============================
+// ワークスティーリング・スレッドプール
+//   各ワーカーが自分の両端キューを持ち、自分のキューは末尾から(LIFO)、
+//   他ワーカーのキューは先頭から(FIFO)盗んで実行する。
+//   parallel_for の呼び出し元スレッドも完了待ちの間はタスクを実行する。
+//   盗むものがなければワーカーも呼び出し元も条件変数で眠り、空回りはしない。
+//   Emscripten(pthread なし)ではワーカー 0 本＝呼び出し元で逐次実行になる。
+// =============================
+
+export class WorkStealingPool {
+   public:
+    // 既定のワーカー数(呼び出し元スレッドも働くので hardware_concurrency - 1)
+    static unsigned default_worker_count() noexcept {
+#ifdef __EMSCRIPTEN__
+        return 0;
+#else
+        const unsigned hc = std::thread::hardware_concurrency();
+        return hc > 1 ? hc - 1 : 0;
+#endif
+    }
+
+    explicit WorkStealingPool(unsigned workers = default_worker_count()) {
+#ifdef __EMSCRIPTEN__
+        workers = 0;
+#endif
+        queues_.reserve(workers);
+        for (unsigned i = 0; i < workers; ++i) queues_.push_back(std::make_unique<Queue>());
+        threads_.reserve(workers);
+        for (unsigned i = 0; i < workers; ++i) {
+            threads_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard lk(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    [[nodiscard]] unsigned worker_count() const noexcept {
+        return static_cast<unsigned>(threads_.size());
+    }
+
+    // fn(i) を i = 0..n-1 について実行し、全て終わるまで待つ
+    //   fn は複数スレッドから同時に呼ばれる。例外は最初の 1 つを呼び出し元で再送出する
+    template <class Fn>
+    void parallel_for(std::size_t n, Fn&& fn) {
+        if (n == 0) return;
+        if (threads_.empty() || n == 1) {
+            for (std::size_t i = 0; i < n; ++i) fn(i);
+            return;
+        }
+
+        Batch batch{};
+        batch.remaining.store(n, std::memory_order_relaxed);
+        batch.ctx = static_cast<const void*>(&fn);
+        batch.run = [](const void* ctx, std::size_t i) {
+            (*static_cast<std::remove_reference_t<Fn>*>(const_cast<void*>(ctx)))(i);
+        };
+
+        // ワーカーのキューへ順に配る
+        //   queued_ は wake_mutex_ の下で増やす(ワーカーの待機判定と通知の取りこぼしを防ぐ)
+        for (std::size_t i = 0; i < n; ++i) {
+            auto& q = *queues_[(next_queue_++) % queues_.size()];
+            std::lock_guard lk(q.mutex);
+            q.tasks.push_back(Task{&batch, i});
+        }
+        {
+            std::lock_guard lk(wake_mutex_);
+            queued_.fetch_add(n, std::memory_order_relaxed);
+        }
+        wake_.notify_all();
+
+        // 盗めるうちは呼び出し元も働く(キュー 0 を自分のキューとして扱う)
+        while (batch.remaining.load(std::memory_order_acquire) != 0) {
+            auto t = steal(0);
+            if (!t) break;
+            execute(*t);
+        }
+        // 残りは他ワーカーが実行中：最後の 1 つが終わるまで眠る
+        {
+            std::unique_lock lk(wake_mutex_);
+            done_.wait(lk, [&] { return batch.remaining.load(std::memory_order_acquire) == 0; });
+        }
+        if (batch.error) std::rethrow_exception(batch.error);
+    }
+
+   private:
+    struct Batch {
+        std::atomic<std::size_t> remaining{0};
+        const void* ctx{nullptr};
+        void (*run)(const void*, std::size_t){nullptr};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    struct Task {
+        Batch* batch;
+        std::size_t index;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> next_queue_{0};
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;  // ワーカー: キューにタスクが積まれた / 停止
+    std::condition_variable done_;  // 呼び出し元: バッチの最後のタスクが終わった
+    std::atomic<std::size_t> queued_{0};  // どのキューにも残っている未着手タスク数
+    bool stopping_{false};
+
+    void execute(const Task& t) noexcept {
+        try {
+            t.batch->run(t.batch->ctx, t.index);
+        } catch (...) {
+            std::lock_guard lk(t.batch->error_mutex);
+            if (!t.batch->error) t.batch->error = std::current_exception();
+        }
+        // 0 にした後は batch(呼び出し元のスタック)に触れない。通知はプールのメンバーだけで行う
+        if (t.batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            {
+                std::lock_guard lk(wake_mutex_);
+            }
+            done_.notify_all();
+        }
+    }
+
+    // self のキュー末尾 → 他キュー先頭の順で 1 タスク取り出す
+    std::optional<Task> steal(std::size_t self) {
+        const std::size_t n = queues_.size();
+        {
+            auto& own = *queues_[self % n];
+            std::lock_guard lk(own.mutex);
+            if (!own.tasks.empty()) {
+                Task t = own.tasks.back();
+                own.tasks.pop_back();
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                return t;
+            }
+        }
+        for (std::size_t k = 1; k < n; ++k) {
+            auto& victim = *queues_[(self + k) % n];
+            std::lock_guard lk(victim.mutex);
+            if (!victim.tasks.empty()) {
+                Task t = victim.tasks.front();
+                victim.tasks.pop_front();
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                return t;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void worker_loop(std::size_t self) {
+        for (;;) {
+            if (auto t = steal(self)) {
+                execute(*t);
+                continue;
+            }
+            // 盗めなかった：次にタスクが積まれるまで眠る
+            std::unique_lock lk(wake_mutex_);
+            wake_.wait(lk, [this] {
+                return stopping_ || queued_.load(std::memory_order_relaxed) != 0;
+            });
+            if (stopping_) return;
+        }
+    }
+};
@@ -0,0 +1,53 @@
+module;
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+export module TripleBuffer;
+
+// =============================
+// トリプルバッファ(書き手 1・読み手 1)
+//   3 枠のうち、書き手が書いている枠(back)・読み手が読んでいる枠(front)・
+//   最新の書き上がり(middle)を入れ替えて受け渡す。どちらも相手を待たない:
+//   書き手は publish のたびに back と middle を交換し、読み手は新しいものがあるときだけ
+//   front と middle を交換する。読み手が追いつかなければ古い書き上がりは読まれずに上書きされる。
+//   枠は使い回すので、T がバッファを持つなら同じ大きさへの書き込みは確保しない。
+// =============================
+
+export template <class T>
+class TripleBuffer {
+   public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // 書き手: 次に公開する枠(前回ここで公開したものより古い内容が残っている)
+    [[nodiscard]] T& back() noexcept { return slots_[back_]; }
+
+    // 書き手: back を最新として公開し、空いた枠を次の back にする
+    void publish() noexcept {
+        back_ = middle_.exchange(static_cast<std::uint8_t>(back_ | kFresh),
+                                 std::memory_order_acq_rel) &
+                kIndexMask;
+    }
+
+    // 読み手: 前回から新しく公開されていれば front を差し替えて true
+    bool acquire() noexcept {
+        if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    // 読み手: 手元の最新(一度も acquire していなければ既定構築の値)
+    [[nodiscard]] const T& front() const noexcept { return slots_[front_]; }
+
+   private:
+    static constexpr std::uint8_t kIndexMask = 0x3;
+    static constexpr std::uint8_t kFresh = 0x4;  // middle が読み手にまだ渡っていない
+
+    std::array<T, 3> slots_{};
+    // 書き手だけ・読み手だけが触る添字と、両者が交換する middle は別のキャッシュラインに置く
+    alignas(64) std::uint8_t back_{0};
+    alignas(64) std::atomic<std::uint8_t> middle_{1};
+    alignas(64) std::uint8_t front_{2};
+};
@@ -1,8 +1,13 @@
 #include <SDL2/SDL.h>  // SDL_Window, SDL_Renderer の型が必要
-#include <SDL2/SDL_ttf.h>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
+#include <optional>
+#include <string>
 import Game;
 import GlobalSetting;
+import AssetLoader;
+import Profiler;
 import MyScenes;
 
 int main() {
@@ -13,12 +18,33 @@ int main() {
     constexpr int columns = 10;
     constexpr int rows = 20;
     constexpr int cell_width = 30;
-    constexpr int cell_height = 30;
+    constexpr int cell_height = global_setting::kUiFontPointSize;  // 文字はマスの高さで描く
     constexpr int fps = 60;
     constexpr double drop_rate = 0.7;
     constexpr int canvas_width = columns * cell_width + (150 * 2);  // 右側にnextを出すための150px
     constexpr int canvas_height = rows * cell_height;
 
+    // 決定的モード: TETRIS_SEED を指定すると 7-Bag の順序と刻みが固定される
+    //   TETRIS_RECORD も指定すると、その入力をファイルへ記録する(replay ツールで再生可能)
+    std::optional<std::uint32_t> seed;
+    if (const char* s = std::getenv("TETRIS_SEED")) {
+        seed = static_cast<std::uint32_t>(std::strtoul(s, nullptr, 10));
+    }
+    const char* record_env = std::getenv("TETRIS_RECORD");
+    const std::string record_path = record_env ? record_env : "";
+    // 固定刻みループ(既定で有効)。TETRIS_FIXED_STEP=0 で従来の可変 dt に戻す
+    const char* fixed_env = std::getenv("TETRIS_FIXED_STEP");
+    const bool fixed_step = !(fixed_env && std::string(fixed_env) == "0");
+    // 固定刻みならシミュレーションは描画と別スレッド。TETRIS_SIM_THREAD=0 で 1 スレッドに戻す
+    const char* sim_thread_env = std::getenv("TETRIS_SIM_THREAD");
+    const bool sim_thread = !(sim_thread_env && std::string(sim_thread_env) == "0");
+    // プロファイラ(-DTETRIS_PROFILING=ON でビルドしたときのみ): 終了時に Chrome トレースを書き出す
+    const char* trace_env = std::getenv("TETRIS_TRACE");
+    const std::string trace_path = trace_env ? trace_env : "";
+    //   TETRIS_PROFILE_LOG=1 なら 5 秒ごとに区間ごとの分位点をログにも出す
+    const char* profile_log_env = std::getenv("TETRIS_PROFILE_LOG");
+    const bool profile_log = profile_log_env && std::string(profile_log_env) == "1";
+
     // SDL 初期化 / window / renderer 生成後に呼ばれる Setting のファクトリ
     const auto factory = [=](SDL_Window* window,
                              SDL_Renderer* renderer) -> std::shared_ptr<const Setting> {
@@ -27,17 +53,19 @@ int main() {
         (void)window;
         (void)renderer;
 
-        // フォントを SDL_ttf からロードし、shared_ptr で管理
-        global_setting::FontPtr font{
-            TTF_OpenFont("assets/Noto_Sans_JP/static/NotoSansJP-Regular.ttf", cell_height),
-            global_setting::TtfFontDeleter{}};
-        if (!font) {
-            SDL_Log("Failed to load font: %s", TTF_GetError());
-            throw std::runtime_error("Failed to load NotoSansJP-Regular.ttf");
-        }
-
+        // フォント(数 MB)は最初のフレームを待たせないよう裏で読み込む(届いたら Setting ごと
+        // 差し替わる)。それまでは UI の文字だけを焼き込んだアトラス(数 KB)で描く
         auto s = std::make_shared<Setting>(columns, rows, cell_width, cell_height, fps, drop_rate,
-                                           std::move(font), canvas_width, canvas_height);
+                                           global_setting::FontPtr{}, canvas_width, canvas_height,
+                                           seed, record_path, fixed_step, trace_path, sim_thread);
+        if (s->frame_profiler && profile_log) s->frame_profiler->report_every(fps * 5);
+        s->ui_atlas = global_setting::load_ui_atlas(global_setting::kUiAtlasPath);
+        if (!s->ui_atlas) {
+            SDL_Log("UI atlas not found (%s): text appears once the font is loaded",
+                    global_setting::kUiAtlasPath);
+        }
+        s->assets = std::make_shared<assets::AssetLoader>();
+        s->assets->request(global_setting::kUiFontPath);
 
         // const 共有ポインタとして返す
         return std::shared_ptr<const Setting>(std::move(s));
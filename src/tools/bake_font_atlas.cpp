@@ -0,0 +1,113 @@
+// グリフアトラスの焼き込み(ビルド時に 1 回実行する)
+//   UI に出す文字列(UiText モジュール)に含まれる文字だけを TTF からラスタライズし、
+//   1 枚のカバレッジ画像 + 文字ごとの矩形・送り幅として小さなバイナリに書き出す。
+//   実行時はこれを起動直後に読み、フォント本体の読み込みを待たずに UI 文字を描く。
+//
+//   使い方: bake_font_atlas <font.ttf> <point_size> <out.bin>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+import SDLPtr;
+import GlyphAtlas;
+import UiText;
+
+namespace {
+
+// 1 文字をラスタライズしてカバレッジ(アルファ)だけ取り出す
+bool rasterize(TTF_Font* font, char32_t cp, glyph_atlas::GlyphBitmap& out) {
+    int minx = 0;
+    int maxx = 0;
+    int miny = 0;
+    int maxy = 0;
+    int advance = 0;
+    if (TTF_GlyphMetrics32(font, static_cast<Uint32>(cp), &minx, &maxx, &miny, &maxy, &advance) !=
+        0) {
+        return false;
+    }
+    out.codepoint = cp;
+    out.advance = advance;
+    if (cp == U' ') return true;  // 空白は送り幅だけ
+
+    SurfacePtr rendered{TTF_RenderGlyph32_Blended(font, static_cast<Uint32>(cp),
+                                                  SDL_Color{255, 255, 255, 255}),
+                        SDL_FreeSurface};
+    if (!rendered) return false;
+    SurfacePtr argb{SDL_ConvertSurfaceFormat(rendered.get(), SDL_PIXELFORMAT_ARGB8888, 0),
+                    SDL_FreeSurface};
+    if (!argb) return false;
+
+    out.w = argb->w;
+    out.h = argb->h;
+    out.coverage.resize(static_cast<std::size_t>(out.w * out.h));
+    const auto* pixels = static_cast<const std::uint8_t*>(argb->pixels);
+    for (int r = 0; r < out.h; ++r) {
+        const auto* row = reinterpret_cast<const std::uint32_t*>(pixels + r * argb->pitch);
+        for (int c = 0; c < out.w; ++c) {
+            out.coverage[static_cast<std::size_t>(r * out.w + c)] =
+                static_cast<std::uint8_t>(row[c] >> 24);
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        std::fprintf(stderr, "usage: %s <font.ttf> <point_size> <out.bin>\n", argv[0]);
+        return 2;
+    }
+    if (TTF_Init() != 0) {
+        std::fprintf(stderr, "TTF_Init failed: %s\n", TTF_GetError());
+        return 1;
+    }
+    std::unique_ptr<TTF_Font, decltype(&TTF_CloseFont)> font{
+        TTF_OpenFont(argv[1], std::atoi(argv[2])), TTF_CloseFont};
+    if (!font) {
+        std::fprintf(stderr, "cannot open %s: %s\n", argv[1], TTF_GetError());
+        return 1;
+    }
+
+    std::set<char32_t> codepoints;
+    for (const std::string_view text : ui_text::kAll) {
+        for (std::size_t i = 0; i < text.size();) {
+            codepoints.insert(glyph_atlas::next_codepoint(text, i));
+        }
+    }
+
+    std::vector<glyph_atlas::GlyphBitmap> bitmaps;
+    bitmaps.reserve(codepoints.size());
+    for (const char32_t cp : codepoints) {
+        glyph_atlas::GlyphBitmap b;
+        if (!rasterize(font.get(), cp, b)) {
+            std::fprintf(stderr, "cannot rasterize U+%04X: %s\n", static_cast<unsigned>(cp),
+                         TTF_GetError());
+            return 1;
+        }
+        bitmaps.push_back(std::move(b));
+    }
+
+    const auto atlas = glyph_atlas::pack(std::move(bitmaps), TTF_FontHeight(font.get()));
+    const auto bytes = glyph_atlas::encode(atlas);
+    std::ofstream os(argv[3], std::ios::binary | std::ios::trunc);
+    if (!os.write(reinterpret_cast<const char*>(bytes.data()),
+                  static_cast<std::streamsize>(bytes.size()))) {
+        std::fprintf(stderr, "cannot write %s\n", argv[3]);
+        return 1;
+    }
+    std::printf("glyphs=%zu atlas=%dx%d bytes=%zu\n", atlas.glyphs.size(), atlas.width,
+                atlas.height, bytes.size());
+
+    font.reset();
+    TTF_Quit();
+    return 0;
+}
@@ -0,0 +1,256 @@
+// ヘッドレス一括シミュレータ
+//   SDL のビデオ/TTF を初期化せずに多数の World を全コアで並列に進め、
+//   スループット(games/sec, frames/sec)と step_world 1 回あたりのレイテンシ(p50/p99)を測る。
+//
+//   使い方: batch_sim [--worlds N] [--frames F] [--threads T]
+//                     [--policy idle|random|drop|search] [--search-depth D]
+//                     [--seed S] [--max-game-frames G]
+//     --frames は World 1 つあたりに進めるフレーム数。ゲームオーバー(または G フレーム経過)で
+//     同じ枠に新しい World を作り直して続ける。
+//     search は配置探索(PlacementSearch)で D 手先まで読んだ配置へピースを運ぶ CPU プレイヤー
+//     (対戦モードの CPU と同じ CpuPlayer モジュール)。
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+import GlobalSetting;
+import SceneFramework;
+import Input;
+import GameKey;
+import TetrisRule;
+import CpuPlayer;
+import ThreadPool;
+import LatencyHistogram;
+
+namespace {
+
+using global_setting::GlobalSetting;
+using game_key::GameKey;
+using Clock = std::chrono::steady_clock;
+
+enum class Policy { Idle, Random, Drop, Search };
+
+struct Options {
+    std::size_t worlds = 2048;
+    std::uint64_t frames = 3600;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    Policy policy = Policy::Random;
+    int search_depth = 1;
+    std::uint32_t seed = 1;
+    std::uint64_t max_game_frames = 60 * 60 * 10;
+};
+
+// 1 枠分の状態(World と、それを操作するボット)
+struct Slot {
+    tetris_rule::World world;
+    cpu_player::CpuPlayer bot;  // 入力はボットが持つ(search 以外のポリシーも入力だけ借りる)
+    std::mt19937 rng;
+    std::uint64_t game_frames = 0;
+    std::uint32_t games = 0;
+};
+
+struct ChunkResult {
+    std::uint64_t frames = 0;
+    std::uint64_t games = 0;
+    std::uint64_t failed_resets = 0;  // 作り直しに失敗して打ち切った枠の数
+    LatencyHistogram step_ns;
+};
+
+// ポリシーに従ってこのフレームの入力を作る(押したキーは次フレームで離す)
+void drive(Slot& s, const Options& o, const scene_fw::Env<GlobalSetting>& env) {
+    cpu_player::drive(s.bot, [&]() -> std::optional<GameKey> {
+        switch (o.policy) {
+            case Policy::Idle:
+                break;
+            case Policy::Random: {
+                static constexpr GameKey kKeys[] = {GameKey::LEFT,        GameKey::RIGHT,
+                                                    GameKey::ROTATE_LEFT, GameKey::ROTATE_RIGHT,
+                                                    GameKey::HOLD,        GameKey::DROP};
+                // 平均 8 フレームに 1 回、ランダムなキーを叩く
+                if (s.rng() % 8 == 0) return kKeys[s.rng() % std::size(kKeys)];
+                break;
+            }
+            case Policy::Drop:
+                if (s.game_frames % 10 == 0) return GameKey::DROP;
+                break;
+            case Policy::Search:
+                return cpu_player::search_key(s.bot, s.world, env);
+        }
+        return std::nullopt;
+    });
+}
+
+[[nodiscard]] bool reset_world(Slot& s, const GlobalSetting& setting, double dt,
+                               std::uint32_t seed, int search_depth) {
+    s.bot.reset();
+    s.bot.depth = search_depth;
+    s.game_frames = 0;
+    s.rng.seed(seed);
+    const scene_fw::Env<GlobalSetting> env{s.bot.input, setting, dt, {}};
+    auto w = tetris_rule::make_world(env, seed, /*standalone=*/false);
+    if (!w) return false;
+    s.world = std::move(*w);
+    return true;
+}
+
+std::optional<Options> parse(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--worlds" && has_value) {
+            o.worlds = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--frames" && has_value) {
+            o.frames = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && has_value) {
+            o.threads = std::max(1u, static_cast<unsigned>(std::atoi(argv[++i])));
+        } else if (arg == "--search-depth" && has_value) {
+            o.search_depth = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--seed" && has_value) {
+            o.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--max-game-frames" && has_value) {
+            o.max_game_frames = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--policy" && has_value) {
+            const std::string_view p = argv[++i];
+            if (p == "idle") {
+                o.policy = Policy::Idle;
+            } else if (p == "random") {
+                o.policy = Policy::Random;
+            } else if (p == "drop") {
+                o.policy = Policy::Drop;
+            } else if (p == "search") {
+                o.policy = Policy::Search;
+            } else {
+                return std::nullopt;
+            }
+        } else {
+            return std::nullopt;
+        }
+    }
+    return o;
+}
+
+const char* policy_name(Policy p) {
+    switch (p) {
+        case Policy::Idle:
+            return "idle";
+        case Policy::Random:
+            return "random";
+        case Policy::Drop:
+            return "drop";
+        case Policy::Search:
+            return "search";
+    }
+    return "?";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const auto opt = parse(argc, argv);
+    if (!opt) {
+        std::fprintf(stderr,
+                     "usage: %s [--worlds N] [--frames F] [--threads T] "
+                     "[--policy idle|random|drop|search] [--search-depth D] [--seed S] "
+                     "[--max-game-frames G]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    // 描画しないのでフォントは不要(null のまま)
+    constexpr int columns = 10;
+    constexpr int rows = 20;
+    constexpr int cell = 30;
+    const GlobalSetting setting{columns,
+                                rows,
+                                cell,
+                                cell,
+                                60,
+                                0.7,
+                                global_setting::FontPtr{},
+                                columns * cell + 300,
+                                rows * cell,
+                                opt->seed};
+    const double dt = setting.fixed_step_seconds();
+
+    std::vector<Slot> slots(opt->worlds);
+    for (std::size_t i = 0; i < slots.size(); ++i) {
+        if (!reset_world(slots[i], setting, dt, opt->seed + static_cast<std::uint32_t>(i),
+                         opt->search_depth)) {
+            std::fprintf(stderr, "make_world failed\n");
+            return 1;
+        }
+    }
+
+    // 呼び出し元スレッドも働くので、ワーカーは threads - 1 本
+    WorkStealingPool pool{opt->threads - 1};
+    const std::size_t chunk_count = std::min<std::size_t>(slots.size(), opt->threads * 8);
+    std::vector<ChunkResult> results(chunk_count);
+
+    const auto t0 = Clock::now();
+    pool.parallel_for(chunk_count, [&](std::size_t c) {
+        ChunkResult& out = results[c];
+        const std::size_t begin = slots.size() * c / chunk_count;
+        const std::size_t end = slots.size() * (c + 1) / chunk_count;
+        for (std::size_t i = begin; i < end; ++i) {
+            Slot& s = slots[i];
+            for (std::uint64_t f = 0; f < opt->frames; ++f) {
+                const scene_fw::Env<GlobalSetting> env{s.bot.input, setting, dt, {}};
+                drive(s, *opt, env);
+
+                const auto s0 = Clock::now();
+                tetris_rule::step_world(s.world, env);
+                const auto s1 = Clock::now();
+                out.step_ns.record(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(s1 - s0).count()));
+                ++out.frames;
+                ++s.game_frames;
+
+                if (tetris_rule::is_gameover(s.world) || s.game_frames >= opt->max_game_frames) {
+                    ++out.games;
+                    ++s.games;
+                    const auto seed = opt->seed + static_cast<std::uint32_t>(i) +
+                                      static_cast<std::uint32_t>(s.games) * 0x9E3779B9u;
+                    if (!reset_world(s, setting, dt, seed, opt->search_depth)) {
+                        // 終わった World を進め続けないよう、この枠は打ち切る
+                        ++out.failed_resets;
+                        break;
+                    }
+                }
+            }
+        }
+    });
+    const double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    ChunkResult total;
+    for (const auto& r : results) {
+        total.frames += r.frames;
+        total.games += r.games;
+        total.failed_resets += r.failed_resets;
+        total.step_ns.merge(r.step_ns);
+    }
+
+    std::printf("worlds=%zu threads=%u policy=%s frames_per_world=%" PRIu64 "\n", slots.size(),
+                opt->threads, policy_name(opt->policy), opt->frames);
+    std::printf("elapsed_sec=%.3f games=%" PRIu64 " games_per_sec=%.1f frames=%" PRIu64
+                " frames_per_sec=%.0f\n",
+                sec, total.games, sec > 0.0 ? static_cast<double>(total.games) / sec : 0.0,
+                total.frames, sec > 0.0 ? static_cast<double>(total.frames) / sec : 0.0);
+    std::printf("step_ns p50=%" PRIu64 " p99=%" PRIu64 " max=%" PRIu64 " mean=%.0f\n",
+                total.step_ns.percentile(0.50), total.step_ns.percentile(0.99),
+                total.step_ns.max(), total.step_ns.mean());
+    if (total.failed_resets > 0) {
+        std::fprintf(stderr, "make_world failed while restarting %" PRIu64 " world(s)\n",
+                     total.failed_resets);
+        return 1;
+    }
+    return 0;
+}
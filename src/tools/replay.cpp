@@ -0,0 +1,101 @@
+// ヘッドレス再生ツール
+//   TETRIS_SEED / TETRIS_RECORD で記録した入力を、描画なし・待ちなしで再生し、
+//   フレームごとの状態ハッシュ(盤面＋アクティブピース)を出力する。
+//
+//   ゲーム画面と同じく UndoHistory で進めるので、UNDO を押したフレームも同じように戻る。
+//   盤面の大きさ・落下速度などのルール設定は記録のヘッダから採る。このビルドの設定で
+//   再現できない記録(ロック遅延などの既定値が違う)は再生せずにエラーにする。
+//
+//   使い方: replay <recording> [--quiet]
+//     標準出力: "<frame> <hash(16進)>" を 1 行ずつ
+//     標準エラー: フレーム数・経過時間・フレーム/秒
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+import GlobalSetting;
+import SceneFramework;
+import Input;
+import InputRecord;
+import TetrisRule;
+
+int main(int argc, char** argv) {
+    using global_setting::GlobalSetting;
+
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <recording> [--quiet]\n", argv[0]);
+        return 2;
+    }
+
+    bool quiet = false;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--quiet") {
+            quiet = true;
+        } else {
+            std::fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    auto replayer = input_record::InputReplayer::load(argv[1]);
+    if (!replayer) {
+        std::fprintf(stderr, "failed to load recording: %s\n", replayer.error().c_str());
+        return 1;
+    }
+    const auto header = replayer->header();
+
+    // 記録時の設定を採用する(セルの大きさは描画専用なので任意)
+    constexpr int cell = 30;
+    const int columns = header.columns;
+    const int rows = header.rows;
+    const GlobalSetting setting{columns,
+                                rows,
+                                cell,
+                                cell,
+                                header.frame_rate,
+                                header.drop_rate,
+                                global_setting::FontPtr{},
+                                columns * cell + 300,
+                                rows * cell,
+                                header.seed};
+    if (tetris_rule::recording_header(setting, header.seed) != header) {
+        std::fprintf(stderr,
+                     "recording was made with rule settings this build cannot reproduce "
+                     "(lock delay, spawn position or drop limits differ)\n");
+        return 1;
+    }
+    const double dt = setting.fixed_step_seconds();
+
+    input::Input input{};
+    const scene_fw::Env<GlobalSetting> init_env{input, setting, dt, {}};
+    auto world = tetris_rule::make_world(init_env);
+    if (!world) {
+        std::fprintf(stderr, "make_world failed: %s\n", world.error().c_str());
+        return 1;
+    }
+
+    tetris_rule::UndoHistory history{*world, tetris_rule::kUndoDepth, rows, columns};
+    std::uint64_t frames = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    while (replayer->next_frame(input)) {
+        const scene_fw::Env<GlobalSetting> env{input, setting, dt, {}};
+        history.step(*world, env);
+        if (!quiet) {
+            std::printf("%" PRIu64 " %016" PRIx64 "\n", frames, tetris_rule::state_hash(*world));
+        }
+        ++frames;
+        if (tetris_rule::is_gameover(*world)) break;
+    }
+    const double sec =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::fprintf(stderr,
+                 "frames=%" PRIu64 " seconds=%.6f frames_per_sec=%.0f final_hash=%016" PRIx64 "%s\n",
+                 frames, sec, sec > 0.0 ? static_cast<double>(frames) / sec : 0.0,
+                 tetris_rule::state_hash(*world),
+                 replayer->at_end() ? "" : " (stopped at game over)");
+    return 0;
+}
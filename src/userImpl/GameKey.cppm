@@ -1,10 +1,14 @@
 module;
 #include <SDL2/SDL_keycode.h>
+#include <array>
+#include <cstddef>
 #include <optional>
 #include <unordered_map>
-#include <vector>
+#include <utility>
 export module GameKey;
 
+import Input;
+
 export namespace game_key {
 
 enum class GameKey {
@@ -15,16 +19,23 @@ enum class GameKey {
     ROTATE_LEFT,
     ROTATE_RIGHT,
     DROP,
+    UNDO,    // ★ 追加: 練習モードの 1 手戻し
+    VERSUS,  // ★ 追加: タイトルから対戦モードへ
     PAUSE,
     QUIT,
 };
 
+inline constexpr std::size_t kGameKeyCount = static_cast<std::size_t>(GameKey::QUIT) + 1;
+
 // SDL_Keycode ⇄ GameKey の対応を1か所に定義
-inline const std::vector<std::pair<SDL_Keycode, GameKey>> KEY_MAP = {
+inline constexpr std::array<std::pair<SDL_Keycode, GameKey>, 11> KEY_MAP = {{
     {SDLK_a, GameKey::LEFT},       {SDLK_d, GameKey::RIGHT},       {SDLK_w, GameKey::HOLD},
     {SDLK_s, GameKey::DOWN},       {SDLK_z, GameKey::ROTATE_LEFT}, {SDLK_x, GameKey::ROTATE_RIGHT},
     {SDLK_SPACE, GameKey::DROP},  // ← 追加: ハードドロップ
-    {SDLK_RETURN, GameKey::PAUSE}, {SDLK_ESCAPE, GameKey::QUIT}};
+    {SDLK_BACKSPACE, GameKey::UNDO},  // ← 追加: 1 手戻し
+    {SDLK_v, GameKey::VERSUS},        // ← 追加: 対戦モード
+    {SDLK_RETURN, GameKey::PAUSE}, {SDLK_ESCAPE, GameKey::QUIT},
+}};
 
 // 正方向: SDL_Keycode → GameKey
 inline std::optional<GameKey> to_game_key(SDL_Keycode code) {
@@ -54,4 +65,30 @@ inline const std::unordered_map<GameKey, SDL_Keycode> PRIMARY_SDL_KEY_FOR_GAMEKE
     return map;
 }();
 
+// ★ 追加: GameKey → input::Input のキースロット(コンパイル時に解決済み)
+//   毎フレームの判定は配列参照 + ビット検査だけになる(探索・ハッシュなし)
+inline constexpr std::array<std::size_t, kGameKeyCount> KEY_SLOTS = [] {
+    std::array<std::size_t, kGameKeyCount> slots{};
+    slots.fill(input::kNoSlot);
+    for (const auto& [sdl, key] : KEY_MAP) {
+        auto& slot = slots[static_cast<std::size_t>(key)];
+        if (slot == input::kNoSlot) slot = input::key_slot(sdl);
+    }
+    return slots;
+}();
+
+constexpr std::size_t slot_of(GameKey key) noexcept {
+    return KEY_SLOTS[static_cast<std::size_t>(key)];
+}
+
+inline bool pressed(const input::Input& in, GameKey key) noexcept {
+    return in.key_states.pressed_at(slot_of(key));
+}
+inline bool released(const input::Input& in, GameKey key) noexcept {
+    return in.key_states.released_at(slot_of(key));
+}
+inline bool held(const input::Input& in, GameKey key) noexcept {
+    return in.key_states.held_at(slot_of(key));
+}
+
 }  // namespace game_key
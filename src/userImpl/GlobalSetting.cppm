@@ -1,9 +1,24 @@
 module;
 
 #include <SDL2/SDL_ttf.h>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// CMake の TETRIS_UI_FONT_PT(アトラスの焼き込みにも渡す値)。単体で読むときの既定は 30
+#ifndef TETRIS_UI_FONT_PT
+#define TETRIS_UI_FONT_PT 30
+#endif
 
 export module GlobalSetting;
+import TextCache;
+import GlyphAtlas;
+import AssetLoader;
+import Profiler;
+
 export namespace global_setting {
 
 struct TtfFontDeleter {
@@ -16,6 +31,31 @@ struct TtfFontDeleter {
 
 // SDL_ttf フォントを参照カウント付きで共有する
 using FontPtr = std::shared_ptr<TTF_Font>;
+using AtlasPtr = std::shared_ptr<const glyph_atlas::GlyphAtlas>;
+
+// ★ 追加: UI フォントと、その焼き込み済みアトラス(ビルド時に bake_font_atlas が作る)
+inline constexpr const char* kUiFontPath = "assets/Noto_Sans_JP/static/NotoSansJP-Regular.ttf";
+inline constexpr const char* kUiAtlasPath = "assets/ui_atlas.bin";
+// UI フォントのポイント数。焼き込み済みアトラスと後から開くフォントはこの大きさで揃える
+inline constexpr int kUiFontPointSize = TETRIS_UI_FONT_PT;
+
+// 焼き込み済みアトラスを同期で読む(数 KB なので起動時に読んでよい)。なければ null
+inline AtlasPtr load_ui_atlas(const std::string& path) {
+    assets::Bytes bytes;
+    if (!assets::read_file(path, bytes)) return nullptr;
+    auto atlas = glyph_atlas::decode(bytes);
+    if (!atlas) return nullptr;
+    return std::make_shared<const glyph_atlas::GlyphAtlas>(std::move(*atlas));
+}
+
+// メモリ上の TTF を開く(SDL_ttf は読み込み元を参照し続けるので、バイト列はフォントと一緒に持つ)
+inline FontPtr open_font_from_memory(assets::Bytes&& ttf, int point_size) {
+    auto bytes = std::make_shared<const assets::Bytes>(std::move(ttf));
+    SDL_RWops* rw = SDL_RWFromConstMem(bytes->data(), static_cast<int>(bytes->size()));
+    TTF_Font* font = rw ? TTF_OpenFontRW(rw, 1, point_size) : nullptr;
+    if (!font) return nullptr;
+    return FontPtr{font, [bytes](TTF_Font* f) { TtfFontDeleter{}(f); }};
+}
 
 struct GlobalSetting {
     const int gridColumns;            // 列数
@@ -35,13 +75,34 @@ struct GlobalSetting {
     const int maxRotationLocks = 15;  // 1回の回転操作あたりの最大ロック回数
     const int nextAreaWidth = 150;    // Next表示領域幅(ピクセル)
     const int holdAreaWidth = 150;    // Hold表示領域幅(ピクセル)
+    const std::optional<std::uint32_t> seed;  // 乱数シード(指定時は決定的モード)
+    const std::string recordPath;             // 決定的モードで入力を記録するファイル(空なら無効)
+    // 描画と独立に 1 / frameRate 秒刻みで進めるか(既定 false = 従来どおり描画 1 回に実時間 dt。
+    // アプリは main.cpp で有効にしている。決定的モードでは指定によらず固定刻み)
+    const bool fixedTimestep;
+    const std::string tracePath;  // プロファイラ有効ビルドでトレース JSON を書き出す先(空なら無効)
+    const bool simulationThread;  // 固定刻みのとき、シミュレーションを描画と別スレッドで進めるか
 
-    // フォントキャッシュ
+    // フォントキャッシュ(起動直後は null。裏で読み込み終わったら Setting ごと差し替わる)
     FontPtr font;
+    // フォントが届くまで UI 文字を描く焼き込み済みアトラス(なければ null)
+    AtlasPtr ui_atlas;
+    // 裏で読み込み中のアセット(設定のコピー間で共有)
+    std::shared_ptr<assets::AssetLoader> assets;
+    // 文字列テクスチャのキャッシュ(設定のコピー間で共有。renderer/フォントが変われば作り直す)
+    std::shared_ptr<text_cache::TextCache> text_cache = std::make_shared<text_cache::TextCache>();
+    // recordPath に記録したゲーム数(再スタートごとに別ファイルへ書くため。設定のコピー間で共有)
+    std::shared_ptr<std::atomic<std::uint32_t>> recorded_games =
+        std::make_shared<std::atomic<std::uint32_t>>(0);
+    // フレームプロファイラ(有効ビルドのみ。Game 1 つにつき 1 つで、作り直した World も共有する)
+    profiler::SharedProfiler frame_profiler;
 
     // 現在の設定を取得
     GlobalSetting(int columns, int rows, int cell_w, int cell_h, int fps, double drop_rate,
-                  FontPtr font_, int canvas_w, int canvas_h)
+                  FontPtr font_, int canvas_w, int canvas_h,
+                  std::optional<std::uint32_t> seed_ = std::nullopt, std::string record_path = {},
+                  bool fixed_timestep = false, std::string trace_path = {},
+                  bool simulation_thread_ = true)
         : gridColumns(columns),
           gridRows(rows),
           cellWidth(cell_w),
@@ -52,10 +113,52 @@ struct GlobalSetting {
           dropRate(drop_rate),
           canvasWidth(canvas_w),
           canvasHeight(canvas_h),
-          font(std::move(font_)) {}
+          seed(seed_),
+          recordPath(std::move(record_path)),
+          fixedTimestep(fixed_timestep),
+          tracePath(std::move(trace_path)),
+          simulationThread(simulation_thread_),
+          font(std::move(font_)) {
+        if constexpr (profiler::kEnabled) {
+            frame_profiler = std::make_shared<profiler::FrameProfiler>(tracePath);
+        }
+    }
 
     // 必要ならアクセサ
     TTF_Font* get_font() const noexcept { return font.get(); }
+
+    // UI 文字を描けるか(フォントかアトラスのどちらかがある)
+    bool has_text() const noexcept { return text_cache && (font || ui_atlas); }
+
+    // UI 文字を描く。フォントがまだなく、アトラスが全文字を持っていればアトラスで描く
+    bool draw_text(SDL_Renderer* renderer, std::string_view text, SDL_Color color, int x,
+                   int y) const {
+        if (!text_cache) return false;
+        if (font) return text_cache->draw(renderer, font, text, color, x, y);
+        if (ui_atlas && ui_atlas->covers(text)) {
+            return text_cache->draw(renderer, ui_atlas, text, color, x, y);
+        }
+        return false;
+    }
+    bool draw_text_centered(SDL_Renderer* renderer, std::string_view text, SDL_Color color,
+                            int cx, int cy) const {
+        if (!text_cache) return false;
+        if (font) return text_cache->draw_centered(renderer, font, text, color, cx, cy);
+        if (ui_atlas && ui_atlas->covers(text)) {
+            return text_cache->draw_centered(renderer, ui_atlas, text, color, cx, cy);
+        }
+        return false;
+    }
+
+    // シミュレーションの固定刻み(秒)。0 なら描画 1 回につき実時間 dt で 1 回進める
+    //   決定的モードでは fixedTimestep の指定にかかわらず常に固定刻み
+    double fixed_step_seconds() const noexcept {
+        if (frameRate <= 0 || !(seed || fixedTimestep)) return 0.0;
+        return 1.0 / static_cast<double>(frameRate);
+    }
+
+    // Game がシミュレーションを専用スレッドで進めてよいか(固定刻みでなければ Game が使わない)
+    bool simulation_thread() const noexcept { return simulationThread; }
 };
 
 }  // namespace global_setting
@@ -0,0 +1,234 @@
+module;
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+export module GlyphAtlas;
+
+// =============================
+// 焼き込み済みグリフアトラス
+//   UI が使う文字だけを事前に 8bit のカバレッジ画像へ並べ、小さなバイナリにまとめておく
+//   (tools/bake_font_atlas.cpp がビルド時に作る)。起動直後はフォント本体(数 MB)の
+//   読み込みを待たずに、これで UI 文字を描く。
+//
+//   形式(リトルエンディアン):
+//     "TGA1" | u16 glyph_count | u16 width | u16 height | i16 line_height
+//     glyph_count × { u32 codepoint | u16 x | u16 y | u16 w | u16 h | i16 advance }
+//     width × height バイトのカバレッジ(行優先, 0 = 透明 .. 255 = 不透明)
+// =============================
+
+export namespace glyph_atlas {
+
+inline constexpr std::array<std::uint8_t, 4> kMagic{'T', 'G', 'A', '1'};
+inline constexpr std::size_t kHeaderBytes = 4 + 2 * 4;
+inline constexpr std::size_t kGlyphBytes = 4 + 2 * 5;
+
+/**
+ * @brief アトラス内の 1 文字
+ * @param x, y, w, h アトラス画像内の矩形(描画時はペン位置 + (0, 0) に w × h で置く)
+ * @param advance 次の文字までの送り幅(ピクセル)
+ */
+struct Glyph {
+    char32_t codepoint{0};
+    std::uint16_t x{0};
+    std::uint16_t y{0};
+    std::uint16_t w{0};
+    std::uint16_t h{0};
+    std::int16_t advance{0};
+};
+
+inline constexpr char32_t kReplacement = U'\uFFFD';
+
+// UTF-8 を 1 文字読み、i を次の文字へ進める(不正なバイト列は U+FFFD を返して 1 バイト進む)
+constexpr char32_t next_codepoint(std::string_view s, std::size_t& i) noexcept {
+    const auto byte = [&s](std::size_t k) { return static_cast<std::uint8_t>(s[k]); };
+    const std::uint8_t b0 = byte(i);
+    int extra = 0;
+    char32_t cp = 0;
+    if (b0 < 0x80) {
+        ++i;
+        return b0;
+    } else if ((b0 & 0xE0) == 0xC0) {
+        extra = 1;
+        cp = b0 & 0x1F;
+    } else if ((b0 & 0xF0) == 0xE0) {
+        extra = 2;
+        cp = b0 & 0x0F;
+    } else if ((b0 & 0xF8) == 0xF0) {
+        extra = 3;
+        cp = b0 & 0x07;
+    } else {
+        ++i;
+        return kReplacement;
+    }
+    if (i + static_cast<std::size_t>(extra) >= s.size()) {
+        ++i;
+        return kReplacement;
+    }
+    for (int k = 1; k <= extra; ++k) {
+        const std::uint8_t b = byte(i + static_cast<std::size_t>(k));
+        if ((b & 0xC0) != 0x80) {
+            ++i;
+            return kReplacement;
+        }
+        cp = (cp << 6) | (b & 0x3F);
+    }
+    i += static_cast<std::size_t>(extra) + 1;
+    return cp;
+}
+
+struct GlyphAtlas {
+    int width{0};
+    int height{0};
+    int line_height{0};
+    std::vector<Glyph> glyphs;           // codepoint の昇順
+    std::vector<std::uint8_t> coverage;  // width × height
+
+    [[nodiscard]] const Glyph* find(char32_t cp) const noexcept {
+        const auto it = std::lower_bound(
+            glyphs.begin(), glyphs.end(), cp,
+            [](const Glyph& g, char32_t c) { return g.codepoint < c; });
+        return (it != glyphs.end() && it->codepoint == cp) ? &*it : nullptr;
+    }
+
+    // text の全文字を持っているか
+    [[nodiscard]] bool covers(std::string_view text) const noexcept {
+        for (std::size_t i = 0; i < text.size();) {
+            if (!find(next_codepoint(text, i))) return false;
+        }
+        return true;
+    }
+
+    // text を 1 行に並べたときの幅(持っていない文字は幅 0)
+    [[nodiscard]] int measure(std::string_view text) const noexcept {
+        int w = 0;
+        for (std::size_t i = 0; i < text.size();) {
+            if (const Glyph* g = find(next_codepoint(text, i))) w += g->advance;
+        }
+        return w;
+    }
+};
+
+/**
+ * @brief ラスタライズ済みの 1 文字(焼き込みツールの入力)
+ * @param coverage w × h のカバレッジ(空白文字は w == 0 でよい)
+ */
+struct GlyphBitmap {
+    char32_t codepoint{0};
+    int w{0};
+    int h{0};
+    int advance{0};
+    std::vector<std::uint8_t> coverage;
+};
+
+// 文字画像を幅 max_width の棚に左から詰めて 1 枚にする(高さは必要な分だけ)
+inline GlyphAtlas pack(std::vector<GlyphBitmap> bitmaps, int line_height, int max_width = 256) {
+    std::sort(bitmaps.begin(), bitmaps.end(),
+              [](const GlyphBitmap& a, const GlyphBitmap& b) { return a.codepoint < b.codepoint; });
+    bitmaps.erase(std::unique(bitmaps.begin(), bitmaps.end(),
+                              [](const GlyphBitmap& a, const GlyphBitmap& b) {
+                                  return a.codepoint == b.codepoint;
+                              }),
+                  bitmaps.end());
+
+    GlyphAtlas atlas;
+    atlas.line_height = line_height;
+    atlas.glyphs.reserve(bitmaps.size());
+    int x = 0;
+    int y = 0;
+    int shelf_h = 0;
+    for (const auto& b : bitmaps) {
+        if (x + b.w > max_width && x > 0) {
+            x = 0;
+            y += shelf_h;
+            shelf_h = 0;
+        }
+        atlas.glyphs.push_back(Glyph{b.codepoint, static_cast<std::uint16_t>(x),
+                                     static_cast<std::uint16_t>(y), static_cast<std::uint16_t>(b.w),
+                                     static_cast<std::uint16_t>(b.h),
+                                     static_cast<std::int16_t>(b.advance)});
+        x += b.w;
+        shelf_h = std::max(shelf_h, b.h);
+        atlas.width = std::max(atlas.width, x);
+    }
+    atlas.height = y + shelf_h;
+
+    atlas.coverage.assign(static_cast<std::size_t>(atlas.width * atlas.height), 0);
+    for (std::size_t i = 0; i < bitmaps.size(); ++i) {
+        const auto& b = bitmaps[i];
+        const auto& g = atlas.glyphs[i];
+        for (int r = 0; r < b.h; ++r) {
+            std::copy_n(b.coverage.begin() + r * b.w, b.w,
+                        atlas.coverage.begin() + (g.y + r) * atlas.width + g.x);
+        }
+    }
+    return atlas;
+}
+
+inline std::vector<std::uint8_t> encode(const GlyphAtlas& atlas) {
+    std::vector<std::uint8_t> out;
+    out.reserve(kHeaderBytes + atlas.glyphs.size() * kGlyphBytes + atlas.coverage.size());
+    auto put = [&out](std::uint32_t v, int bytes) {
+        for (int i = 0; i < bytes; ++i) out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+    };
+    out.insert(out.end(), kMagic.begin(), kMagic.end());
+    put(static_cast<std::uint32_t>(atlas.glyphs.size()), 2);
+    put(static_cast<std::uint32_t>(atlas.width), 2);
+    put(static_cast<std::uint32_t>(atlas.height), 2);
+    put(static_cast<std::uint16_t>(atlas.line_height), 2);
+    for (const auto& g : atlas.glyphs) {
+        put(g.codepoint, 4);
+        put(g.x, 2);
+        put(g.y, 2);
+        put(g.w, 2);
+        put(g.h, 2);
+        put(static_cast<std::uint16_t>(g.advance), 2);
+    }
+    out.insert(out.end(), atlas.coverage.begin(), atlas.coverage.end());
+    return out;
+}
+
+// 壊れている(魔法数違い・長さ不足・矩形がはみ出す)ときは nullopt
+inline std::optional<GlyphAtlas> decode(std::span<const std::uint8_t> in) {
+    if (in.size() < kHeaderBytes || !std::equal(kMagic.begin(), kMagic.end(), in.begin())) {
+        return std::nullopt;
+    }
+    std::size_t pos = kMagic.size();
+    auto get = [&in, &pos](int bytes) {
+        std::uint32_t v = 0;
+        for (int i = 0; i < bytes; ++i) v |= std::uint32_t{in[pos++]} << (8 * i);
+        return v;
+    };
+
+    GlyphAtlas atlas;
+    const std::size_t count = get(2);
+    atlas.width = static_cast<int>(get(2));
+    atlas.height = static_cast<int>(get(2));
+    atlas.line_height = static_cast<std::int16_t>(get(2));
+    const std::size_t pixels = static_cast<std::size_t>(atlas.width) * atlas.height;
+    if (in.size() != kHeaderBytes + count * kGlyphBytes + pixels) return std::nullopt;
+
+    atlas.glyphs.resize(count);
+    for (auto& g : atlas.glyphs) {
+        g.codepoint = static_cast<char32_t>(get(4));
+        g.x = static_cast<std::uint16_t>(get(2));
+        g.y = static_cast<std::uint16_t>(get(2));
+        g.w = static_cast<std::uint16_t>(get(2));
+        g.h = static_cast<std::uint16_t>(get(2));
+        g.advance = static_cast<std::int16_t>(get(2));
+        if (g.x + g.w > atlas.width || g.y + g.h > atlas.height) return std::nullopt;
+    }
+    if (!std::is_sorted(atlas.glyphs.begin(), atlas.glyphs.end(),
+                        [](const Glyph& a, const Glyph& b) { return a.codepoint < b.codepoint; })) {
+        return std::nullopt;
+    }
+    atlas.coverage.assign(in.begin() + static_cast<std::ptrdiff_t>(pos), in.end());
+    return atlas;
+}
+
+}  // namespace glyph_atlas
@@ -0,0 +1,254 @@
+module;
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+export module TextCache;
+
+import SDLPtr;
+import GlyphAtlas;
+
+// =============================
+// 文字列テクスチャの LRU キャッシュ
+//   (フォント, サイズ, 色, 文字列) ごとに TTF でラスタライズしたテクスチャを保持し、
+//   毎フレームのラスタライズと GPU 転送をなくす。
+//   テクスチャは renderer に紐づくので、別の renderer で使われたら全て作り直す。
+//   ★ 追加: フォントの読み込み前は、焼き込み済みグリフアトラスから 1 文字ずつ描く
+// =============================
+
+export namespace text_cache {
+
+/**
+ * @brief キャッシュ統計
+ * @param hits キャッシュから返した回数
+ * @param misses ラスタライズした回数
+ * @param evictions 容量超過・フォント破棄で捨てた回数
+ * @param entries 現在の保持数
+ */
+struct TextCacheStats {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::uint64_t evictions{0};
+    std::size_t entries{0};
+
+    [[nodiscard]] double hit_rate() const noexcept {
+        const auto total = hits + misses;
+        return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+    }
+};
+
+// キャッシュ済みテクスチャ(次の get/draw まで有効)
+struct CachedText {
+    SDL_Texture* texture{nullptr};
+    int w{0};
+    int h{0};
+};
+
+class TextCache {
+   public:
+    explicit TextCache(std::size_t capacity = 64) : capacity_(capacity == 0 ? 1 : capacity) {}
+
+    TextCache(const TextCache&) = delete;
+    TextCache& operator=(const TextCache&) = delete;
+
+    // 文字列テクスチャを取得(なければ作る)。失敗時は texture == nullptr
+    CachedText get(SDL_Renderer* renderer, const std::shared_ptr<TTF_Font>& font,
+                   std::string_view text, SDL_Color color) {
+        if (!renderer || !font) return {};
+        if (renderer != renderer_) {
+            // renderer が変わったら、旧 renderer のテクスチャは使えない
+            clear();
+            renderer_ = renderer;
+        }
+
+        // 検索は string_view のまま行う(ヒット時は確保なし)
+        const KeyView probe{font.get(), TTF_FontHeight(font.get()), pack(color), text};
+        if (auto it = index_.find(probe); it != index_.end()) {
+            auto entry = it->second;
+            if (!entry->font.expired()) {
+                ++stats_.hits;
+                lru_.splice(lru_.begin(), lru_, entry);  // 最近使ったものを先頭へ
+                return entry->text;
+            }
+            // 同じアドレスに別のフォントが作られた: 古いエントリは無効
+            erase(entry);
+        }
+
+        ++stats_.misses;
+        Key key{probe.font, probe.size, probe.color, std::string(text)};
+        SurfacePtr surface(TTF_RenderUTF8_Blended(font.get(), key.text.c_str(), color),
+                           SDL_FreeSurface);
+        if (!surface) return {};
+        TexturePtr texture(SDL_CreateTextureFromSurface(renderer, surface.get()),
+                           SDL_DestroyTexture);
+        if (!texture) return {};
+
+        const CachedText out{texture.get(), surface->w, surface->h};
+        lru_.push_front(Entry{key, font, std::move(texture), out});
+        index_.emplace(std::move(key), lru_.begin());
+        while (lru_.size() > capacity_) erase(std::prev(lru_.end()));
+        stats_.entries = lru_.size();
+        return out;
+    }
+
+    // (x, y) を左上として描画
+    bool draw(SDL_Renderer* renderer, const std::shared_ptr<TTF_Font>& font,
+              std::string_view text, SDL_Color color, int x, int y) {
+        const CachedText t = get(renderer, font, text, color);
+        if (!t.texture) return false;
+        SDL_Rect dst{x, y, t.w, t.h};
+        return SDL_RenderCopy(renderer, t.texture, nullptr, &dst) == 0;
+    }
+
+    // (cx, cy) を中心として描画
+    bool draw_centered(SDL_Renderer* renderer, const std::shared_ptr<TTF_Font>& font,
+                       std::string_view text, SDL_Color color, int cx, int cy) {
+        const CachedText t = get(renderer, font, text, color);
+        if (!t.texture) return false;
+        SDL_Rect dst{cx - t.w / 2, cy - t.h / 2, t.w, t.h};
+        return SDL_RenderCopy(renderer, t.texture, nullptr, &dst) == 0;
+    }
+
+    // アトラスの文字で (x, y) を左上として描画(アトラスにない文字は飛ばす)
+    bool draw(SDL_Renderer* renderer, const std::shared_ptr<const glyph_atlas::GlyphAtlas>& atlas,
+              std::string_view text, SDL_Color color, int x, int y) {
+        SDL_Texture* texture = atlas_texture(renderer, atlas);
+        if (!texture) return false;
+        SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+        SDL_SetTextureAlphaMod(texture, color.a);
+        bool ok = true;
+        for (std::size_t i = 0; i < text.size();) {
+            const glyph_atlas::Glyph* g = atlas->find(glyph_atlas::next_codepoint(text, i));
+            if (!g) continue;
+            if (g->w > 0 && g->h > 0) {
+                const SDL_Rect src{g->x, g->y, g->w, g->h};
+                const SDL_Rect dst{x, y, g->w, g->h};
+                ok = SDL_RenderCopy(renderer, texture, &src, &dst) == 0 && ok;
+            }
+            x += g->advance;
+        }
+        return ok;
+    }
+
+    // アトラスの文字で (cx, cy) を中心として描画
+    bool draw_centered(SDL_Renderer* renderer,
+                       const std::shared_ptr<const glyph_atlas::GlyphAtlas>& atlas,
+                       std::string_view text, SDL_Color color, int cx, int cy) {
+        if (!atlas) return false;
+        return draw(renderer, atlas, text, color, cx - atlas->measure(text) / 2,
+                    cy - atlas->line_height / 2);
+    }
+
+    // 全テクスチャを破棄する(SDL_RENDER_TARGETS_RESET / DEVICE_RESET 後などに呼ぶ)
+    void clear() noexcept {
+        stats_.evictions += lru_.size();
+        index_.clear();
+        lru_.clear();
+        stats_.entries = 0;
+        atlas_.reset();
+        atlas_texture_.reset();
+    }
+
+    [[nodiscard]] const TextCacheStats& stats() const noexcept { return stats_; }
+
+   private:
+    struct KeyView {
+        const TTF_Font* font;
+        int size;  // TTF_FontHeight(フォントのサイズ変更も別キーになる)
+        std::uint32_t color;
+        std::string_view text;
+        bool operator==(const KeyView&) const = default;
+    };
+    struct Key {
+        const TTF_Font* font;
+        int size;
+        std::uint32_t color;
+        std::string text;
+        operator KeyView() const noexcept { return KeyView{font, size, color, text}; }
+    };
+    // string_view での検索を許す透過的なハッシュ/比較
+    struct KeyHash {
+        using is_transparent = void;
+        std::size_t operator()(const KeyView& k) const noexcept {
+            std::size_t h = std::hash<std::string_view>{}(k.text);
+            auto mix = [&h](std::size_t v) {
+                h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+            };
+            mix(std::hash<const void*>{}(k.font));
+            mix(static_cast<std::size_t>(k.size));
+            mix(k.color);
+            return h;
+        }
+        std::size_t operator()(const Key& k) const noexcept { return (*this)(KeyView(k)); }
+    };
+    struct KeyEq {
+        using is_transparent = void;
+        bool operator()(const KeyView& a, const KeyView& b) const noexcept { return a == b; }
+    };
+    struct Entry {
+        Key key;
+        std::weak_ptr<TTF_Font> font;  // フォントが破棄されたらエントリも無効
+        TexturePtr texture;
+        CachedText text;
+    };
+    using List = std::list<Entry>;
+
+    std::size_t capacity_;
+    SDL_Renderer* renderer_{nullptr};
+    List lru_;  // 先頭が最近使ったもの
+    std::unordered_map<Key, List::iterator, KeyHash, KeyEq> index_;
+    TextCacheStats stats_;
+    // アトラスのテクスチャ(白 + カバレッジのアルファ。色は描画時に乗算する)
+    std::weak_ptr<const glyph_atlas::GlyphAtlas> atlas_;
+    TexturePtr atlas_texture_{nullptr, SDL_DestroyTexture};
+
+    static std::uint32_t pack(SDL_Color c) noexcept {
+        return (std::uint32_t{c.r} << 24) | (std::uint32_t{c.g} << 16) |
+               (std::uint32_t{c.b} << 8) | std::uint32_t{c.a};
+    }
+
+    SDL_Texture* atlas_texture(SDL_Renderer* renderer,
+                               const std::shared_ptr<const glyph_atlas::GlyphAtlas>& atlas) {
+        if (!renderer || !atlas || atlas->width <= 0 || atlas->height <= 0) return nullptr;
+        if (renderer != renderer_) {
+            clear();
+            renderer_ = renderer;
+        }
+        if (atlas_texture_ && atlas_.lock() == atlas) return atlas_texture_.get();
+
+        SurfacePtr surface(SDL_CreateRGBSurfaceWithFormat(0, atlas->width, atlas->height, 32,
+                                                          SDL_PIXELFORMAT_ARGB8888),
+                           SDL_FreeSurface);
+        if (!surface) return nullptr;
+        auto* pixels = static_cast<std::uint8_t*>(surface->pixels);
+        for (int r = 0; r < atlas->height; ++r) {
+            auto* row = reinterpret_cast<std::uint32_t*>(pixels + r * surface->pitch);
+            const std::uint8_t* cov = atlas->coverage.data() + r * atlas->width;
+            for (int c = 0; c < atlas->width; ++c) {
+                row[c] = (std::uint32_t{cov[c]} << 24) | 0x00FFFFFFu;
+            }
+        }
+        atlas_texture_.reset(SDL_CreateTextureFromSurface(renderer, surface.get()));
+        if (!atlas_texture_) return nullptr;
+        SDL_SetTextureBlendMode(atlas_texture_.get(), SDL_BLENDMODE_BLEND);
+        atlas_ = atlas;
+        return atlas_texture_.get();
+    }
+
+    void erase(List::iterator it) {
+        index_.erase(it->key);
+        lru_.erase(it);
+        ++stats_.evictions;
+        stats_.entries = lru_.size();
+    }
+};
+
+}  // namespace text_cache
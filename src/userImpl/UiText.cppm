@@ -0,0 +1,26 @@
+module;
+#include <array>
+#include <string_view>
+
+export module UiText;
+
+// =============================
+// UI に出す文字列の一覧
+//   焼き込みツール(tools/bake_font_atlas.cpp)はここに並んだ文字だけをアトラスへ焼くので、
+//   画面に文字列を足すときは必ずここへ追加する
+// =============================
+
+export namespace ui_text {
+
+inline constexpr std::string_view kTitle = "TETRIS";
+inline constexpr std::string_view kPressStart = "Press ENTER to Start";
+inline constexpr std::string_view kPressVersus = "V: Versus CPU";
+inline constexpr std::string_view kGameOver = "Game Over";
+inline constexpr std::string_view kYouWin = "You Win";
+inline constexpr std::string_view kHold = "HOLD";
+inline constexpr std::string_view kNext = "NEXT";
+
+inline constexpr std::array<std::string_view, 7> kAll{
+    kTitle, kPressStart, kPressVersus, kGameOver, kYouWin, kHold, kNext};
+
+}  // namespace ui_text
@@ -2,24 +2,60 @@
 // File: MyScenes-Core.ixx (exported module partition)
 // ===========================
 module;
+#include <cstddef>
+#include <cstdint>
 #include <entt/entt.hpp>
+#include <memory>
 #include <variant>
+#include <vector>
 
 export module MyScenes:Core;  // パーティション名
 
 import GlobalSetting;
 import TetrisRule;
+import Versus;
+import ThreadPool;
 
 export namespace my_scenes {
 
+// 対戦モードの人数(人 1 + CPU)
+inline constexpr std::size_t kVersusPlayers = 4;
+
 // シーン純粋データ(World を抱えるだけ)
 struct GameSceneData {
     tetris_rule::World world;
+    // ★ 追加: 練習モードの 1 手戻し。ピースが出るたびにその時点の状態を記録する
+    std::shared_ptr<tetris_rule::UndoHistory> history;
+};
+
+// ★ 追加: 対戦モード(試合とワーカーは可変なので共有で持つ)
+struct VersusSceneData {
+    std::shared_ptr<versus::Match> match;
+    std::shared_ptr<WorkStealingPool> pool;
 };
 
 struct InitialSceneData {};
-struct GameOverSceneData {};
+struct GameOverSceneData {
+    bool won{false};  // 対戦で最後まで残った
+};
+
+using Scene = std::variant<GameSceneData, InitialSceneData, GameOverSceneData, VersusSceneData>;
 
-using Scene = std::variant<GameSceneData, InitialSceneData, GameOverSceneData>;
+// ★ 追加: 描画用の写し(シミュレーション側がステップの後に書き、描画側はこれだけを読む)
+//   シーンの種類ごとに使うメンバが違う。種類が変わってもバッファは捨てずに使い回す
+enum class SceneKind : std::uint8_t { Initial, Game, GameOver, Versus };
+
+struct SceneSnapshot {
+    SceneKind kind{SceneKind::Initial};
+    tetris_rule::RenderSnapshot board;  // Game
+    versus::MatchSnapshot match;        // Versus
+    bool won{false};                    // GameOver
+};
+
+// 描画側だけが持つ状態(盤面の頂点キャッシュ)
+struct SceneRenderState {
+    tetris_rule::BoardRenderCache board;
+    std::vector<tetris_rule::BoardRenderCache> match;
+};
 
 }  // namespace my_scenes
@@ -0,0 +1,361 @@
+module;
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+export module Bitboard;
+
+import Tetrimino;
+
+// =============================
+// 盤面ビットボード
+//   1 行を 1 つの整数ビットマスクで表す(bit c = 列 c)。
+//   配置判定はシフト＋AND、行の満杯判定は 1 回の比較で済む。
+//   ★ 追加: 列ごとの最上段(埋まっている最小の行)を書き込みのたびに差分更新し、
+//          落下距離(ゴースト・ハードドロップ)を盤面の高さによらず定数時間で求める。
+// =============================
+
+// 盤面占有
+export enum class CellStatus : std::uint8_t { Empty, Filled };
+
+// 1 行分のビットマスク(列数は最大 64)
+export using RowMask = std::uint64_t;
+export inline constexpr int kMaxBoardColumns = 64;
+
+/**
+ * @brief テトリミノ 1 向き分の占有マスク
+ * @param rows 4x4 ローカル行ごとのビット(bit cc = ローカル列 cc)
+ * @param min_row/max_row 占有している最小/最大ローカル行
+ * @param min_col/max_col 占有している最小/最大ローカル列
+ * @param col_bottom ローカル列ごとの最下段のローカル行(その列にセルがなければ -1)
+ */
+export struct PieceMask {
+    std::array<RowMask, 4> rows{};
+    int min_row{4};
+    int max_row{-1};
+    int min_col{4};
+    int max_col{-1};
+    std::array<int, 4> col_bottom{-1, -1, -1, -1};
+};
+
+constexpr PieceMask make_piece_mask(PieceType type, PieceDirection dir) noexcept {
+    PieceMask m{};
+    for (auto [rr, cc] : cells_for(type, dir)) {
+        m.rows[rr] |= RowMask{1} << cc;
+        if (rr < m.min_row) m.min_row = rr;
+        if (rr > m.max_row) m.max_row = rr;
+        if (cc < m.min_col) m.min_col = cc;
+        if (cc > m.max_col) m.max_col = cc;
+        if (rr > m.col_bottom[cc]) m.col_bottom[cc] = rr;
+    }
+    return m;
+}
+
+// [PieceType][PieceDirection] のマスク表(コンパイル時に cells_for から生成)
+inline constexpr auto kPieceMasks = [] {
+    std::array<std::array<PieceMask, kDirectionCount>, kPieceTypeCount> table{};
+    for (std::size_t t = 0; t < kPieceTypeCount; ++t) {
+        for (std::size_t d = 0; d < kDirectionCount; ++d) {
+            table[t][d] =
+                make_piece_mask(static_cast<PieceType>(t), static_cast<PieceDirection>(d));
+        }
+    }
+    return table;
+}();
+
+export constexpr const PieceMask& piece_mask(PieceType type, PieceDirection dir) noexcept {
+    return kPieceMasks[static_cast<std::size_t>(type)][static_cast<std::size_t>(dir)];
+}
+
+/**
+ * @brief 行ビットマスクの盤面
+ *
+ * 高速経路は test/fits/stamp/row_full などのビット演算 API を使う。
+ * 互換のため occ[row * cols + col] 形式の CellStatus アクセスと反復も提供する。
+ */
+export class BitBoard {
+   public:
+    class iterator;
+
+    // --- CellStatus 互換の要素参照(書き込み可能なプロキシ) ---
+    class CellRef {
+       public:
+        CellRef(BitBoard* board, int idx) noexcept : board_(board), idx_(idx) {}
+        CellRef(const CellRef&) = default;
+
+        CellRef& operator=(CellStatus s) noexcept {
+            board_->assign(idx_, s);
+            return *this;
+        }
+        CellRef& operator=(const CellRef& other) noexcept {
+            return *this = static_cast<CellStatus>(other);
+        }
+        operator CellStatus() const noexcept { return board_->at(idx_); }
+        friend bool operator==(const CellRef& a, CellStatus b) noexcept {
+            return static_cast<CellStatus>(a) == b;
+        }
+
+       private:
+        friend class BitBoard::iterator;
+        BitBoard* board_;
+        int idx_;
+    };
+
+    // 非 const 反復子: 反復子内に保持したプロキシへの参照を返す(range-for の auto& 用)
+    class iterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = CellStatus;
+        using difference_type = std::ptrdiff_t;
+        using reference = CellRef&;
+        using pointer = void;
+
+        iterator(BitBoard* board, int idx) noexcept : ref_(board, idx) {}
+        CellRef& operator*() const noexcept { return ref_; }
+        iterator& operator++() noexcept {
+            ++ref_.idx_;
+            return *this;
+        }
+        void operator++(int) noexcept { ++ref_.idx_; }
+        bool operator==(const iterator& other) const noexcept {
+            return ref_.idx_ == other.ref_.idx_;
+        }
+
+       private:
+        mutable CellRef ref_;
+    };
+
+    class const_iterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = CellStatus;
+        using difference_type = std::ptrdiff_t;
+        using reference = CellStatus;
+        using pointer = void;
+
+        const_iterator(const BitBoard* board, int idx) noexcept : board_(board), idx_(idx) {}
+        CellStatus operator*() const noexcept { return board_->at(idx_); }
+        const_iterator& operator++() noexcept {
+            ++idx_;
+            return *this;
+        }
+        const_iterator operator++(int) noexcept {
+            auto prev = *this;
+            ++idx_;
+            return prev;
+        }
+        friend bool operator==(const const_iterator& a, const const_iterator& b) noexcept {
+            return a.idx_ == b.idx_;
+        }
+
+       private:
+        const BitBoard* board_;
+        int idx_;
+    };
+
+    BitBoard() = default;
+
+    // 盤面サイズを設定して全セルを空にする(cols は kMaxBoardColumns 以下)
+    void reset(int rows, int cols) {
+        rows_ = rows;
+        cols_ = cols;
+        full_mask_ = (cols >= kMaxBoardColumns) ? ~RowMask{0} : ((RowMask{1} << cols) - 1);
+        bits_.assign(static_cast<std::size_t>(rows), RowMask{0});
+        top_.assign(static_cast<std::size_t>(cols), rows);
+    }
+
+    [[nodiscard]] int rows() const noexcept { return rows_; }
+    [[nodiscard]] int cols() const noexcept { return cols_; }
+    [[nodiscard]] RowMask full_mask() const noexcept { return full_mask_; }
+
+    // --- 行単位 ---
+    [[nodiscard]] RowMask row_bits(int row) const noexcept {
+        return bits_[static_cast<std::size_t>(row)];
+    }
+    [[nodiscard]] bool row_full(int row) const noexcept { return row_bits(row) == full_mask_; }
+    [[nodiscard]] bool row_empty(int row) const noexcept { return row_bits(row) == 0; }
+    void set_row_bits(int row, RowMask bits) noexcept {
+        bits &= full_mask_;
+        const RowMask old = row_bits(row);
+        bits_[static_cast<std::size_t>(row)] = bits;
+        raise_tops(row, bits & ~old);
+        lower_tops(row, old & ~bits);
+    }
+
+    // 指定行(降順)を取り除き、残りの行を下へ詰める。上端は空行で埋める
+    void remove_rows(std::span<const int> rows_desc) {
+        std::size_t k = 0;
+        int write = rows_ - 1;
+        for (int r = rows_ - 1; r >= 0; --r) {
+            if (k < rows_desc.size() && rows_desc[k] == r) {
+                ++k;
+                continue;
+            }
+            bits_[static_cast<std::size_t>(write)] = bits_[static_cast<std::size_t>(r)];
+            --write;
+        }
+        for (; write >= 0; --write) bits_[static_cast<std::size_t>(write)] = 0;
+        recompute_tops();
+    }
+
+    // ★ 追加: 全体を rows_bottom.size() 行せり上げ、空いた下端へ rows_bottom(上から順)を入れる
+    //   上端から押し出された行に 1 つでもブロックがあれば false(呼び出し側で窒息扱いにする)
+    bool push_rows_bottom(std::span<const RowMask> rows_bottom) {
+        const int n = std::min(static_cast<int>(rows_bottom.size()), rows_);
+        bool kept = true;
+        for (int r = 0; r < n; ++r) kept = kept && row_empty(r);
+        std::copy(bits_.begin() + n, bits_.end(), bits_.begin());
+        for (int i = 0; i < n; ++i) {
+            bits_[static_cast<std::size_t>(rows_ - n + i)] =
+                rows_bottom[rows_bottom.size() - static_cast<std::size_t>(n - i)] & full_mask_;
+        }
+        recompute_tops();
+        return kept;
+    }
+
+    // --- セル単位 ---
+    [[nodiscard]] bool test(int row, int col) const noexcept {
+        return (row_bits(row) >> col) & RowMask{1};
+    }
+    void set(int row, int col) noexcept {
+        bits_[static_cast<std::size_t>(row)] |= RowMask{1} << col;
+        if (row < top_[static_cast<std::size_t>(col)]) top_[static_cast<std::size_t>(col)] = row;
+    }
+    void reset_cell(int row, int col) noexcept {
+        const RowMask bit = RowMask{1} << col;
+        const RowMask old = row_bits(row);
+        bits_[static_cast<std::size_t>(row)] = old & ~bit;
+        lower_tops(row, old & bit);
+    }
+
+    // --- 列単位 ---
+
+    // 列 col で埋まっている最上段の行(空の列は rows())。O(1)
+    [[nodiscard]] int column_top(int col) const noexcept {
+        return top_[static_cast<std::size_t>(col)];
+    }
+
+    // --- テトリミノ単位 ---
+
+    // (row, col) を 4x4 ローカル原点としてマスクを置けるか(盤面外・既存ブロックと重なれば不可)
+    [[nodiscard]] bool fits(const PieceMask& m, int row, int col) const noexcept {
+        if (row + m.min_row < 0 || row + m.max_row >= rows_) return false;
+        if (col + m.min_col < 0 || col + m.max_col >= cols_) return false;
+        for (int rr = m.min_row; rr <= m.max_row; ++rr) {
+            if (row_bits(row + rr) & shift_to(m.rows[rr], col)) return false;
+        }
+        return true;
+    }
+
+    // マスクを書き込む(盤面外にはみ出した行は捨てる)
+    void stamp(const PieceMask& m, int row, int col) noexcept {
+        for (int rr = m.min_row; rr <= m.max_row; ++rr) {
+            const int r = row + rr;
+            if (r < 0 || r >= rows_) continue;
+            const RowMask add = shift_to(m.rows[rr], col) & full_mask_;
+            bits_[static_cast<std::size_t>(r)] |= add;
+            raise_tops(r, add);
+        }
+    }
+
+    // (row, col) に置いたマスクを真下へ何行落とせるか
+    //   各列の「ピースの最下セル」と「列の最上段」の差の最小値で求める(定数時間)。
+    //   ピースのどこかの列で最上段がピースの最下セル以上にある(張り出しの下に潜っている／
+    //   重なっている)場合だけ、1 行ずつ fits で確かめる遅い経路に落とす。
+    [[nodiscard]] int drop_distance(const PieceMask& m, int row, int col) const noexcept {
+        if (col + m.min_col < 0 || col + m.max_col >= cols_) return drop_distance_slow(m, row, col);
+        int best = rows_;
+        for (int cc = m.min_col; cc <= m.max_col; ++cc) {
+            const int bottom = m.col_bottom[static_cast<std::size_t>(cc)];
+            if (bottom < 0) continue;
+            const int piece_row = row + bottom;
+            const int top = column_top(col + cc);
+            if (top <= piece_row) return drop_distance_slow(m, row, col);
+            best = std::min(best, top - 1 - piece_row);
+        }
+        return best;
+    }
+
+    // drop_distance の遅い経路(従来の 1 行ずつの探索)。検証用にも公開する
+    [[nodiscard]] int drop_distance_slow(const PieceMask& m, int row, int col) const noexcept {
+        int d = 0;
+        while (fits(m, row + d + 1, col)) ++d;
+        return d;
+    }
+
+    // --- CellStatus 互換アクセス(idx = row * cols + col) ---
+    [[nodiscard]] std::size_t size() const noexcept {
+        return static_cast<std::size_t>(rows_) * static_cast<std::size_t>(cols_);
+    }
+    [[nodiscard]] CellStatus operator[](int idx) const noexcept { return at(idx); }
+    [[nodiscard]] CellRef operator[](int idx) noexcept { return CellRef{this, idx}; }
+
+    [[nodiscard]] iterator begin() noexcept { return iterator{this, 0}; }
+    [[nodiscard]] iterator end() noexcept { return iterator{this, static_cast<int>(size())}; }
+    [[nodiscard]] const_iterator begin() const noexcept { return const_iterator{this, 0}; }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator{this, static_cast<int>(size())};
+    }
+
+   private:
+    int rows_{0};
+    int cols_{0};
+    RowMask full_mask_{0};
+    std::vector<RowMask> bits_;  // bits_[row] の bit c が列 c
+    std::vector<int> top_;       // top_[c] = 列 c で埋まっている最小の行(空なら rows_)
+
+    // 行 row に added のビットが立った: それより下が最上段だった列を引き上げる
+    void raise_tops(int row, RowMask added) noexcept {
+        for (; added; added &= added - 1) {
+            auto& top = top_[static_cast<std::size_t>(std::countr_zero(added))];
+            if (row < top) top = row;
+        }
+    }
+
+    // 行 row から removed のビットが消えた: 最上段がその行だった列だけ、下を探し直す
+    void lower_tops(int row, RowMask removed) noexcept {
+        RowMask lost = 0;
+        for (; removed; removed &= removed - 1) {
+            const int c = std::countr_zero(removed);
+            if (top_[static_cast<std::size_t>(c)] == row) lost |= RowMask{1} << c;
+        }
+        for (int r = row + 1; lost && r < rows_; ++r) {
+            RowMask hit = row_bits(r) & lost;
+            lost &= ~hit;
+            for (; hit; hit &= hit - 1) top_[static_cast<std::size_t>(std::countr_zero(hit))] = r;
+        }
+        for (; lost; lost &= lost - 1) {
+            top_[static_cast<std::size_t>(std::countr_zero(lost))] = rows_;
+        }
+    }
+
+    // 全列の最上段を上から 1 回の走査で作り直す(行の削除・詰め直し後)
+    void recompute_tops() noexcept {
+        std::fill(top_.begin(), top_.end(), rows_);
+        RowMask unseen = full_mask_;
+        for (int r = 0; unseen && r < rows_; ++r) {
+            RowMask hit = row_bits(r) & unseen;
+            unseen &= ~hit;
+            for (; hit; hit &= hit - 1) top_[static_cast<std::size_t>(std::countr_zero(hit))] = r;
+        }
+    }
+
+    static constexpr RowMask shift_to(RowMask local, int col) noexcept {
+        return col >= 0 ? (local << col) : (local >> -col);
+    }
+
+    [[nodiscard]] CellStatus at(int idx) const noexcept {
+        return test(idx / cols_, idx % cols_) ? CellStatus::Filled : CellStatus::Empty;
+    }
+    void assign(int idx, CellStatus s) noexcept {
+        if (s == CellStatus::Filled) {
+            set(idx / cols_, idx % cols_);
+        } else {
+            reset_cell(idx / cols_, idx % cols_);
+        }
+    }
+};
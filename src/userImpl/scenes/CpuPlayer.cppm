@@ -0,0 +1,126 @@
+module;
+#include <SDL2/SDL_keycode.h>
+#include <optional>
+
+export module CpuPlayer;
+
+import GlobalSetting;
+import SceneFramework;
+import Input;
+import GameKey;
+import Tetrimino;
+import PlacementSearch;
+import TetrisRule;
+
+// =============================
+// CPU プレイヤー
+//   配置探索(PlacementSearch)で選んだ配置へ、キー入力だけでピースを運ぶボット。
+//   人と同じ input::Input を作って step_world に渡すので、ルール側は CPU を区別しない。
+//   押したキーは次のフレームで離す(1 キー = 2 フレーム)。
+// =============================
+
+export namespace cpu_player {
+
+using game_key::GameKey;
+using global_setting::GlobalSetting;
+
+/**
+ * @brief CPU 1 人分の状態
+ * @param input このボットが作る入力(step_world へ渡す)
+ * @param depth 探索で読む手数
+ * @param delay_frames キーを押してから次のキーを考えるまでに空けるフレーム数(強さの調整)
+ */
+struct CpuPlayer {
+    input::Input input;
+    int depth{1};
+    int delay_frames{0};
+
+    std::optional<SDL_Keycode> tapped;           // 前フレームで押したキー(このフレームで離す)
+    std::optional<placement::Placement> target;  // いま運んでいる配置
+    int target_taps{0};                          // target へ向けて押した回数
+    int wait{0};                                 // 次のキーまで待つ残りフレーム
+
+    // 入力と運搬中の状態を捨てる(World を作り直したとき)
+    void reset() {
+        input = input::Input{};
+        tapped.reset();
+        target.reset();
+        target_taps = 0;
+        wait = 0;
+    }
+};
+
+// CPU が配置を探すときの設定
+//   下入れやひねり込みは打てないので、回転 → 左右 → ハードドロップで届く配置だけを読む
+inline placement::SearchOptions search_options(const CpuPlayer& p) {
+    placement::SearchOptions opt{};
+    opt.depth = p.depth;
+    opt.hard_drop_only = true;
+    return opt;
+}
+
+// 探索した配置へ 1 フレーム 1 キーずつ運ぶ(ホールド → 回転 → 左右 → ハードドロップ)
+//   探索は同じ運び方で届く配置しか返さない。それでも蹴りや壁で向き・列が揃わないまま
+//   kMaxTaps 回押したら、その場で落として次へ進む
+inline std::optional<GameKey> search_key(CpuPlayer& p, const tetris_rule::World& world,
+                                         const scene_fw::Env<GlobalSetting>& env) {
+    constexpr int kMaxTaps = placement::kMaxHardDropMoves;
+    if (!p.target) {
+        const auto plan = tetris_rule::plan_placement(world, env, search_options(p));
+        if (!plan) return std::nullopt;
+        p.target = plan->first;
+        p.target_taps = 0;
+    }
+    if (p.target->used_hold) {
+        p.target.reset();  // 入れ替わったピースで探し直す
+        return GameKey::HOLD;
+    }
+    const auto cur = tetris_rule::active_piece_state(world);
+    if (!cur) return std::nullopt;
+
+    const placement::PieceState& goal = p.target->piece;
+    if (p.target_taps < kMaxTaps && cur->dir != goal.dir) {
+        ++p.target_taps;
+        return rotated_direction(cur->dir, -1) == goal.dir ? GameKey::ROTATE_LEFT
+                                                           : GameKey::ROTATE_RIGHT;
+    }
+    if (p.target_taps < kMaxTaps && cur->col != goal.col) {
+        ++p.target_taps;
+        return cur->col < goal.col ? GameKey::RIGHT : GameKey::LEFT;
+    }
+    p.target.reset();
+    return GameKey::DROP;
+}
+
+// このフレームの入力を作る: 前フレームに押したキーがあれば離すだけ、なければ choose() を押す
+//   choose は std::optional<GameKey>() を返す関数(nullopt なら何も押さない)
+template <class Choose>
+void drive(CpuPlayer& p, Choose&& choose) {
+    const input::KeyStates prev = p.input.key_states;
+    p.input.key_states.begin_frame(prev);
+    if (p.tapped) {
+        p.input.key_states.key_up(*p.tapped);
+        p.tapped.reset();
+    } else if (const std::optional<GameKey> key = choose()) {
+        const SDL_Keycode code = *game_key::to_sdl_key(*key);
+        p.input.key_states.key_down(code);
+        p.tapped = code;
+    }
+    p.input.key_states.end_frame(prev);
+}
+
+// 探索ボットとして 1 フレーム分の入力を作る(delay_frames ごとに 1 キー)
+inline void think(CpuPlayer& p, const tetris_rule::World& world,
+                  const scene_fw::Env<GlobalSetting>& env) {
+    drive(p, [&]() -> std::optional<GameKey> {
+        if (p.wait > 0) {
+            --p.wait;
+            return std::nullopt;
+        }
+        const auto key = search_key(p, world, env);
+        if (key) p.wait = p.delay_frames;
+        return key;
+    });
+}
+
+}  // namespace cpu_player
@@ -14,17 +14,20 @@ import Input;
 import GameKey;
 import :Core;
 import :GameScene;  // make_initial を呼ぶため
-import SDLPtr;
+import :Versus;
+import UiText;
 
 export namespace my_scenes {
 
 using scene_fw::Env;
 
 inline Scene update(const GameOverSceneData& s, const Env<global_setting::GlobalSetting>& env) {
-    const auto key = game_key::to_sdl_key(game_key::GameKey::PAUSE);
-    if (env.input.pressed(*key)) {
+    if (game_key::pressed(env.input, game_key::GameKey::PAUSE)) {
         if (auto initial = my_scenes::create_game_scene(env)) return initial.value();
     }
+    if (game_key::pressed(env.input, game_key::GameKey::VERSUS)) {
+        if (auto versus_scene = my_scenes::create_versus_scene(env)) return versus_scene.value();
+    }
     return Scene{s};
 }
 
@@ -35,37 +38,24 @@ inline void render(const GameOverSceneData& s, SDL_Renderer* const renderer,
     SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    // キャッシュしているフォントを取得
+    // キャッシュしているフォントと文字列テクスチャを使う(フォントの読み込み前はアトラス)
     const auto& setting = env.setting;
-    if (setting.font) {
-        constexpr const char* text = "Game Over";
-
+    if (setting.has_text()) {
         // 文字色(ここでは白)
-        SDL_Color color{255, 255, 255, 255};
-
-        // UTF-8 文字列としてレンダリング
-        SurfacePtr surface(TTF_RenderUTF8_Blended(setting.font.get(), text, color),
-                           SDL_FreeSurface);
-        if (surface) {
-            TexturePtr texture(SDL_CreateTextureFromSurface(renderer, surface.get()),
-                               SDL_DestroyTexture);
-            if (texture) {
-                int tex_w = 0;
-                int tex_h = 0;
-                SDL_QueryTexture(texture.get(), nullptr, nullptr, &tex_w, &tex_h);
-                // 画面中央に配置
-                SDL_Rect dst{};
-                dst.w = tex_w;
-                dst.h = tex_h;
-                dst.x = (setting.canvasWidth - tex_w) / 2;
-                dst.y = (setting.canvasHeight - tex_h) / 2;
+        constexpr SDL_Color color{255, 255, 255, 255};
 
-                SDL_RenderCopy(renderer, texture.get(), nullptr, &dst);
-            }
-        }
+        // 画面中央に配置
+        setting.draw_text_centered(renderer, s.won ? ui_text::kYouWin : ui_text::kGameOver, color,
+                                   setting.canvasWidth / 2, setting.canvasHeight / 2);
     }
 
     SDL_RenderPresent(renderer);
 }
 
+// 描画用の写し
+inline void capture(const GameOverSceneData& s, SceneSnapshot& out) {
+    out.kind = SceneKind::GameOver;
+    out.won = s.won;
+}
+
 }  // namespace my_scenes
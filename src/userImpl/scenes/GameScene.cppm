@@ -4,6 +4,8 @@
 // ===========================
 module;
 #include <SDL2/SDL.h>
+#include <entt/entt.hpp>
+#include <memory>
 #include <tl/expected.hpp>
 
 export module MyScenes:GameScene;  // パーティション名
@@ -30,6 +32,9 @@ inline tl::expected<Scene, std::string> create_game_scene(
     }
     s.world = world.value();
 
+    s.history = std::make_shared<tetris_rule::UndoHistory>(
+        s.world, tetris_rule::kUndoDepth, env.setting.gridRows, env.setting.gridColumns);
+
     return Scene{s};
 }
 
@@ -43,7 +48,13 @@ inline Scene update(const GameSceneData& s, const Env<global_setting::GlobalSett
     // }
 
     GameSceneData u = s;
-    tetris_rule::step_world(u.world, env);
+
+    // ★ 追加: UNDO のフレームは直前のピースの出現時点へ戻す(replay も同じ UndoHistory で再生する)
+    if (u.history) {
+        if (u.history->step(u.world, env)) return Scene{std::move(u)};
+    } else {
+        tetris_rule::step_world(u.world, env);
+    }
     if (tetris_rule::is_gameover(u.world)) {
         GameOverSceneData next{};
         return Scene{next};
@@ -57,4 +68,10 @@ inline void render(const GameSceneData& s, SDL_Renderer* const renderer,
     tetris_rule::render_world(s.world, renderer, env);
 }
 
+// 描画用の写し
+inline void capture(const GameSceneData& s, SceneSnapshot& out) {
+    out.kind = SceneKind::Game;
+    tetris_rule::capture_render_snapshot(s.world, out.board);
+}
+
 }  // namespace my_scenes
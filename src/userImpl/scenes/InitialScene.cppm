@@ -4,13 +4,14 @@ module;
 #include <tl/expected.hpp>
 
 export module MyScenes:Initial;  // パーティション名
-import SDLPtr;
 import SceneFramework;
 import GlobalSetting;
+import UiText;
 import Input;
 import GameKey;
 import :Core;
 import :GameScene;
+import :Versus;
 
 export namespace my_scenes {
 
@@ -25,14 +26,21 @@ inline tl::expected<Scene, std::string> create_first_scene(
 
 // --- Next / Third は従来通り最小 ---
 inline Scene update(const InitialSceneData& s, const Env<global_setting::GlobalSetting>& env) {
-    const auto key = game_key::to_sdl_key(game_key::GameKey::PAUSE);
-    if (env.input.pressed(*key)) {
+    if (game_key::pressed(env.input, game_key::GameKey::PAUSE)) {
         const auto game_scene = my_scenes::create_game_scene(env);
         if (!game_scene) {
             return s;
         }
         return game_scene.value();
     }
+    if (game_key::pressed(env.input, game_key::GameKey::VERSUS)) {
+        auto versus_scene = my_scenes::create_versus_scene(env);
+        if (!versus_scene) {
+            SDL_Log("Versus start failed: %s", versus_scene.error().c_str());
+            return s;
+        }
+        return versus_scene.value();
+    }
     return Scene{s};
 }
 
@@ -44,59 +52,29 @@ inline void render(const InitialSceneData&, SDL_Renderer* const renderer,
     SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    // キャッシュしているフォントを取得
+    // キャッシュしているフォントと文字列テクスチャを使う(フォントの読み込み前はアトラス)
     const auto& setting = env.setting;
-    if (setting.font) {
-        constexpr const char* text = "TETRIS";
-        constexpr const char* subtext = "Press ENTER to Start";
-
+    if (setting.has_text()) {
         // 文字色(ここでは黒)
-        SDL_Color color{0, 0, 0, 255};
+        constexpr SDL_Color color{0, 0, 0, 255};
 
-        // UTF-8 文字列としてレンダリング
-        SurfacePtr surface(TTF_RenderUTF8_Blended(setting.font.get(), text, color),
-                           SDL_FreeSurface);
-        if (surface) {
-            TexturePtr texture(SDL_CreateTextureFromSurface(renderer, surface.get()),
-                               SDL_DestroyTexture);
-            if (texture) {
-                int tex_w = 0;
-                int tex_h = 0;
-                SDL_QueryTexture(texture.get(), nullptr, nullptr, &tex_w, &tex_h);
-                // 画面中央に配置
-                SDL_Rect dst{
-                    .x = (setting.canvasWidth - tex_w) / 2,
-                    .y = (setting.canvasHeight / 4) - (tex_h / 2),
-                    .w = tex_w,
-                    .h = tex_h,
-                };
-                SDL_RenderCopy(renderer, texture.get(), nullptr, &dst);
-            }
-        }
+        // 画面中央上部にタイトル
+        setting.draw_text_centered(renderer, ui_text::kTitle, color, setting.canvasWidth / 2,
+                                   setting.canvasHeight / 4);
 
-        // サブテキストのレンダリング
-        SurfacePtr sub_surface(TTF_RenderUTF8_Blended(setting.font.get(), subtext, color),
-                               SDL_FreeSurface);
-        if (sub_surface) {
-            TexturePtr sub_texture(SDL_CreateTextureFromSurface(renderer, sub_surface.get()),
-                                   SDL_DestroyTexture);
-            if (sub_texture && !(blink_counter < blink_interval)) {
-                int tex_w = 0;
-                int tex_h = 0;
-                SDL_QueryTexture(sub_texture.get(), nullptr, nullptr, &tex_w, &tex_h);
-                // 画面中央下部に配置
-                SDL_Rect dst{
-                    .x = (setting.canvasWidth - tex_w) / 2,
-                    .y = (setting.canvasHeight * 2 / 4) - (tex_h / 2),
-                    .w = tex_w,
-                    .h = tex_h,
-                };
-                SDL_RenderCopy(renderer, sub_texture.get(), nullptr, &dst);
-            }
+        // サブテキストは点滅(表示するフレームだけ描く)
+        if (!(blink_counter < blink_interval)) {
+            setting.draw_text_centered(renderer, ui_text::kPressStart, color,
+                                       setting.canvasWidth / 2, setting.canvasHeight * 2 / 4);
         }
+        setting.draw_text_centered(renderer, ui_text::kPressVersus, color,
+                                   setting.canvasWidth / 2, setting.canvasHeight * 3 / 4);
     }
     blink_counter = (blink_counter + 1) % (blink_interval * 2);
     SDL_RenderPresent(renderer);
 }
 
+// 描画用の写し(見た目はシーンの値によらない)
+inline void capture(const InitialSceneData&, SceneSnapshot& out) { out.kind = SceneKind::Initial; }
+
 }  // namespace my_scenes
@@ -3,7 +3,10 @@
 // ===========================
 module;
 #include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string_view>
 #include <tl/expected.hpp>
+#include <utility>
 #include <variant>
 
 export module MyScenes;
@@ -11,6 +14,9 @@ export module MyScenes;
 // フレームワーク連携のために必要
 import SceneFramework;
 import GlobalSetting;
+import AssetLoader;
+import TetrisRule;
+import Versus;
 
 // シーン定義や各シーン固有の処理はパーティションに分割
 export import :Core;  // 型と共通事項
@@ -18,11 +24,41 @@ export import :Core;  // 型と共通事項
 export import :GameScene;  // 初期シーン
 export import :Initial;    // 次のシーン
 export import :GameOver;   // 三つ目のシーン
+export import :Versus;     // 対戦
 
 export namespace my_scenes {
 
 using scene_fw::Env;
 
+// ★ 追加: 裏で読み込み終わったアセットを受け取る(シーンによらず、描画の直前にメインスレッドで)
+//   UI フォントはメインスレッドで開いてから Setting を差し替えて配る。シミュレーション側へ
+//   渡るのは開き終えたフォントを載せた差し替えだけ(SDL_ttf は別スレッドから触らない)
+inline void deliver_assets(const Env<global_setting::GlobalSetting>& env) {
+    const auto& setting = env.setting;
+    if (!setting.assets || setting.assets->pending() == 0) return;
+    for (auto& loaded : setting.assets->poll()) {
+        if (!loaded.ok) {
+            SDL_Log("Asset load failed: %s", loaded.error.c_str());
+            continue;
+        }
+        SDL_Log("Asset loaded: %s (%zu bytes, %.1f ms)", loaded.path.c_str(), loaded.bytes.size(),
+                loaded.elapsed_ms);
+        if (std::string_view{loaded.path} == global_setting::kUiFontPath) {
+            auto font = global_setting::open_font_from_memory(std::move(loaded.bytes),
+                                                              global_setting::kUiFontPointSize);
+            if (!font) {
+                SDL_Log("Failed to open font: %s", TTF_GetError());
+                continue;
+            }
+            env.update_setting([font = std::move(font)](const global_setting::GlobalSetting& cur) {
+                global_setting::GlobalSetting next = cur;
+                next.font = font;
+                return next;
+            });
+        }
+    }
+}
+
 // フレームワーク連携
 struct Impl {
     using Scene = my_scenes::Scene;
@@ -40,6 +76,35 @@ struct Impl {
                      const Env<global_setting::GlobalSetting>& env) {
         std::visit([&](auto const& ss) { render(ss, r, env); }, current);
     }
+
+    // 描画の直前(メインスレッド)
+    static void before_draw(const Env<global_setting::GlobalSetting>& env) { deliver_assets(env); }
+
+    // ★ 追加: 描画用の写し(Game はこれがあればシミュレーションを別スレッドで進める)
+    using Snapshot = SceneSnapshot;
+    using RenderState = SceneRenderState;
+
+    static void publish(const Scene& current, Snapshot& out) {
+        std::visit([&](auto const& ss) { capture(ss, out); }, current);
+    }
+
+    static void draw_snapshot(const Snapshot& snap, RenderState& state, SDL_Renderer* const r,
+                              const Env<global_setting::GlobalSetting>& env) {
+        switch (snap.kind) {
+            case SceneKind::Initial:
+                render(InitialSceneData{}, r, env);
+                break;
+            case SceneKind::Game:
+                tetris_rule::render_snapshot(snap.board, state.board, r, env);
+                break;
+            case SceneKind::GameOver:
+                render(GameOverSceneData{.won = snap.won}, r, env);
+                break;
+            case SceneKind::Versus:
+                versus::render_match_snapshot(snap.match, state.match, r, env);
+                break;
+        }
+    }
 };
 
 }  // namespace my_scenes
@@ -0,0 +1,478 @@
+module;
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+export module PlacementSearch;
+
+import Tetrimino;
+import Bitboard;
+import SRS;
+import ThreadPool;
+
+// =============================
+// 配置探索(ヒント・CPU 用)
+//   ピースを (列, 行, 向き) の状態として BFS で辿り、最終的に置ける場所をすべて列挙する。
+//   操作は左右 1 マス・下 1 マス・左右回転(SRS キック表をそのまま引く)で、判定はルール System と
+//   同じ BitBoard::fits なので、ひねり込み(T-spin など)を含めて実際に入れられる場所だけが出る。
+//   同じセルを占める向き違い(O・I・S・Z の対称形)は 1 つにまとめる。
+//   CPU のように「回転 → 左右 → ハードドロップ」しか打てない側には、その操作で届く配置だけに
+//   絞った探索(hard_drop_only)も用意する。
+//   評価関数は差し替え可能で、NEXT を使った複数手読みは 1 手目ごとにスレッドプールで並列化する。
+// =============================
+
+export namespace placement {
+
+/**
+ * @brief 盤面上のピース状態(セル単位。Position と同じく 4x4 ローカル原点の位置)
+ * @param type 種別
+ * @param dir 向き
+ * @param col 列
+ * @param row 行
+ */
+struct PieceState {
+    PieceType type{};
+    PieceDirection dir{};
+    int col{0};
+    int row{0};
+
+    bool operator==(const PieceState&) const = default;
+};
+
+/**
+ * @brief 最終配置 1 つ
+ * @param piece 置いた状態(向きは同じセルを占める向きのうち代表の 1 つ)
+ * @param twist 最後の操作が回転で、そこから左右・上のどこへも動けない(ひねり込み)
+ * @param used_hold ホールドと入れ替えたピースを置く
+ * @param lines_cleared 置いたときに消える行数(評価時に埋まる)
+ */
+struct Placement {
+    PieceState piece;
+    bool twist{false};
+    bool used_hold{false};
+    int lines_cleared{0};
+};
+
+/**
+ * @brief 盤面の特徴量(評価関数の材料)
+ * @param aggregate_height 各列の高さの合計
+ * @param max_height 最も高い列の高さ
+ * @param holes 上が埋まっている空きセルの数
+ * @param bumpiness 隣り合う列の高さの差の合計
+ */
+struct BoardFeatures {
+    int aggregate_height{0};
+    int max_height{0};
+    int holes{0};
+    int bumpiness{0};
+};
+
+// 列の高さは BitBoard の列ごとの最上段(定数時間)、穴は行ごとのビット演算で数える
+inline BoardFeatures board_features(const BitBoard& board) {
+    BoardFeatures f{};
+    int top_row = board.rows();
+    int prev_height = -1;
+    for (int c = 0; c < board.cols(); ++c) {
+        const int top = board.column_top(c);
+        const int h = board.rows() - top;
+        f.aggregate_height += h;
+        f.max_height = std::max(f.max_height, h);
+        if (prev_height >= 0) f.bumpiness += std::abs(h - prev_height);
+        prev_height = h;
+        top_row = std::min(top_row, top);
+    }
+    RowMask covered = 0;
+    for (int r = top_row; r < board.rows(); ++r) {
+        const RowMask bits = board.row_bits(r);
+        f.holes += std::popcount(covered & ~bits);
+        covered |= bits;
+    }
+    return f;
+}
+
+/**
+ * @brief 評価関数: 置いた後の盤面と配置から点数を返す(大きいほど良い)
+ *   複数手読みでは別スレッドから同時に呼ばれるので、状態を持たないこと
+ */
+using Evaluator = std::function<double(const BitBoard& after, const Placement& placement)>;
+
+// 既定の評価(高さ・穴・凸凹を減点し、消去とひねり込みの消去を加点する)
+inline double evaluate_default(const BitBoard& after, const Placement& placement) {
+    const BoardFeatures f = board_features(after);
+    double score = -0.510066 * f.aggregate_height + 0.760666 * placement.lines_cleared -
+                   0.35663 * f.holes - 0.184483 * f.bumpiness;
+    if (placement.twist && placement.lines_cleared > 0) score += 1.0;
+    return score;
+}
+
+// ピースを盤面へ書き込み、揃った行を消して消えた行数を返す
+inline int place(BitBoard& board, const PieceState& p) {
+    const PieceMask& m = piece_mask(p.type, p.dir);
+    board.stamp(m, p.row, p.col);
+    std::array<int, 4> full{};
+    std::size_t n = 0;
+    for (int rr = m.max_row; rr >= m.min_row; --rr) {  // remove_rows は降順を要求する
+        const int r = p.row + rr;
+        if (0 <= r && r < board.rows() && board.row_full(r)) full[n++] = r;
+    }
+    if (n > 0) board.remove_rows(std::span<const int>(full.data(), n));
+    return static_cast<int>(n);
+}
+
+// hard_drop_only の探索で、1 つの配置へ運ぶのに使ってよい回転と左右の操作数の上限
+inline constexpr int kMaxHardDropMoves = 16;
+
+/**
+ * @brief 1 つのピースの到達可能な最終配置を列挙する探索器
+ *
+ * 訪問済みビット集合と BFS キューは呼び出しをまたいで使い回す(同じ盤面サイズなら確保なし)。
+ * 1 つの探索器を複数スレッドから同時に使わないこと。
+ */
+class PlacementSearcher {
+   public:
+    // spawn から到達できる最終配置(spawn に置けなければ空)。結果は次の search まで有効
+    //   hard_drop_only なら、spawn の位置で代表の向きへ回し(右回りを優先、半回転は右 2 回)、
+    //   左右へ寄せてハードドロップするだけで届く配置に限る(下入れ・ひねり込みは出ない)
+    std::span<const Placement> search(const BitBoard& board, const PieceState& spawn,
+                                      bool hard_drop_only = false);
+
+    // 直近の search で訪れた状態数
+    [[nodiscard]] std::size_t visited_states() const noexcept { return queue_.size(); }
+
+   private:
+    // ローカル原点は盤面の左・上へ最大 3 マスはみ出せる
+    static constexpr int kPad = 3;
+
+    const BitBoard* board_{nullptr};
+    PieceType type_{};
+    int stride_{0};  // 1 行分の状態数(列数 + kPad)
+    std::vector<std::uint64_t> visited_;
+    std::vector<std::uint64_t> landed_;  // 同じセルを占める配置をまとめた後の最終配置
+    std::vector<std::uint32_t> queue_;
+    std::vector<Placement> results_;
+
+    [[nodiscard]] std::uint32_t index(int col, int row, PieceDirection dir) const noexcept {
+        const int cell = (row + kPad) * stride_ + (col + kPad);
+        return static_cast<std::uint32_t>(cell * 4 + static_cast<int>(dir));
+    }
+    [[nodiscard]] PieceState decode(std::uint32_t idx) const noexcept {
+        const int cell = static_cast<int>(idx / 4);
+        return PieceState{type_, static_cast<PieceDirection>(idx % 4), cell % stride_ - kPad,
+                          cell / stride_ - kPad};
+    }
+    // ビットを立て、元から立っていたかを返す
+    static bool test_and_set(std::vector<std::uint64_t>& bits, std::uint32_t idx) noexcept {
+        std::uint64_t& word = bits[idx / 64];
+        const std::uint64_t bit = std::uint64_t{1} << (idx % 64);
+        const bool was = (word & bit) != 0;
+        word |= bit;
+        return was;
+    }
+
+    void visit(int col, int row, PieceDirection dir) {
+        const std::uint32_t idx = index(col, row, dir);
+        if (!test_and_set(visited_, idx)) queue_.push_back(idx);
+    }
+    void try_shift(const PieceMask& m, int col, int row, PieceDirection dir) {
+        if (board_->fits(m, row, col)) visit(col, row, dir);
+    }
+    void try_rotate(int col, int row, PieceDirection from, int turn);
+    // from → to の回転で最初に置けたキックを col / row に足す(どれも置けなければ false)
+    [[nodiscard]] bool kick(int& col, int& row, PieceDirection from, PieceDirection to) const;
+    void land(int col, int row, PieceDirection dir, bool twist);
+    void search_hard_drop(const PieceState& spawn);
+};
+
+/**
+ * @brief 複数手読みの入力
+ * @param board 現在の盤面
+ * @param current 操作中のピース(この位置から探索する)
+ * @param held ホールド中の種別
+ * @param hold_available このピースでまだホールドしていない
+ * @param preview NEXT(先頭が次に出るピース)
+ * @param spawn_col, spawn_row, spawn_dir 新しいピースの出現位置と向き
+ */
+struct SearchRequest {
+    const BitBoard* board{nullptr};
+    PieceState current;
+    std::optional<PieceType> held;
+    bool hold_available{true};
+    std::span<const PieceType> preview;
+    int spawn_col{0};
+    int spawn_row{0};
+    PieceDirection spawn_dir{PieceDirection::West};
+};
+
+/**
+ * @brief 探索の設定
+ * @param depth 読む手数(1 = 現在のピースだけ、2 = NEXT の先頭まで ...)
+ * @param allow_hold ホールドと入れ替える手も候補にする
+ * @param hard_drop_only 回転 → 左右 → ハードドロップで届く配置だけを読む(CPU 用)
+ * @param evaluator 1 手ごとの評価(読み筋の点数は各手の評価の和)
+ */
+struct SearchOptions {
+    int depth{1};
+    bool allow_hold{true};
+    bool hard_drop_only{false};
+    Evaluator evaluator{evaluate_default};
+};
+
+/**
+ * @brief 探索結果
+ * @param first 今置くべき配置
+ * @param score 読み筋全体の点数
+ * @param candidates 比較した 1 手目の数
+ */
+struct Plan {
+    Placement first;
+    double score{0.0};
+    std::size_t candidates{0};
+};
+
+// 最善の 1 手目を返す(置ける場所がなければ nullopt)。pool があれば 1 手目ごとに並列に読む
+std::optional<Plan> best_plan(const SearchRequest& req, const SearchOptions& opt = {},
+                              WorkStealingPool* pool = nullptr);
+
+}  // namespace placement
+
+namespace placement {
+
+// 同じセルを占める向きのうち代表(最小の向き)と、そこへ移すときの原点のずれ
+struct Canonical {
+    PieceDirection dir{};
+    int dcol{0};
+    int drow{0};
+};
+
+constexpr bool same_shape(const PieceMask& a, const PieceMask& b) noexcept {
+    if (a.max_row - a.min_row != b.max_row - b.min_row) return false;
+    for (int r = 0; r <= a.max_row - a.min_row; ++r) {
+        if ((a.rows[a.min_row + r] >> a.min_col) != (b.rows[b.min_row + r] >> b.min_col)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// [PieceType][PieceDirection] の代表表(コンパイル時に生成)
+inline constexpr auto kCanonical = [] {
+    std::array<std::array<Canonical, kDirectionCount>, kPieceTypeCount> table{};
+    for (std::size_t t = 0; t < kPieceTypeCount; ++t) {
+        const auto type = static_cast<PieceType>(t);
+        for (std::size_t d = 0; d < kDirectionCount; ++d) {
+            const PieceMask& md = piece_mask(type, static_cast<PieceDirection>(d));
+            for (std::size_t c = 0; c <= d; ++c) {
+                const PieceMask& mc = piece_mask(type, static_cast<PieceDirection>(c));
+                if (same_shape(md, mc)) {
+                    table[t][d] = Canonical{static_cast<PieceDirection>(c),
+                                            md.min_col - mc.min_col, md.min_row - mc.min_row};
+                    break;
+                }
+            }
+        }
+    }
+    return table;
+}();
+
+std::span<const Placement> PlacementSearcher::search(const BitBoard& board,
+                                                     const PieceState& spawn, bool hard_drop_only) {
+    board_ = &board;
+    type_ = spawn.type;
+    stride_ = board.cols() + kPad;
+    const std::size_t states = static_cast<std::size_t>((board.rows() + kPad) * stride_) * 4;
+    visited_.assign((states + 63) / 64, 0);
+    landed_.assign((states + 63) / 64, 0);
+    queue_.clear();
+    results_.clear();
+
+    // fits が通れば原点は [-kPad, cols) x [-kPad, rows) に収まるので、添字は範囲内
+    if (!board.fits(piece_mask(spawn.type, spawn.dir), spawn.row, spawn.col)) return {};
+    if (hard_drop_only) {
+        search_hard_drop(spawn);
+        return results_;
+    }
+    visit(spawn.col, spawn.row, spawn.dir);
+
+    for (std::size_t head = 0; head < queue_.size(); ++head) {
+        const PieceState s = decode(queue_[head]);
+        const PieceMask& m = piece_mask(type_, s.dir);
+        if (board.fits(m, s.row + 1, s.col)) {
+            visit(s.col, s.row + 1, s.dir);
+        } else {
+            land(s.col, s.row, s.dir, false);
+        }
+        try_shift(m, s.col - 1, s.row, s.dir);
+        try_shift(m, s.col + 1, s.row, s.dir);
+        try_rotate(s.col, s.row, s.dir, +1);
+        try_rotate(s.col, s.row, s.dir, -1);
+    }
+    return results_;
+}
+
+// ルール(resolveRotationSystem_pure)と同じく、最初に置けたキックだけが有効
+bool PlacementSearcher::kick(int& col, int& row, PieceDirection from, PieceDirection to) const {
+    const PieceMask& m = piece_mask(type_, to);
+    for (const auto& k : srs_kicks(type_, from, to)) {
+        if (!board_->fits(m, row + k.dy, col + k.dx)) continue;
+        col += k.dx;
+        row += k.dy;
+        return true;
+    }
+    return false;
+}
+
+void PlacementSearcher::try_rotate(int col, int row, PieceDirection from, int turn) {
+    const PieceDirection to = rotated_direction(from, turn);
+    int c = col;
+    int r = row;
+    if (!kick(c, r, from, to)) return;
+    const PieceMask& m = piece_mask(type_, to);
+    // 回転で入った接地位置が左右・上のどこへも動けなければ、ひねり込み
+    if (!board_->fits(m, r + 1, c) && !board_->fits(m, r, c - 1) && !board_->fits(m, r, c + 1) &&
+        !board_->fits(m, r - 1, c)) {
+        land(c, r, to, true);
+    }
+    visit(c, r, to);
+}
+
+// CPU(cpu_player::search_key)の運び方をそのままなぞる: 代表の向きごとに、左回り 1 回で
+// 届くなら左、それ以外は右へ回し、そこから左右へ 1 マスずつ寄せた列ごとにハードドロップする。
+// 寄せる列は近い順に並べる(同点なら操作数の少ない配置が先に見つかる)
+void PlacementSearcher::search_hard_drop(const PieceState& spawn) {
+    for (std::size_t d = 0; d < kDirectionCount; ++d) {
+        const auto goal = static_cast<PieceDirection>(d);
+        if (kCanonical[static_cast<std::size_t>(type_)][d].dir != goal) continue;
+
+        int col = spawn.col;
+        int row = spawn.row;
+        PieceDirection dir = spawn.dir;
+        int moves = 0;
+        while (dir != goal) {
+            const int turn = rotated_direction(dir, -1) == goal ? -1 : +1;
+            const PieceDirection to = rotated_direction(dir, turn);
+            if (!kick(col, row, dir, to)) break;
+            dir = to;
+            ++moves;
+        }
+        if (dir != goal) continue;
+
+        const PieceMask& m = piece_mask(type_, dir);
+        auto drop = [&](int c) {
+            int r = row;
+            while (board_->fits(m, r + 1, c)) ++r;
+            land(c, r, dir, false);
+        };
+        drop(col);
+        bool left_open = true;
+        bool right_open = true;
+        for (int step = 1; (left_open || right_open) && moves + step <= kMaxHardDropMoves;
+             ++step) {
+            left_open = left_open && board_->fits(m, row, col - step);
+            if (left_open) drop(col - step);
+            right_open = right_open && board_->fits(m, row, col + step);
+            if (right_open) drop(col + step);
+        }
+    }
+}
+
+void PlacementSearcher::land(int col, int row, PieceDirection dir, bool twist) {
+    const Canonical& k = kCanonical[static_cast<std::size_t>(type_)][static_cast<std::size_t>(dir)];
+    const PieceState p{type_, k.dir, col + k.dcol, row + k.drow};
+    if (!test_and_set(landed_, index(p.col, p.row, p.dir))) {
+        results_.push_back(Placement{p, twist});
+        return;
+    }
+    if (!twist) return;
+    // 既に列挙済みの配置へ、回転でも入れることを追記する(まれなので線形探索)
+    for (auto& r : results_) {
+        if (r.piece == p) {
+            r.twist = true;
+            break;
+        }
+    }
+}
+
+// 読み切れない(置く場所がない)手の点数
+inline constexpr double kToppedOut = -1e12;
+
+// preview の先頭から depth 手を出現位置から置いたときの最善の点数
+double lookahead(PlacementSearcher& searcher, const BitBoard& board,
+                 std::span<const PieceType> preview, int depth, const SearchRequest& req,
+                 const SearchOptions& opt) {
+    if (depth <= 0 || preview.empty()) return 0.0;
+    const PieceState spawn{preview.front(), req.spawn_dir, req.spawn_col, req.spawn_row};
+    const auto found = searcher.search(board, spawn, opt.hard_drop_only);
+    // 下の階層が searcher を使い回すので候補は写しておく
+    const std::vector<Placement> candidates(found.begin(), found.end());
+    if (candidates.empty()) return kToppedOut;
+
+    double best = kToppedOut;
+    for (Placement p : candidates) {
+        BitBoard next = board;
+        p.lines_cleared = place(next, p.piece);
+        const double v = opt.evaluator(next, p) +
+                         lookahead(searcher, next, preview.subspan(1), depth - 1, req, opt);
+        best = std::max(best, v);
+    }
+    return best;
+}
+
+std::optional<Plan> best_plan(const SearchRequest& req, const SearchOptions& opt,
+                              WorkStealingPool* pool) {
+    if (!req.board || !opt.evaluator) return std::nullopt;
+
+    // 1 手目の候補: 操作中のピースと、ホールドを使う場合に出てくるピース
+    struct Root {
+        Placement placement;
+        std::span<const PieceType> rest;  // その後に出てくる NEXT
+        double score{kToppedOut};
+    };
+    std::vector<Root> roots;
+    PlacementSearcher searcher;
+    for (const auto& p : searcher.search(*req.board, req.current, opt.hard_drop_only)) {
+        roots.push_back(Root{p, req.preview});
+    }
+    if (opt.allow_hold && req.hold_available) {
+        std::optional<PieceType> swap = req.held;
+        std::span<const PieceType> rest = req.preview;
+        if (!swap && !rest.empty()) {  // 空のホールドへ入れると NEXT の先頭が出てくる
+            swap = rest.front();
+            rest = rest.subspan(1);
+        }
+        if (swap && *swap != req.current.type) {
+            const PieceState spawn{*swap, req.spawn_dir, req.spawn_col, req.spawn_row};
+            for (auto p : searcher.search(*req.board, spawn, opt.hard_drop_only)) {
+                p.used_hold = true;
+                roots.push_back(Root{p, rest});
+            }
+        }
+    }
+    if (roots.empty()) return std::nullopt;
+
+    auto score_root = [&](std::size_t i) {
+        Root& root = roots[i];
+        PlacementSearcher local;
+        BitBoard next = *req.board;
+        root.placement.lines_cleared = place(next, root.placement.piece);
+        root.score = opt.evaluator(next, root.placement) +
+                     lookahead(local, next, root.rest, opt.depth - 1, req, opt);
+    };
+    if (pool && opt.depth > 1) {
+        pool->parallel_for(roots.size(), score_root);
+    } else {
+        for (std::size_t i = 0; i < roots.size(); ++i) score_root(i);
+    }
+
+    // 同点なら先に見つかった(=操作数の少ない)配置を採る
+    const auto best = std::max_element(
+        roots.begin(), roots.end(), [](const Root& a, const Root& b) { return a.score < b.score; });
+    return Plan{best->placement, best->score, roots.size()};
+}
+
+}  // namespace placement
@@ -1,22 +1,27 @@
 module;
 #include <array>
+#include <cstddef>
+#include <cstdint>
 export module SRS;
 
 import Tetrimino;
 
 // =============================
 // SRS キックオフセット定義
+//   ★ 追加: 下の関数群はコンパイル時に [type][from][to] の表へ展開し、
+//          実行時は srs_kicks の表引き 1 回だけにする
 // =============================
 
-struct KickOffset {
-    int dx;  // 列方向オフセット(セル単位)
-    int dy;  // 行方向オフセット(セル単位)
+export struct KickOffset {
+    std::int8_t dx;  // 列方向オフセット(セル単位)
+    std::int8_t dy;  // 行方向オフセット(セル単位、下が正)
 };
 
+export using KickList = std::array<KickOffset, 5>;
+
 // JLSTZ 用 SRS キックテーブル(回転 0, R, 2, L = North, East, South, West)
 // 参照: Tetris Guideline SRS
-constexpr std::array<KickOffset, 5> srs_kicks_jlstz(PieceDirection from,
-                                                    PieceDirection to) noexcept {
+constexpr KickList srs_kicks_jlstz(PieceDirection from, PieceDirection to) noexcept {
     using D = PieceDirection;
     // 0 -> R
     if (from == D::North && to == D::East) {
@@ -56,7 +61,7 @@ constexpr std::array<KickOffset, 5> srs_kicks_jlstz(PieceDirection from,
 }
 
 // I ミノ用 SRS キックテーブル
-constexpr std::array<KickOffset, 5> srs_kicks_i(PieceDirection from, PieceDirection to) noexcept {
+constexpr KickList srs_kicks_i(PieceDirection from, PieceDirection to) noexcept {
     using D = PieceDirection;
     // 0 -> R
     if (from == D::North && to == D::East) {
@@ -94,8 +99,7 @@ constexpr std::array<KickOffset, 5> srs_kicks_i(PieceDirection from, PieceDirect
     return {{{0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}}};
 }
 
-export constexpr std::array<KickOffset, 5> srs_kicks(PieceType type, PieceDirection from,
-                                                     PieceDirection to) noexcept {
+constexpr KickList make_kicks(PieceType type, PieceDirection from, PieceDirection to) noexcept {
     if (type == PieceType::I) {
         return srs_kicks_i(from, to);
     }
@@ -106,3 +110,26 @@ export constexpr std::array<KickOffset, 5> srs_kicks(PieceType type, PieceDirect
     // J, L, S, T, Z
     return srs_kicks_jlstz(from, to);
 }
+
+// [PieceType][from][to] のキック表(同じ向き・180 度の組は全て 0)
+inline constexpr auto kKickTable = [] {
+    std::array<std::array<std::array<KickList, kDirectionCount>, kDirectionCount>,
+               kPieceTypeCount>
+        table{};
+    for (std::size_t t = 0; t < kPieceTypeCount; ++t) {
+        for (std::size_t f = 0; f < kDirectionCount; ++f) {
+            for (std::size_t d = 0; d < kDirectionCount; ++d) {
+                table[t][f][d] =
+                    make_kicks(static_cast<PieceType>(t), static_cast<PieceDirection>(f),
+                               static_cast<PieceDirection>(d));
+            }
+        }
+    }
+    return table;
+}();
+
+export constexpr const KickList& srs_kicks(PieceType type, PieceDirection from,
+                                           PieceDirection to) noexcept {
+    return kKickTable[static_cast<std::size_t>(type)][static_cast<std::size_t>(from)]
+                     [static_cast<std::size_t>(to)];
+}
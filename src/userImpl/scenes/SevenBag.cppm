@@ -1,5 +1,6 @@
 module;
 #include <algorithm>
+#include <cstdint>
 #include <deque>
 #include <random>
 export module SevenBag;
@@ -7,11 +8,14 @@ import Tetrimino;
 /**
  * @brief テトリミノキュー
  * @param queue テトリミノ種別のキュー
- * @param rng 乱数生成器
+ * @param rng 乱数生成器(シード指定時は同じ出現順を再現できる)
  */
 export struct PieceQueue {
     std::deque<PieceType> queue;
     std::mt19937 rng{std::random_device{}()};
+
+    PieceQueue() = default;
+    explicit PieceQueue(std::uint32_t seed) : rng(seed) {}
 };
 
 export inline void refill_bag(PieceQueue& pq) {
@@ -1,6 +1,8 @@
 module;
 #include <SDL2/SDL.h>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <entt/entt.hpp>
 #include <tl/expected.hpp>
 #include <utility>
@@ -11,6 +13,16 @@ export enum class PieceType { I, O, T, S, Z, J, L };
 export enum class PieceStatus { Falling, Landed, Merged };
 export enum class PieceDirection { North, East, South, West };
 
+export inline constexpr std::size_t kPieceTypeCount = 7;
+export inline constexpr std::size_t kDirectionCount = 4;
+
+// 右回転(dir > 0)／左回転(dir < 0)後の向き。列挙子の並びが時計回りなので剰余で求める
+export constexpr PieceDirection rotated_direction(PieceDirection d, int dir) noexcept {
+    if (dir == 0) return d;
+    const int step = dir > 0 ? 1 : 3;
+    return static_cast<PieceDirection>((static_cast<int>(d) + step) & 3);
+}
+
 // =============================
 // 形状ヘルパ(ローカル定義)
 // =============================
@@ -49,7 +61,7 @@ export struct TetriminoMeta {
     PieceDirection direction{};
     PieceStatus status{};
     int rotationCount{0};
-    int minimumY{0};  // ロック/回転リセット用
+    int minimumY{0};  // ロック/回転リセット用(到達した最も下の行。セル単位)
 };
 
 // 4*4グリッド上の各向きでのセル座標を定義する関数群(埋まっているセルをオフセットで表現)
@@ -132,7 +144,7 @@ constexpr std::array<Coord, 4> get_cells_west_local(PieceType type) noexcept {
     return {};
 }
 
-export constexpr std::array<Coord, 4> cells_for(PieceType type, PieceDirection dir) noexcept {
+constexpr std::array<Coord, 4> make_cells(PieceType type, PieceDirection dir) noexcept {
     switch (dir) {
         case PieceDirection::North:
             return get_cells_north_local(type);
@@ -145,3 +157,19 @@ export constexpr std::array<Coord, 4> cells_for(PieceType type, PieceDirection d
     }
     return {};
 }
+
+// [PieceType][PieceDirection] のセル表(コンパイル時に上の定義から生成。実行時の分岐なし)
+inline constexpr auto kPieceCells = [] {
+    std::array<std::array<std::array<Coord, 4>, kDirectionCount>, kPieceTypeCount> table{};
+    for (std::size_t t = 0; t < kPieceTypeCount; ++t) {
+        for (std::size_t d = 0; d < kDirectionCount; ++d) {
+            table[t][d] = make_cells(static_cast<PieceType>(t), static_cast<PieceDirection>(d));
+        }
+    }
+    return table;
+}();
+
+export constexpr const std::array<Coord, 4>& cells_for(PieceType type,
+                                                       PieceDirection dir) noexcept {
+    return kPieceCells[static_cast<std::size_t>(type)][static_cast<std::size_t>(dir)];
+}
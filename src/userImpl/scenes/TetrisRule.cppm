@@ -2,13 +2,29 @@ module;
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_render.h>
 #include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <entt/entt.hpp>
 #include <memory>
 #include <optional>
+#include <random>
+#include <span>
 #include <string>
 #include <tl/expected.hpp>
+#include <utility>
 #include <vector>
 
+// デバッグビルド(NDEBUG なし)では、BoardChanged を立てずに盤面を書き換えたフレームを検出する
+//   (モジュールはマクロを輸出できないので、以降は tetris_rule::kCheckBoardWrites で分岐する)
+#ifdef NDEBUG
+#define TETRIS_CHECK_BOARD_WRITES 0
+#else
+#define TETRIS_CHECK_BOARD_WRITES 1
+#endif
+
 export module TetrisRule;
 
 import GlobalSetting;
@@ -16,10 +32,17 @@ import SceneFramework;
 import GameKey;
 import Input;
 import Tetrimino;
+import Bitboard;
 import SRS;
 import SevenBag;
 import Command;
 import SDLPtr;
+import InputRecord;
+import RenderBatch;
+import UiText;
+import Profiler;
+import PlacementSearch;
+import ThreadPool;
 
 namespace tetris_rule {
 
@@ -34,9 +57,10 @@ using scene_fw::Env;
 // =============================
 
 /**
- * @brief  位置コンポーネント(ピクセル単位)
- * @param x ピクセル単位の X 座標
- * @param y ピクセル単位の Y 座標
+ * @brief  位置コンポーネント(セル単位。4x4 ローカル原点の盤面上の位置)
+ * @param x 列
+ * @param y 行
+ * ピクセルへの変換は描画層(GridResource::x_of / y_of)だけで行う
  */
 export struct Position {
     int x{}, y{};
@@ -106,14 +130,66 @@ struct HardDropRequest {
     entt::entity entity{entt::null};
 };
 
-// 盤面占有
-export enum class CellStatus : std::uint8_t { Empty, Filled };
+// 新しいピースの出現時の向き
+inline constexpr PieceDirection kSpawnDirection = PieceDirection::West;
+
+// 盤面占有(定義は Bitboard モジュール)
+export using ::CellStatus;
 
 // ★ 追加：ゲームオーバー状態(Grid のシングルトンにぶら下げる)
 struct GameOver {
     bool value{false};
 };
 
+// ★ 追加：フレーム内イベント(World の ctx に TetrisEvents として置く)
+//   盤面全体を走査する System は、起動条件のイベントが無いフレームでは実行しない。
+//   BoardChanged は GridResource の on_update、PieceSpawned は ActivePiece の on_construct
+//   (とホールドの入れ替え)から立つので、スケジュールの外で盤面を書き換えても取りこぼさない
+export enum class FrameEvent : std::uint8_t {
+    PieceLocked,   // ピースを固定した
+    RowsCleared,   // 行を消した
+    PieceSpawned,  // 操作中のピースが新しくなった(出現・ホールドでの入れ替え)
+    BoardChanged,  // 盤面(GridResource)が書き換わった
+};
+export using TetrisEvents = FrameEvents<FrameEvent>;
+
+// ★ 追加: シグナルを通さない盤面の書き換えの検出(デバッグビルドのみ)
+//   GridResource を参照で直接書き換えると on_update が鳴らず、ライン消去などが黙って飛ばされる。
+//   フレームの終わりに盤面の指紋を取っておき、次のフレームの頭で BoardChanged なしに
+//   指紋が変わっていたらログに出して数える。イベントは立てない(リリースと同じ順に動かす)
+export inline constexpr bool kCheckBoardWrites = TETRIS_CHECK_BOARD_WRITES != 0;
+
+struct BoardWriteCheck {
+    std::uint64_t fingerprint{0};
+    std::uint32_t unsignaled{0};  // 検出した回数
+};
+
+/**
+ * @brief ★ 追加：対戦用のおじゃまメーター(対戦の World だけ Grid のシングルトンに付く)
+ * @param incoming 受け取って、まだせり上げていない行数
+ * @param outgoing 相手へ送る行数(対戦側が step_world の後で回収して 0 に戻す)
+ * @param hole_state おじゃま行の穴の列を決める乱数の状態(World ごとに決定的)
+ * @param lines_cleared 消した行数の累計
+ */
+export struct GarbageMeter {
+    int incoming{0};
+    int outgoing{0};
+    std::uint32_t hole_state{1};
+    int lines_cleared{0};
+};
+
+// 同時に消した行数 → 送るおじゃま行数(1 行: 0, 2 行: 1, 3 行: 2, 4 行: 4)
+export inline constexpr std::array<int, 5> kGarbageForLines{0, 0, 1, 2, 4};
+
+// 穴の列を決めて乱数の状態を進める(xorshift32。状態 0 は使わない)
+inline int next_garbage_hole(std::uint32_t& state, int cols) noexcept {
+    if (state == 0) state = 0x9E3779B9u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return static_cast<int>(state % static_cast<std::uint32_t>(cols));
+}
+
 // グリッド情報＋占有
 export struct GridResource {
     int rows{};
@@ -125,7 +201,11 @@ export struct GridResource {
     // ★ 追加：占有セルのテトリミノ種別(描画色復元用)
     // occ[index] == Filled のときのみ参照する
     std::vector<PieceType> occ_type;  // row-major, same size as occ
-    std::vector<CellStatus> occ;      // row-major
+    // 占有はビットボード(1 行 = 1 整数)。occ[index] で CellStatus 互換アクセスも可能
+    BitBoard occ;
+    // ★ 追加：対戦でせり上がったおじゃまブロックの行マスク(占有の部分集合。描画色用)
+    //   一度もせり上がっていない盤面では空のまま
+    std::vector<RowMask> garbage;
 
     [[nodiscard]] inline int index(int row, int column) const noexcept {
         return row * cols + column;
@@ -133,47 +213,124 @@ export struct GridResource {
     [[nodiscard]] inline SDL_Rect rect_rc(int row, int column) const noexcept {
         return SDL_Rect{origin_x + column * cellW, origin_y + row * cellH, cellW, cellH};
     }
+    // セル → ピクセル座標(描画専用)
+    [[nodiscard]] inline int x_of(int column) const noexcept { return origin_x + column * cellW; }
+    [[nodiscard]] inline int y_of(int row) const noexcept { return origin_y + row * cellH; }
+
+    [[nodiscard]] inline RowMask garbage_bits(int row) const noexcept {
+        return garbage.empty() ? RowMask{0} : garbage[static_cast<std::size_t>(row)];
+    }
+
+    // 1 セルを埋めて色を記録する
+    inline void fill_cell(int row, int column, PieceType type) noexcept {
+        occ.set(row, column);
+        occ_type[static_cast<std::size_t>(index(row, column))] = type;
+    }
+
+    // 指定行(下から順＝降順)を取り除き、残りの行を下へ詰める(色も同じく移動)
+    //   占有ビットと列ごとの最上段は BitBoard::remove_rows がまとめて更新する
+    void remove_rows(std::span<const int> rows_desc) {
+        occ.remove_rows(rows_desc);
+        std::size_t k = 0;
+        int write = rows - 1;
+        for (int r0 = rows - 1; r0 >= 0; --r0) {
+            if (k < rows_desc.size() && rows_desc[k] == r0) {
+                ++k;
+                continue;
+            }
+            if (write != r0) {
+                std::copy_n(occ_type.begin() + index(r0, 0), cols,
+                            occ_type.begin() + index(write, 0));
+                if (!garbage.empty()) {
+                    garbage[static_cast<std::size_t>(write)] =
+                        garbage[static_cast<std::size_t>(r0)];
+                }
+            }
+            --write;
+        }
+        for (int r0 = write; r0 >= 0; --r0) {
+            // ★ 任意：既定値でクリア(未使用だが保守性のため)
+            std::fill_n(occ_type.begin() + index(r0, 0), cols, PieceType::I);
+            if (!garbage.empty()) garbage[static_cast<std::size_t>(r0)] = 0;
+        }
+    }
+
+    // ★ 追加：おじゃまブロックを下から count 行せり上げる(各行 hole_col だけ空ける)
+    //   上端から押し出されたブロックがあれば false
+    bool insert_garbage(int count, int hole_col) {
+        count = std::clamp(count, 0, rows);
+        if (count == 0) return true;
+        if (garbage.size() != static_cast<std::size_t>(rows)) {
+            garbage.assign(static_cast<std::size_t>(rows), RowMask{0});
+        }
+        const RowMask row_bits = occ.full_mask() & ~(RowMask{1} << hole_col);
+        const std::vector<RowMask> added(static_cast<std::size_t>(count), row_bits);
+        const bool kept = occ.push_rows_bottom(added);
+
+        const auto shift = static_cast<std::ptrdiff_t>(count) * cols;
+        std::copy(occ_type.begin() + shift, occ_type.end(), occ_type.begin());
+        std::copy(garbage.begin() + count, garbage.end(), garbage.begin());
+        for (int r0 = rows - count; r0 < rows; ++r0) {
+            std::fill_n(occ_type.begin() + index(r0, 0), cols, PieceType::I);
+            garbage[static_cast<std::size_t>(r0)] = row_bits;
+        }
+        return kept;
+    }
+};
+
+/**
+ * @brief GridResource への差分パッチ(registry 上の実体へその場で適用する)
+ * @param writes 埋めるセル(1 ピース分)
+ * @param write_count writes の有効数
+ * @param cleared_rows 取り除く行(降順)。上の行はその分だけ下へ詰める
+ * @param garbage_lines 消去の後でせり上げるおじゃま行数(穴の列は garbage_hole)
+ */
+struct GridPatch {
+    struct CellWrite {
+        int row{};
+        int col{};
+        PieceType type{};
+    };
+    std::array<CellWrite, 4> writes{};
+    int write_count{0};
+    std::vector<int> cleared_rows;
+    int garbage_lines{0};
+    int garbage_hole{0};
+
+    void operator()(GridResource& grid) const {
+        for (int i = 0; i < write_count; ++i) {
+            const auto& w = writes[static_cast<std::size_t>(i)];
+            grid.fill_cell(w.row, w.col, w.type);
+        }
+        if (!cleared_rows.empty()) grid.remove_rows(cleared_rows);
+        if (garbage_lines > 0) grid.insert_garbage(garbage_lines, garbage_hole);
+    }
 };
 
 // =============================
-// ゴースト表示用ヘルパ
+// 配置判定・ゴースト用ヘルパ
 // =============================
 
-// Grid 上に (piecePx, piecePy) のピクセル位置で meta のテトリミノを置けるか？
+// Grid 上のセル (col, row) を 4x4 ローカル原点として type/dir のテトリミノを置けるか？
 // (ActivePiece 自身は Grid に書き込まれていない前提)
-inline bool can_place_on_grid_pixel(const GridResource& grid, const TetriminoMeta& meta,
-                                    int piecePx, int piecePy) {
-    const auto shape = cells_for(meta.type, meta.direction);
-
-    for (auto [rr, cc] : shape) {
-        // ピクセル → グリッド座標変換
-        const int col = (piecePx - grid.origin_x) / grid.cellW + cc;
-        const int row = (piecePy - grid.origin_y) / grid.cellH + rr;
-
-        // 盤面外なら不可
-        if (col < 0 || col >= grid.cols || row < 0 || row >= grid.rows) {
-            return false;
-        }
+// 盤面外・固定ブロックとの重なりはビットボードのシフト＋AND で判定する
+export inline bool can_place_on_grid(const GridResource& grid, PieceType type, PieceDirection dir,
+                                     int col, int row) {
+    return grid.occ.fits(piece_mask(type, dir), row, col);
+}
 
-        const int idx = grid.index(row, col);
-        // 既に固定ブロックがあるなら不可
-        if (grid.occ[idx] == CellStatus::Filled) {
-            return false;
-        }
-    }
-    return true;
+export inline bool can_place_on_grid(const GridResource& grid, const TetriminoMeta& meta, int col,
+                                     int row) {
+    return can_place_on_grid(grid, meta.type, meta.direction, col, row);
 }
 
 // 現在位置から縦方向に落とせるだけ落とした位置(ゴースト位置)を返す
-inline Position compute_ghost_position(const GridResource& grid, const Position& currentPos,
-                                       const TetriminoMeta& meta) {
+//   落下距離は列ごとの最上段から定数時間で求める(張り出しの下にいるときだけ 1 行ずつ探索)
+export inline Position compute_ghost_position(const GridResource& grid, const Position& currentPos,
+                                              const TetriminoMeta& meta) {
     Position ghost = currentPos;
-    const int step_py = grid.cellH;  // 1セルぶんのピクセル
-
-    // 次の 1 セル下にまだ置けるあいだ落とし続ける
-    while (can_place_on_grid_pixel(grid, meta, ghost.x, ghost.y + step_py)) {
-        ghost.y += step_py;
-    }
+    ghost.y += grid.occ.drop_distance(piece_mask(meta.type, meta.direction), currentPos.y,
+                                      currentPos.x);
     return ghost;
 }
 
@@ -201,33 +358,21 @@ struct TetrisResources {
     entt::entity grid_e{entt::null};
 };
 
+// StaticPhaseIf の起動条件: Es のいずれかがこのフレームで起きていれば true
+//   (TetrisEvents を持たない registry では常に true ＝ 毎フレーム実行)
+template <FrameEvent... Es>
+bool triggered_by(const entt::registry& reg, const TetrisResources&) {
+    const auto* events = reg.ctx().find<TetrisEvents>();
+    return !events || events->any(Es...);
+}
+
 // =============================
 // Systems(純粋版)
 // =============================
 
-// --- 追記: 方向遷移のヘルパ ---
+// --- 追記: 方向遷移のヘルパ(列挙子の並びで循環。分岐表なし) ---
 static inline PieceDirection rotate_next(PieceDirection currentDirection, int dir /*-1 or +1*/) {
-    if (dir == 0) return currentDirection;
-    // East=+1, West=-1 相当で循環
-    constexpr PieceDirection order[4] = {PieceDirection::North, PieceDirection::East,
-                                         PieceDirection::South, PieceDirection::West};
-    int idx = 0;
-    switch (currentDirection) {
-        case PieceDirection::North:
-            idx = 0;
-            break;
-        case PieceDirection::East:
-            idx = 1;
-            break;
-        case PieceDirection::South:
-            idx = 2;
-            break;
-        case PieceDirection::West:
-            idx = 3;
-            break;
-    }
-    idx = (idx + (dir > 0 ? +1 : -1) + 4) % 4;
-    return order[idx];
+    return rotated_direction(currentDirection, dir);
 }
 
 /**
@@ -244,7 +389,7 @@ static CommandList inputSystem_pure(
     WriteCommands<SoftDrop, MoveIntent, RotateIntent, HardDropRequest, HoldRequest> wr,
     const TetrisResources& res) {
     CommandList out;
-    const auto down_key = game_key::to_sdl_key(game_key::GameKey::DOWN);
+    using game_key::GameKey;
     auto v = ro.view<ActivePiece, SoftDrop>();
 
     auto moveView = ro.view<MoveIntent>();
@@ -255,19 +400,15 @@ static CommandList inputSystem_pure(
         {
             const auto& sd = v.template get<SoftDrop>(e);
             SoftDrop next = sd;
-            next.held = (down_key && res.input.held(*down_key));
+            next.held = game_key::held(res.input, GameKey::DOWN);
             out.emplace_back(wr.emplace_or_replace<SoftDrop>(e, next));
         }
 
         // 左右／回転は MoveIntent / RotateIntent を押下瞬間のみ積む(元コメント維持)
         // --- 修正: 左右は「押下瞬間のみ」1セル分の MoveIntent を積む ---
         int dx = 0;
-        if (const auto left = game_key::to_sdl_key(game_key::GameKey::LEFT);
-            left && res.input.pressed(*left))
-            dx -= 1;
-        if (const auto right = game_key::to_sdl_key(game_key::GameKey::RIGHT);
-            right && res.input.pressed(*right))
-            dx += 1;
+        if (game_key::pressed(res.input, GameKey::LEFT)) dx -= 1;
+        if (game_key::pressed(res.input, GameKey::RIGHT)) dx += 1;
 
         if (dx != 0) {
             MoveIntent mi{};
@@ -279,12 +420,8 @@ static CommandList inputSystem_pure(
 
         // --- 追記: 回転は押下瞬間のみ受理 ---
         int rot = 0;
-        if (const auto rl = game_key::to_sdl_key(game_key::GameKey::ROTATE_LEFT);
-            rl && res.input.pressed(*rl))
-            rot -= 1;
-        if (const auto rr = game_key::to_sdl_key(game_key::GameKey::ROTATE_RIGHT);
-            rr && res.input.pressed(*rr))
-            rot += 1;
+        if (game_key::pressed(res.input, GameKey::ROTATE_LEFT)) rot -= 1;
+        if (game_key::pressed(res.input, GameKey::ROTATE_RIGHT)) rot += 1;
 
         if (rot != 0) {
             RotateIntent ri{};
@@ -296,14 +433,12 @@ static CommandList inputSystem_pure(
         }
 
         // --- ハードドロップ要求(押下瞬間のみ) ---
-        if (const auto drop = game_key::to_sdl_key(game_key::GameKey::DROP);
-            drop && res.input.pressed(*drop)) {
+        if (game_key::pressed(res.input, GameKey::DROP)) {
             out.emplace_back(wr.emplace_or_replace<HardDropRequest>(e));
         }
 
         // --- 追記: ホールド要求(押下瞬間のみ) ---
-        if (const auto hold = game_key::to_sdl_key(game_key::GameKey::HOLD);
-            hold && res.input.pressed(*hold)) {
+        if (game_key::pressed(res.input, GameKey::HOLD)) {
             out.emplace_back(wr.emplace_or_replace<HoldRequest>(e));
         }
     }
@@ -319,12 +454,11 @@ static CommandList resolveHoldSystem_pure(
     CommandList out;
     if (!ro.valid(res.grid_e)) return out;
 
-    const auto& grid = ro.get<GridResource>(res.grid_e);
-    const int spawn_x = grid.origin_x + res.env.setting.spawn_col * grid.cellW;
-    const int spawn_y = grid.origin_y + res.env.setting.spawn_row * grid.cellH;
+    const int spawn_x = res.env.setting.spawn_col;
+    const int spawn_y = res.env.setting.spawn_row;
 
     // ★ ここから先は Command 側でエンティティを探す
-    out.emplace_back(Command{[grid_e = res.grid_e, spawn_x, spawn_y](entt::registry& r) {
+    out.emplace_back(Command{[spawn_x, spawn_y](entt::registry& r) {
         // ActivePiece + HoldRequest を持つエンティティを再検索
         auto v = r.view<ActivePiece, Position, TetriminoMeta, HoldRequest>();
         if (v.begin() == v.end()) {
@@ -332,7 +466,6 @@ static CommandList resolveHoldSystem_pure(
         }
         const entt::entity target = *v.begin();
 
-        auto& grid = r.get<GridResource>(grid_e);
         auto& held = r.ctx().get<HeldPiece>();
         auto& pq = r.ctx().get<PieceQueue>();
 
@@ -375,7 +508,7 @@ static CommandList resolveHoldSystem_pure(
         }
 
         meta.type = new_type;
-        meta.direction = PieceDirection::West;
+        meta.direction = kSpawnDirection;
         meta.status = PieceStatus::Falling;
         meta.rotationCount = 0;
         meta.minimumY = spawn_y;
@@ -396,6 +529,8 @@ static CommandList resolveHoldSystem_pure(
         if (r.any_of<HoldRequest>(target)) {
             r.remove<HoldRequest>(target);
         }
+        // エンティティは使い回すので on_construct は鳴らない。入れ替わりをここで知らせる
+        if (auto* events = r.ctx().find<TetrisEvents>()) events->raise(FrameEvent::PieceSpawned);
     }});
 
     return out;
@@ -476,32 +611,23 @@ static CommandList resolveRotationSystem_pure(
         const PieceDirection ndir = rotate_next(meta.direction, (ri.dir > 0 ? +1 : -1));
 
         // O ミノも一応方向だけは変えるが、形状は同一なので見た目は変わらない
-        const auto shape = cells_for(meta.type, ndir);
-
-        auto can_place = [&](int px, int py) -> bool {
-            for (auto [rr, cc] : shape) {
-                const int col = (px - grid->origin_x) / grid->cellW + cc;
-                const int row = (py - grid->origin_y) / grid->cellH + rr;
-                if (col < 0 || col >= grid->cols || row < 0 || row >= grid->rows) return false;
-                if (grid->occ[grid->index(row, col)] == CellStatus::Filled) return false;
-            }
-            return true;
-        };
+        // 回転後のマスクとキック列はどちらもコンパイル時の表から引く
+        const PieceMask& mask = piece_mask(meta.type, ndir);
 
         // ★ ここが SRS 本体：キックテーブルを順に試す
-        const auto kicks = srs_kicks(meta.type, meta.direction, ndir);
+        const auto& kicks = srs_kicks(meta.type, meta.direction, ndir);
 
         bool rotated = false;
-        int applied_px = pos.x;
-        int applied_py = pos.y;
+        int applied_x = pos.x;
+        int applied_y = pos.y;
 
         for (const auto& k : kicks) {
-            const int test_px = pos.x + k.dx * grid->cellW;
-            const int test_py = pos.y + k.dy * grid->cellH;
-            if (can_place(test_px, test_py)) {
+            const int test_x = pos.x + k.dx;
+            const int test_y = pos.y + k.dy;
+            if (grid->occ.fits(mask, test_y, test_x)) {
                 rotated = true;
-                applied_px = test_px;
-                applied_py = test_py;
+                applied_x = test_x;
+                applied_y = test_y;
                 break;
             }
         }
@@ -525,7 +651,7 @@ static CommandList resolveRotationSystem_pure(
 
         // 位置とメタ情報を反映、LockTimer 解除
         out.emplace_back(wr.emplace_or_replace<TetriminoMeta>(e, meta));
-        out.emplace_back(wr.emplace_or_replace<Position>(e, applied_px, applied_py));
+        out.emplace_back(wr.emplace_or_replace<Position>(e, applied_x, applied_y));
 
         // ★ 修正ポイント:
         //    「着地(Landed) → 落下(Falling) に変わったときだけ」LockTimer をリセットする
@@ -563,23 +689,11 @@ static CommandList resolveLateralSystem_pure(
         }
         if (steps == 0) continue;
 
-        const int step_px = res.env.setting.cellWidth;
-        const auto shape = cells_for(meta.type, meta.direction);
-
-        auto can_place = [&](int px, int py) -> bool {
-            for (auto [rr, cc] : shape) {
-                const int col = (px - grid->origin_x) / grid->cellW + cc;
-                const int row = (py - grid->origin_y) / grid->cellH + rr;
-                if (col < 0 || col >= grid->cols || row < 0 || row >= grid->rows) return false;
-                if (grid->occ[grid->index(row, col)] == CellStatus::Filled) return false;
-            }
-            return true;
-        };
-
+        const PieceMask& mask = piece_mask(meta.type, meta.direction);
         const int dir = (steps > 0) ? +1 : -1;
         for (int i = 0; i < std::abs(steps); ++i) {
-            const int nx = pos.x + dir * step_px;
-            if (!can_place(nx, pos.y)) {
+            const int nx = pos.x + dir;
+            if (!grid->occ.fits(mask, pos.y, nx)) {
                 // 壁/ブロックに当たる場合はそれ以上進めない(残りは破棄)
                 break;
             }
@@ -645,22 +759,10 @@ static CommandList resolveDropSystem_pure(
         out.emplace_back(wr.remove<MoveIntent>(e));
         if (steps <= 0) continue;
 
-        const int step_px = res.env.setting.cellHeight;
-        const auto shape = cells_for(meta.type, meta.direction);
-
-        auto can_place = [&](int px, int py) -> bool {
-            for (auto [rr, cc] : shape) {
-                const int col = (px - grid->origin_x) / grid->cellW + cc;
-                const int row = (py - grid->origin_y) / grid->cellH + rr;
-                if (col < 0 || col >= grid->cols || row < 0 || row >= grid->rows) return false;
-                if (grid->occ[grid->index(row, col)] == CellStatus::Filled) return false;
-            }
-            return true;
-        };
-
+        const PieceMask& mask = piece_mask(meta.type, meta.direction);
         for (int i = 0; i < steps; ++i) {
-            const int ny = pos.y + step_px;
-            if (!can_place(pos.x, ny)) {
+            const int ny = pos.y + 1;
+            if (!grid->occ.fits(mask, ny, pos.x)) {
                 meta.status = PieceStatus::Landed;
                 break;
             }
@@ -693,24 +795,8 @@ static CommandList hardDropSystem_pure(
         auto pos = v.template get<Position>(e);
         auto meta = v.template get<TetriminoMeta>(e);
 
-        const int step_py = res.env.setting.cellHeight;  // 1セルのピクセル
-        const auto shape = cells_for(meta.type, meta.direction);
-
-        auto can_place = [&](int px, int py) -> bool {
-            for (auto [rr, cc] : shape) {
-                const int col = (px - grid->origin_x) / grid->cellW + cc;
-                const int row = (py - grid->origin_y) / grid->cellH + rr;
-                if (col < 0 || col >= grid->cols || row < 0 || row >= grid->rows) return false;
-                if (grid->occ[grid->index(row, col)] == CellStatus::Filled) return false;
-            }
-            return true;
-        };
-
-        // 可能な限り下へ
-        int ny = pos.y;
-        while (can_place(pos.x, ny + step_py)) ny += step_py;
-
-        pos.y = ny;
+        // 可能な限り下へ(ゴーストと同じ定数時間の落下距離)
+        pos = compute_ghost_position(*grid, pos, meta);
 
         // 設置：即ロック扱い(次フレームで確実に Merge)
         meta.status = PieceStatus::Landed;
@@ -733,7 +819,7 @@ static CommandList lockAndMergeSystem_pure(
     WriteCommands<GridResource> wr, const TetrisResources& res) {
     CommandList out;
     if (!ro.valid(res.grid_e)) return out;
-    auto grid = ro.get<GridResource>(res.grid_e);  // 書換え用コピー(最後に置換コマンドで反映)
+    const auto& grid = ro.get<GridResource>(res.grid_e);
 
     std::vector<entt::entity> to_fix;
     auto v = ro.view<ActivePiece, Position, TetriminoMeta, LockTimer>();
@@ -749,25 +835,30 @@ static CommandList lockAndMergeSystem_pure(
         const auto& pos = v.template get<Position>(e);
         const auto& meta = v.template get<TetriminoMeta>(e);
 
-        std::array<Coord, 4> cells = cells_for(meta.type, meta.direction);
-        for (auto [rr, cc] : cells) {
-            const int col = (pos.x - grid.origin_x) / grid.cellW + cc;
-            const int row = (pos.y - grid.origin_y) / grid.cellH + rr;
+        const int col0 = pos.x;
+        const int row0 = pos.y;
+
+        // 固定するセルだけを差分として発行(Grid 全体のコピーはしない)
+        GridPatch patch{};
+        for (auto [rr, cc] : cells_for(meta.type, meta.direction)) {
+            const int col = col0 + cc;
+            const int row = row0 + rr;
             if (0 <= row && row < grid.rows && 0 <= col && col < grid.cols) {
-                const int idx = grid.index(row, col);
-                grid.occ[idx] = CellStatus::Filled;
-                grid.occ_type[idx] = meta.type;  // ★ 追加：設置したピース種別を保持
+                // ★ 追加：設置したピース種別を保持
+                patch.writes[static_cast<std::size_t>(patch.write_count++)] = {row, col,
+                                                                               meta.type};
             }
         }
+        out.emplace_back(wr.patch<GridResource>(res.grid_e, std::move(patch)));
+        out.emplace_back(wr.raise(FrameEvent::PieceLocked));
 
         // アクティブピース破棄
         out.emplace_back(wr.destroy(e));
 
         // 新規スポーン(7-Bag)
         out.emplace_back(wr.create_then([&](entt::registry& r, entt::entity ne) {
-            auto& g = r.get<GridResource>(res.grid_e);
-            const int spawn_x = g.origin_x + res.env.setting.spawn_col * g.cellW;
-            const int spawn_y = g.origin_y + res.env.setting.spawn_row * g.cellH;
+            const int spawn_x = res.env.setting.spawn_col;
+            const int spawn_y = res.env.setting.spawn_row;
 
             // ★ 追加：新しいピース出現時にホールド使用フラグをリセット
             if (auto* held = r.ctx().find<HeldPiece>()) {
@@ -780,7 +871,7 @@ static CommandList lockAndMergeSystem_pure(
             const PieceType next_type = take_next(piece_queue);
 
             r.emplace<Position>(ne, spawn_x, spawn_y);
-            r.emplace<TetriminoMeta>(ne, next_type, PieceDirection::West, PieceStatus::Falling, 0,
+            r.emplace<TetriminoMeta>(ne, next_type, kSpawnDirection, PieceStatus::Falling, 0,
                                      spawn_y);
             r.emplace<ActivePiece>(ne);
 
@@ -792,53 +883,59 @@ static CommandList lockAndMergeSystem_pure(
         }));
     }
 
-    // Grid 書換えを発行
-    out.emplace_back(wr.emplace_or_replace<GridResource>(res.grid_e, grid));
     return out;
 }
 
 // =============================
 // ライン消去(純粋)
 // =============================
-static CommandList lineClearSystem_pure(ReadOnlyView<GridResource> ro,
-                                        WriteCommands<GridResource> wr,
+static CommandList lineClearSystem_pure(ReadOnlyView<GridResource, GarbageMeter> ro,
+                                        WriteCommands<GridResource, GarbageMeter, GameOver> wr,
                                         const TetrisResources& res) {
     CommandList out;
     if (!ro.valid(res.grid_e)) return out;
-    auto grid = ro.get<GridResource>(res.grid_e);  // コピーを編集し、最後に置換
+    const auto& grid = ro.get<GridResource>(res.grid_e);
 
-    int write = grid.rows - 1;
+    // 満杯判定は 1 行 1 比較(ビットボード)。揃った行が無ければ何も発行しない
+    GridPatch patch{};
     for (int r0 = grid.rows - 1; r0 >= 0; --r0) {
-        bool full = true;
-        for (int c0 = 0; c0 < grid.cols; ++c0) {
-            if (grid.occ[grid.index(r0, c0)] != CellStatus::Filled) {
-                full = false;
-                break;
-            }
-        }
-        if (!full) {
-            if (write != r0) {
-                for (int c0 = 0; c0 < grid.cols; ++c0) {
-                    const int src = grid.index(r0, c0);
-                    const int dst = grid.index(write, c0);
-                    grid.occ[dst] = grid.occ[src];
-                    grid.occ_type[dst] = grid.occ_type[src];  // ★ 追加：色も移動
+        if (grid.occ.row_full(r0)) patch.cleared_rows.push_back(r0);
+    }
+
+    // ★ 追加：対戦中は消した行数をおじゃまに換算し、受けている分と相殺して余りを送る。
+    //   消さずに固定したときだけ、受けている分を下からせり上げる
+    //   (固定はこのフレームの PieceLocked で知る。ライン消去より前のフェーズで立つ)
+    if (const auto meters = ro.view<GarbageMeter>(); meters.contains(res.grid_e)) {
+        GarbageMeter m = meters.template get<const GarbageMeter>(res.grid_e);
+        const auto* events = ro.reg.ctx().find<TetrisEvents>();
+        const bool locked = events && events->any(FrameEvent::PieceLocked);
+        const int cleared = static_cast<int>(patch.cleared_rows.size());
+        if (locked || cleared > 0) {
+            const int attack = kGarbageForLines[static_cast<std::size_t>(std::min(cleared, 4))];
+            const int offset = std::min(attack, m.incoming);
+            m.incoming -= offset;
+            m.outgoing += attack - offset;
+            m.lines_cleared += cleared;
+            if (cleared == 0 && m.incoming > 0) {
+                patch.garbage_lines = std::min(m.incoming, grid.rows);
+                patch.garbage_hole = next_garbage_hole(m.hole_state, grid.cols);
+                m.incoming = 0;
+                // 上端から押し出されるブロックがあれば窒息
+                for (int r0 = 0; r0 < patch.garbage_lines; ++r0) {
+                    if (!grid.occ.row_empty(r0)) {
+                        out.emplace_back(
+                            wr.emplace_or_replace<GameOver>(res.grid_e, GameOver{true}));
+                        break;
+                    }
                 }
             }
-            --write;
-        }
-    }
-    for (int r0 = write; r0 >= 0; --r0) {
-        for (int c0 = 0; c0 < grid.cols; ++c0) {
-            const int idx = grid.index(r0, c0);
-            grid.occ[idx] = CellStatus::Empty;
-            // ★ 任意：既定値でクリア(未使用だが保守性のため)
-            grid.occ_type[idx] = PieceType::I;
+            out.emplace_back(wr.emplace_or_replace<GarbageMeter>(res.grid_e, m));
         }
     }
+    if (patch.cleared_rows.empty() && patch.garbage_lines == 0) return out;
 
-    out.emplace_back(wr.emplace_or_replace<GridResource>(res.grid_e, grid));
-    (void)res;
+    if (!patch.cleared_rows.empty()) out.emplace_back(wr.raise(FrameEvent::RowsCleared));
+    out.emplace_back(wr.patch<GridResource>(res.grid_e, std::move(patch)));
     return out;
 }
 
@@ -865,19 +962,7 @@ static CommandList gameOverCheckSystem_pure(
         const auto& pos = v.template get<Position>(e);
         const auto& meta = v.template get<TetriminoMeta>(e);
 
-        const auto shape = cells_for(meta.type, meta.direction);
-
-        auto can_place = [&](int px, int py) -> bool {
-            for (auto [rr, cc] : shape) {
-                const int col = (px - grid->origin_x) / grid->cellW + cc;
-                const int row = (py - grid->origin_y) / grid->cellH + rr;
-                if (col < 0 || col >= grid->cols || row < 0 || row >= grid->rows) return false;
-                if (grid->occ[grid->index(row, col)] == CellStatus::Filled) return false;
-            }
-            return true;
-        };
-
-        if (!can_place(pos.x, pos.y)) {
+        if (!can_place_on_grid(*grid, meta, pos.x, pos.y)) {
             // ★ 追加：ゲームオーバーフラグを ON
             const auto gameover = GameOver{true};
             out.emplace_back(wr.emplace_or_replace<GameOver>(res.grid_e, gameover));
@@ -888,17 +973,61 @@ static CommandList gameOverCheckSystem_pure(
     return out;
 }
 
+// EnTT のシグナルから TetrisEvents へ(make_world で接続する)
+inline void raise_board_changed(entt::registry& r, entt::entity) {
+    if (auto* events = r.ctx().find<TetrisEvents>()) events->raise(FrameEvent::BoardChanged);
+}
+inline void raise_piece_spawned(entt::registry& r, entt::entity) {
+    if (auto* events = r.ctx().find<TetrisEvents>()) events->raise(FrameEvent::PieceSpawned);
+}
+
 // =============================
 // 外部公開 API
 // =============================
 
+// 入力記録のヘッダ: 再生結果を左右する設定をすべて写す(replay はこれと一致する設定でしか再生しない)
+export inline input_record::RecordingHeader recording_header(
+    const global_setting::GlobalSetting& cfg, std::uint32_t seed) {
+    input_record::RecordingHeader h{};
+    h.seed = seed;
+    h.frame_rate = static_cast<std::uint16_t>(cfg.frameRate);
+    h.columns = static_cast<std::uint16_t>(cfg.gridColumns);
+    h.rows = static_cast<std::uint16_t>(cfg.gridRows);
+    h.drop_rate = cfg.dropRate;
+    h.lock_delay_sec = cfg.lockDelaySec;
+    h.spawn_col = static_cast<std::int16_t>(cfg.spawn_col);
+    h.spawn_row = static_cast<std::int16_t>(cfg.spawn_row);
+    h.max_drops_per_frame = static_cast<std::uint16_t>(cfg.maxDropsPerFrame);
+    h.max_rotation_locks = static_cast<std::uint16_t>(cfg.maxRotationLocks);
+    return h;
+}
+
 // ワールド生成
+//   seed(なければ GlobalSetting::seed)を指定すると 7-Bag の出現順が固定され、決定的に再現できる
+//   standalone = false は、対戦や一括シミュレーションのように他の World と並べて進める World 用。
+//   単独では再生できないので recordPath があっても入力を記録せず、共有プロファイラも付けない
+//   (プロファイラは 1 フレームに 1 つの World が end_frame する前提で、別スレッドから触れない)
 export inline tl::expected<World, std::string> make_world(
-    const Env<global_setting::GlobalSetting>& env) {
+    const Env<global_setting::GlobalSetting>& env, std::optional<std::uint32_t> seed = std::nullopt,
+    bool standalone = true) {
+    const auto& cfg = env.setting;
+    if (!seed) seed = cfg.seed;
+    // 1 行を 1 つのビットマスクで持つため列数に上限がある
+    if (cfg.gridColumns <= 0 || cfg.gridColumns > kMaxBoardColumns || cfg.gridRows <= 0) {
+        return tl::make_unexpected("grid size out of range (columns must be 1.." +
+                                   std::to_string(kMaxBoardColumns) + ")");
+    }
+
     World world{};
     world.registry = std::make_shared<entt::registry>();
     auto& registry = *world.registry;
-    const auto& cfg = env.setting;
+
+    // 盤面の書き換え・ピースの出現をイベントとして拾う(以下の初期化分も最初のフレームで見える)
+    registry.ctx().emplace<TetrisEvents>();
+    if constexpr (kCheckBoardWrites) registry.ctx().emplace<BoardWriteCheck>();
+    registry.on_construct<GridResource>().connect<&raise_board_changed>();
+    registry.on_update<GridResource>().connect<&raise_board_changed>();
+    registry.on_construct<ActivePiece>().connect<&raise_piece_spawned>();
 
     // GridResource(singleton 的エンティティ)
     world.grid_singleton = registry.create();
@@ -911,18 +1040,34 @@ export inline tl::expected<World, std::string> make_world(
     grid.cellH = cfg.cellHeight;
     grid.origin_x = cfg.holdAreaWidth;  // 左側にホールドエリア分のオフセット
     grid.origin_y = 0;
-    grid.occ.assign(grid.rows * grid.cols, CellStatus::Empty);
+    grid.occ.reset(grid.rows, grid.cols);
     grid.occ_type.assign(grid.rows * grid.cols, PieceType::I);  // 初期値は未使用だが埋めておく
 
     // アクティブピース
-    const int spawn_x = grid.origin_x + cfg.spawn_col * grid.cellW;
-    const int spawn_y = grid.origin_y + cfg.spawn_row * grid.cellH;
+    const int spawn_x = cfg.spawn_col;
+    const int spawn_y = cfg.spawn_row;
 
     // 7-Bag 初期化と取得
     // registry のコンテキストに PieceQueue を保持(初回のみ emplace)
-    auto& pq = registry.ctx().emplace<PieceQueue>();
+    auto& pq = seed ? registry.ctx().emplace<PieceQueue>(*seed)
+                    : registry.ctx().emplace<PieceQueue>();
+    // 決定的モードで記録先があれば、毎フレームの入力エッジを記録する(World 破棄時に書き出し)
+    //   再スタートしたゲームは番号付きの別ファイルへ書く(前のゲームの記録を上書きしない)
+    if (seed && standalone && !cfg.recordPath.empty()) {
+        const std::uint32_t game = cfg.recorded_games ? ++*cfg.recorded_games : 1;
+        registry.ctx().emplace<input_record::InputRecorder>(
+            recording_header(cfg, *seed), input_record::numbered_path(cfg.recordPath, game));
+    }
     // ★ 追加：ホールド情報もコンテキストに保持
     auto& held = registry.ctx().emplace<HeldPiece>();
+    // フレーム単位のコマンドアリーナ(run_schedule が毎フレームリセットして使う)
+    registry.ctx().emplace<CommandArena>();
+    // プロファイラ有効ビルドのみ: 設定が持つプロファイラへ System ごとの計測を記録する
+    if constexpr (profiler::kEnabled) {
+        if (standalone && cfg.frame_profiler) {
+            registry.ctx().emplace<profiler::SharedProfiler>(cfg.frame_profiler);
+        }
+    }
     held.used_in_this_turn = false;
     if (pq.queue.empty()) {
         refill_bag(pq);
@@ -931,7 +1076,7 @@ export inline tl::expected<World, std::string> make_world(
 
     world.active = registry.create();
     registry.emplace<Position>(world.active, spawn_x, spawn_y);
-    registry.emplace<TetriminoMeta>(world.active, first_type, PieceDirection::West,
+    registry.emplace<TetriminoMeta>(world.active, first_type, kSpawnDirection,
                                     PieceStatus::Falling, 0, spawn_y);
     registry.emplace<ActivePiece>(world.active);
 
@@ -943,30 +1088,121 @@ export inline tl::expected<World, std::string> make_world(
     return world;
 }
 
+// 1 フレーム分のシステム順(コンパイル時に固定。毎フレームの構築・型消去呼び出しなし)
+//   盤面全体を見る 2 つはイベント駆動: ピースが動くだけのフレームでは実行しない
+//     ライン消去       … 盤面が書き換わったとき(固定・せり上げ・外からの書き換え)
+//     ゲームオーバー判定 … 新しいピースが出たとき、または盤面が書き換わったとき
+using TetrisSchedule = StaticSchedule<TetrisResources,
+                                      StaticPhase<&inputSystem_pure>,
+                                      StaticPhase<&resolveHoldSystem_pure>,
+                                      StaticPhase<&gravitySystem_pure>,
+                                      StaticPhase<&resolveRotationSystem_pure>,
+                                      StaticPhase<&resolveLateralSystem_pure>,
+                                      StaticPhase<&hardDropSystem_pure>,
+                                      StaticPhase<&resolveDropSystem_pure>,
+                                      StaticPhase<&lockTimerTickSystem_pure>,
+                                      StaticPhase<&lockAndMergeSystem_pure>,
+                                      StaticPhaseIf<&triggered_by<FrameEvent::BoardChanged>,
+                                                    &lineClearSystem_pure>,
+                                      StaticPhaseIf<&triggered_by<FrameEvent::PieceSpawned,
+                                                                  FrameEvent::BoardChanged>,
+                                                    &gameOverCheckSystem_pure>>;
+
 // 1フレーム更新(純粋システムのスケジューラで実行)
+// 入力記録があれば、このフレームの入力を 1 フレーム分追記する
+inline void record_input_frame(const World& w, const input::Input& in) {
+    if (auto* rec = w.registry->ctx().find<input_record::InputRecorder>()) rec->record_frame(in);
+}
+
+// 盤面の占有ビットの指紋(BoardWriteCheck 用。色は System の起動条件に関わらないので見ない)
+inline std::uint64_t board_fingerprint(const GridResource& grid) noexcept {
+    std::uint64_t h = 1469598103934665603ull;
+    for (int row = 0; row < grid.rows; ++row) {
+        h = (h ^ grid.occ.row_bits(row)) * 1099511628211ull;
+        h = (h ^ grid.garbage_bits(row)) * 1099511628211ull;
+    }
+    return h;
+}
+
+// 前のフレームの終わりから、BoardChanged なしに盤面が変わっていればログに出して数える
+inline void check_board_writes(entt::registry& world, entt::entity grid_e) {
+    auto* check = world.ctx().find<BoardWriteCheck>();
+    auto* events = world.ctx().find<TetrisEvents>();
+    const auto* grid = world.try_get<GridResource>(grid_e);
+    if (!check || !events || !grid || events->any(FrameEvent::BoardChanged)) return;
+    if (board_fingerprint(*grid) == check->fingerprint) return;
+    ++check->unsignaled;
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                 "GridResource was written without raising BoardChanged (use patch)");
+}
+
 export inline void step_world(const World& w, const Env<GlobalSetting>& env) {
     if (!w.registry) return;
     auto& world = *w.registry;
     if (!world.valid(w.grid_singleton)) return;
 
+    record_input_frame(w, env.input);
+    if constexpr (kCheckBoardWrites) check_board_writes(world, w.grid_singleton);
+
     // Resources 構築
     TetrisResources res{env.input, env, w.grid_singleton};
 
-    Schedule<TetrisResources> sch{{
-        Phase<TetrisResources>{{make_system<TetrisResources>(inputSystem_pure)}},
-        Phase<TetrisResources>{{make_system<TetrisResources>(resolveHoldSystem_pure)}},
-        Phase<TetrisResources>{{make_system<TetrisResources>(gravitySystem_pure)}},
-        Phase<TetrisResources>{{make_system<TetrisResources>(resolveRotationSystem_pure)}},
-        Phase<TetrisResources>{{make_system<TetrisResources>(resolveLateralSystem_pure)}},
-        Phase<TetrisResources>{{make_system<TetrisResources>(hardDropSystem_pure)}},
-        Phase<TetrisResources>{{make_system<TetrisResources>(resolveDropSystem_pure)}},
-        Phase<TetrisResources>{{make_system<TetrisResources>(lockTimerTickSystem_pure)}},
-        Phase<TetrisResources>{{make_system<TetrisResources>(lockAndMergeSystem_pure)}},
-        Phase<TetrisResources>{{make_system<TetrisResources>(lineClearSystem_pure)}},
-        Phase<TetrisResources>{{make_system<TetrisResources>(gameOverCheckSystem_pure)}},
-    }};
-
-    run_schedule(world, res, sch);
+    run_schedule(world, res, TetrisSchedule{});
+    // このフレームのイベントを閉じる(フレームの間に外から書き換えた分は次のフレームで見える)
+    if (auto* events = world.ctx().find<TetrisEvents>()) events->end_frame();
+    if constexpr (kCheckBoardWrites) {
+        if (auto* check = world.ctx().find<BoardWriteCheck>()) {
+            check->fingerprint = board_fingerprint(world.get<GridResource>(w.grid_singleton));
+        }
+    }
+
+    if constexpr (profiler::kEnabled) {
+        if (auto* shared = world.ctx().find<profiler::SharedProfiler>()) {
+            // report_every を指定したときだけ、その間隔で直近の分位点をログに出す
+            if ((*shared)->end_frame()) {
+                SDL_Log("frame profile (us):\n%s", (*shared)->report().c_str());
+            }
+        }
+    }
+}
+
+// ★ 追加: System を 1 つだけ実行する入口(ベンチマーク用。コマンド適用まで含む)
+//   ライン消去: 揃った行を取り除いて詰める
+export inline void run_line_clear_system(const World& w, const Env<GlobalSetting>& env) {
+    if (!w.registry) return;
+    TetrisResources res{env.input, env, w.grid_singleton};
+    run_schedule(*w.registry, res,
+                 StaticSchedule<TetrisResources, StaticPhase<&lineClearSystem_pure>>{});
+}
+
+//   回転解決: アクティブピースを dir(-1 / +1)方向へ SRS キック付きで回す
+export inline void run_rotation_system(const World& w, const Env<GlobalSetting>& env, int dir) {
+    if (!w.registry || !w.registry->valid(w.active)) return;
+    w.registry->emplace_or_replace<RotateIntent>(w.active, RotateIntent{dir});
+    TetrisResources res{env.input, env, w.grid_singleton};
+    run_schedule(*w.registry, res,
+                 StaticSchedule<TetrisResources, StaticPhase<&resolveRotationSystem_pure>>{});
+}
+
+// シグナルを通さない盤面の書き換えを検出した回数(kCheckBoardWrites が false なら常に 0)
+export inline std::uint32_t unsignaled_board_writes(const World& w) {
+    if (!w.registry) return 0;
+    const auto* check = w.registry->ctx().find<BoardWriteCheck>();
+    return check ? check->unsignaled : 0;
+}
+
+// 直近の step_world の中で ev が起きたか
+export inline bool happened_last_frame(const World& w, FrameEvent ev) {
+    if (!w.registry) return false;
+    const auto* events = w.registry->ctx().find<TetrisEvents>();
+    return events && events->happened_last_frame(ev);
+}
+
+// 直近の step_world で発行されたコマンドの確保統計
+export inline CommandArenaStats command_stats(const World& w) {
+    if (!w.registry) return {};
+    if (const auto* arena = w.registry->ctx().find<CommandArena>()) return arena->stats();
+    return {};
 }
 
 export bool is_gameover(const World& w) {
@@ -979,256 +1215,723 @@ export bool is_gameover(const World& w) {
     return false;
 }
 
-inline void render_grid(const World& world, SDL_Renderer* const renderer) {
-    auto& registry = *world.registry;
-    if (auto* grid = registry.try_get<GridResource>(world.grid_singleton)) {
-        for (int row = 0; row < grid->rows; ++row) {
-            for (int col = 0; col < grid->cols; ++col) {
-                SDL_Rect rect = grid->rect_rc(row, col);
-
-                // 塗り
-                if (grid->occ[grid->index(row, col)] == CellStatus::Filled) {
-                    // ★ 追加：設置済みテトリミノの色で描画
-                    const PieceType t = grid->occ_type[grid->index(row, col)];
-                    const SDL_Color color = to_color(t);
-                    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+// =============================
+// ★ 追加: 対戦(おじゃまのやり取り)
+//   World 同士は直接触らない。対戦側が step_world の後で送る行数を回収し、
+//   相手の World へ次のフレームの前に渡す(World ごとの処理はスレッドをまたがない)
+// =============================
 
-                } else {
-                    SDL_SetRenderDrawColor(renderer, 230, 230, 230, 255);
-                }
-                SDL_RenderFillRect(renderer, &rect);
+// おじゃまのやり取りを有効にする(hole_seed で穴の列の並びが決まる)
+export inline void enable_garbage(const World& w, std::uint32_t hole_seed) {
+    if (!w.registry || !w.registry->valid(w.grid_singleton)) return;
+    GarbageMeter meter{};
+    meter.hole_state = hole_seed;
+    w.registry->emplace_or_replace<GarbageMeter>(w.grid_singleton, meter);
+}
 
-                // 枠
-                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-                SDL_RenderDrawRect(renderer, &rect);
-            }
-        }
-        // 外枠
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_Rect outer{grid->origin_x, grid->origin_y, grid->cols * grid->cellW,
-                       grid->rows * grid->cellH};
-        SDL_RenderDrawRect(renderer, &outer);
-    }
+// 直近の step_world までに溜まった送る行数を取り出す(取り出した分は 0 に戻る)
+export inline int take_outgoing_garbage(const World& w) {
+    if (!w.registry || !w.registry->valid(w.grid_singleton)) return 0;
+    auto* m = w.registry->try_get<GarbageMeter>(w.grid_singleton);
+    if (!m) return 0;
+    return std::exchange(m->outgoing, 0);
 }
 
-inline void render_tetrimino_cells(SDL_Renderer* const renderer, int originX, int originY,
-                                   const PieceType& type, const PieceDirection& direction,
-                                   int cellW, int cellH, SDL_Color color) {
-    // 色設定
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+// 相手から lines 行を受け取る(次にピースを固定したとき、消していなければせり上がる)
+export inline void receive_garbage(const World& w, int lines) {
+    if (!w.registry || !w.registry->valid(w.grid_singleton) || lines <= 0) return;
+    if (auto* m = w.registry->try_get<GarbageMeter>(w.grid_singleton)) m->incoming += lines;
+}
 
-    // 形状セル
-    const auto cells = cells_for(type, direction);
-    for (const auto& c : cells) {
-        const int x = originX + static_cast<int>(c.second) * cellW;
-        const int y = originY + static_cast<int>(c.first) * cellH;
-        SDL_Rect rect = {x, y, cellW, cellH};
-        SDL_RenderFillRect(renderer, &rect);
-    }
+// おじゃまメーターの現在値(対戦でない World は nullopt)
+export inline std::optional<GarbageMeter> garbage_meter(const World& w) {
+    if (!w.registry || !w.registry->valid(w.grid_singleton)) return std::nullopt;
+    const auto* m = w.registry->try_get<GarbageMeter>(w.grid_singleton);
+    return m ? std::optional<GarbageMeter>{*m} : std::nullopt;
 }
 
-inline void render_current_tetrimino(const World& world, SDL_Renderer* const renderer) {
-    auto& registry = *world.registry;
-    // ActivePiece 描画(TetriMino の描画を流用 -> ECS ローカルで置換)
-    auto view = registry.view<const ActivePiece, const Position, const TetriminoMeta>();
+// =============================
+// ★ 追加: 配置探索(ヒント・CPU 用。探索本体は PlacementSearch モジュール)
+// =============================
+
+// 操作中ピースの状態(なければ nullopt)
+export inline std::optional<placement::PieceState> active_piece_state(const World& w) {
+    if (!w.registry) return std::nullopt;
+    auto view = w.registry->view<const ActivePiece, const Position, const TetriminoMeta>();
     for (auto e : view) {
         const auto& pos = view.get<const Position>(e);
         const auto& meta = view.get<const TetriminoMeta>(e);
+        return placement::PieceState{meta.type, meta.direction, pos.x, pos.y};
+    }
+    return std::nullopt;
+}
+
+// 盤面・操作中ピース・ホールド・NEXT から最善の配置を探す(ゲームオーバー後は nullopt)
+export inline std::optional<placement::Plan> plan_placement(
+    const World& w, const Env<GlobalSetting>& env, const placement::SearchOptions& opt = {},
+    WorkStealingPool* pool = nullptr) {
+    if (!w.registry || is_gameover(w)) return std::nullopt;
+    const auto& r = *w.registry;
+    const auto* grid = r.try_get<GridResource>(w.grid_singleton);
+    const auto current = active_piece_state(w);
+    if (!grid || !current) return std::nullopt;
+
+    // 読む手数分だけ NEXT を写す(ホールドが空なら入れ替えで 1 つ前倒しに使う)
+    std::vector<PieceType> preview;
+    if (const auto* pq = r.ctx().find<PieceQueue>()) {
+        const auto n = std::min(pq->queue.size(), static_cast<std::size_t>(std::max(opt.depth, 1)));
+        preview.assign(pq->queue.begin(), pq->queue.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+
+    placement::SearchRequest req{};
+    req.board = &grid->occ;
+    req.current = *current;
+    if (const auto* held = r.ctx().find<HeldPiece>()) {
+        req.held = held->held_type;
+        req.hold_available = !held->used_in_this_turn;
+    }
+    req.preview = preview;
+    req.spawn_col = env.setting.spawn_col;
+    req.spawn_row = env.setting.spawn_row;
+    req.spawn_dir = kSpawnDirection;
+    return placement::best_plan(req, opt, pool);
+}
+
+// =============================
+// ★ 追加: 状態の snapshot / restore(1 手戻し・ロールバック用)
+//   registry を丸ごと複製せず、シミュレーションを決める値だけを写す:
+//   盤面(ビットボード＋色)、ゲームオーバー、操作中ピースのコンポーネント、
+//   PieceQueue(乱数生成器の状態を含む)、HeldPiece、対戦中ならおじゃまメーター。
+//   フレーム境界では MoveIntent などの要求コンポーネントは残らないので写さない(戻すときは消す)。
+//   InputRecorder / CommandArena / 描画キャッシュは対象外。
+// =============================
+
+// PieceQueue の長さの上限(take_next は 7 未満で 1 Bag 足すので最大 2 Bag)
+inline constexpr std::size_t kSnapshotQueueCapacity = 14;
 
-        const auto* grid = registry.try_get<GridResource>(world.grid_singleton);
-        const int cell_width = grid ? grid->cellW : 30;
-        const int cell_height = grid ? grid->cellH : 30;
+/**
+ * @brief World 1 フレーム分の値
+ *   同じ盤面サイズへ繰り返し保存するときは、盤面のバッファを使い回す(確保なし)
+ */
+export struct WorldSnapshot {
+    std::uint64_t frame{0};
+    GridResource grid;
+    bool gameover{false};
+
+    bool has_active{false};
+    Position pos;
+    TetriminoMeta meta;
+    Gravity gravity;
+    FallAccCells fall;
+    SoftDrop soft_drop;
+    std::optional<LockTimer> lock_timer;
+
+    std::array<PieceType, kSnapshotQueueCapacity> queue{};
+    std::uint8_t queue_size{0};
+    std::mt19937 rng;
+    HeldPiece held;
+    std::optional<GarbageMeter> garbage;  // 対戦でない World は nullopt
+};
+
+// 操作中ピースのエンティティ(なければ entt::null)
+export inline entt::entity active_entity(const World& w) {
+    if (!w.registry) return entt::null;
+    auto view = w.registry->view<const ActivePiece>();
+    return view.empty() ? entt::entity{entt::null} : *view.begin();
+}
 
-        // ★ 追加：ゴースト描画(落下予定位置のシルエット)
-        if (grid) {
-            const Position ghostPos = compute_ghost_position(*grid, pos, meta);
+// World の現在の状態を out へ写す(盤面がない・NEXT が長すぎるときは false)
+export inline bool save_snapshot(const World& w, WorldSnapshot& out) {
+    if (!w.registry) return false;
+    const auto& r = *w.registry;
+    const auto* grid = r.try_get<GridResource>(w.grid_singleton);
+    const auto* pq = r.ctx().find<PieceQueue>();
+    if (!grid || !pq || pq->queue.size() > kSnapshotQueueCapacity) return false;
+
+    out.grid = *grid;  // 同じサイズならバッファへ上書きするだけ
+    out.gameover = is_gameover(w);
+
+    const entt::entity e = active_entity(w);
+    out.has_active = e != entt::null && r.all_of<Position, TetriminoMeta>(e);
+    if (out.has_active) {
+        out.pos = r.get<Position>(e);
+        out.meta = r.get<TetriminoMeta>(e);
+        if (const auto* g = r.try_get<Gravity>(e)) out.gravity = *g;
+        if (const auto* f = r.try_get<FallAccCells>(e)) out.fall = *f;
+        if (const auto* sd = r.try_get<SoftDrop>(e)) out.soft_drop = *sd;
+        const auto* lt = r.try_get<LockTimer>(e);
+        out.lock_timer = lt ? std::optional<LockTimer>{*lt} : std::nullopt;
+    }
 
-            // ゴースト用の色(同じ色でアルファのみ薄くする)
-            SDL_Color ghostColor = to_color(meta.type);
-            ghostColor.a = 80;
+    out.queue_size = static_cast<std::uint8_t>(pq->queue.size());
+    std::copy(pq->queue.begin(), pq->queue.end(), out.queue.begin());
+    out.rng = pq->rng;
+    if (const auto* held = r.ctx().find<HeldPiece>()) out.held = *held;
+    const auto* meter = r.try_get<GarbageMeter>(w.grid_singleton);
+    out.garbage = meter ? std::optional<GarbageMeter>{*meter} : std::nullopt;
+    return true;
+}
 
-            render_tetrimino_cells(renderer, ghostPos.x, ghostPos.y, meta.type, meta.direction,
-                                   cell_width, cell_height, ghostColor);
+// snapshot の状態へ World を戻す。操作中ピースは今のエンティティを使い回して値だけ書き戻す
+export inline bool restore_snapshot(const World& w, const WorldSnapshot& s) {
+    if (!w.registry) return false;
+    auto& r = *w.registry;
+    if (!r.valid(w.grid_singleton) || !r.all_of<GridResource>(w.grid_singleton)) return false;
+
+    // patch でその場へ代入する(バッファを使い回し、on_update も通知される)
+    r.patch<GridResource>(w.grid_singleton, [&](GridResource& g) { g = s.grid; });
+    r.emplace_or_replace<GameOver>(w.grid_singleton, GameOver{s.gameover});
+
+    entt::entity e = active_entity(w);
+    if (!s.has_active) {
+        if (e != entt::null) r.destroy(e);
+    } else {
+        if (e == entt::null) {
+            e = r.create();
+            r.emplace<ActivePiece>(e);
+        }
+        r.emplace_or_replace<Position>(e, s.pos);
+        r.emplace_or_replace<TetriminoMeta>(e, s.meta);
+        r.emplace_or_replace<Gravity>(e, s.gravity);
+        r.emplace_or_replace<FallAccCells>(e, s.fall);
+        r.emplace_or_replace<SoftDrop>(e, s.soft_drop);
+        if (s.lock_timer) {
+            r.emplace_or_replace<LockTimer>(e, *s.lock_timer);
+        } else {
+            r.remove<LockTimer>(e);
         }
+        r.remove<MoveIntent, RotateIntent, HardDropRequest, HoldRequest>(e);
+    }
 
-        // 色設定(本体)
-        SDL_Color color = to_color(meta.type);
-        // color.a は to_color 側のデフォルトをそのまま利用
-        // 必要ならここで color.a を上書き
-
-        // 形状セル(本体)
-        render_tetrimino_cells(renderer, pos.x, pos.y, meta.type, meta.direction, cell_width,
-                               cell_height, color);
-
-        // 4x4 グリッド(元 render_grid_around 相当)
-        // SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-        // const int grid_w = cell_width * 4;
-        // const int grid_h = cell_height * 4;
-        // SDL_Rect frame = {pos.x, pos.y, grid_w, grid_h};
-        // SDL_RenderDrawRect(renderer, &frame);
-        // for (int c = 1; c <= 3; ++c) {
-        //     const int x = pos.x + c * cell_width;
-        //     SDL_RenderDrawLine(renderer, x, pos.y, x, pos.y + grid_h);
-        // }
-        // for (int r0 = 1; r0 <= 3; ++r0) {
-        //     const int y = pos.y + r0 * cell_height;
-        //     SDL_RenderDrawLine(renderer, pos.x, y, pos.x + grid_w, y);
-        // }
+    if (auto* pq = r.ctx().find<PieceQueue>()) {
+        pq->queue.assign(s.queue.begin(), s.queue.begin() + s.queue_size);
+        pq->rng = s.rng;
+    }
+    if (auto* held = r.ctx().find<HeldPiece>()) *held = s.held;
+    if (s.garbage) {
+        r.emplace_or_replace<GarbageMeter>(w.grid_singleton, *s.garbage);
+    } else {
+        r.remove<GarbageMeter>(w.grid_singleton);
     }
+    return true;
 }
 
-export inline void render_next_area(const World& world, SDL_Renderer* const renderer,
-                                    const Env<GlobalSetting>& env) {
-    auto& registry = *world.registry;
-    const auto& setting = env.setting;
+/**
+ * @brief 直近 N フレーム分の snapshot のリング
+ *
+ * 生成時に N 個分の盤面バッファを確保しておき、save は最古の枠へ上書きする(確保なし)。
+ * restore(frame) はその snapshot へ戻し、それより新しいものを捨てる(巻き戻し後に記録し直す)。
+ */
+export class SnapshotRing {
+   public:
+    SnapshotRing(std::size_t capacity, int rows, int cols)
+        : slots_(std::max<std::size_t>(capacity, 1)) {
+        for (auto& s : slots_) {
+            s.grid.occ.reset(rows, cols);
+            s.grid.occ_type.assign(static_cast<std::size_t>(rows * cols), PieceType::I);
+        }
+    }
 
-    const int cellW = setting.cellWidth;
-    const int cellH = setting.cellHeight;
-    const int gridW = setting.gridAreaWidth;
-    const int holdW = setting.holdAreaWidth;
-
-    const int marginX = 10;
-    const int marginY = 10;
-    const int baseX = holdW + gridW + +marginX;
-    int baseY = marginY;
-
-    // "NEXT" ラベル描画
-    if (TTF_Font* font = setting.get_font()) {
-        const char* label = "NEXT";
-        SDL_Color color = {0, 0, 0, 255};
-
-        SurfacePtr surface(TTF_RenderUTF8_Blended(font, label, color), SDL_FreeSurface);
-        if (surface) {
-            TexturePtr texture(SDL_CreateTextureFromSurface(renderer, surface.get()),
-                               SDL_DestroyTexture);
-            if (texture) {
-                SDL_Rect dstRect{baseX, baseY, surface->w, surface->h};
-                SDL_RenderCopy(renderer, texture.get(), nullptr, &dstRect);
-            }
+    [[nodiscard]] std::size_t capacity() const noexcept { return slots_.size(); }
+    [[nodiscard]] std::size_t size() const noexcept { return count_; }
+    [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+
+    // world の状態を frame 番の snapshot として記録する(満杯なら最古を上書き)
+    bool save(const World& w, std::uint64_t frame) {
+        WorldSnapshot& slot = slots_[head_];
+        if (!save_snapshot(w, slot)) return false;
+        slot.frame = frame;
+        head_ = (head_ + 1) % slots_.size();
+        count_ = std::min(count_ + 1, slots_.size());
+        return true;
+    }
+
+    // frame 番の snapshot(なければ null)
+    [[nodiscard]] const WorldSnapshot* find(std::uint64_t frame) const noexcept {
+        for (std::size_t i = 0; i < count_; ++i) {
+            const WorldSnapshot& s = at_from_latest(i);
+            if (s.frame == frame) return &s;
         }
+        return nullptr;
+    }
 
-        baseY += cellH * 2;
+    // frame 番の状態へ戻し、それより新しい snapshot を捨てる
+    bool restore(const World& w, std::uint64_t frame) {
+        for (std::size_t i = 0; i < count_; ++i) {
+            if (at_from_latest(i).frame != frame) continue;
+            if (!restore_snapshot(w, at_from_latest(i))) return false;
+            head_ = (head_ + slots_.size() - i) % slots_.size();
+            count_ -= i;
+            return true;
+        }
+        return false;
     }
 
-    // ★ ここを ctx からの取得に変更する
-    // registry.ctx() に PieceQueue が存在しない場合は何も描画しないで終了
-    auto* pq = registry.ctx().find<PieceQueue>();
-    if (!pq) {
-        return;
+    [[nodiscard]] std::optional<std::uint64_t> latest_frame() const noexcept {
+        if (count_ == 0) return std::nullopt;
+        return at_from_latest(0).frame;
     }
 
-    const auto queue_view = view_queue(*pq);
+    // 最新の snapshot を捨てる
+    void pop_latest() noexcept {
+        if (count_ == 0) return;
+        head_ = (head_ + slots_.size() - 1) % slots_.size();
+        --count_;
+    }
 
-    // 先読みで表示する最大個数（必要に応じて変更）
-    constexpr std::size_t max_preview = 5;
-    std::size_t index = 0;
+    void clear() noexcept { count_ = 0; }
 
-    for (PieceType piece_type : queue_view) {
-        if (index >= max_preview) break;
+   private:
+    std::vector<WorldSnapshot> slots_;
+    std::size_t head_{0};  // 次に書き込む枠
+    std::size_t count_{0};
 
-        const int panelX = baseX;
-        const int panelY =
-            baseY + static_cast<int>(index) * (cellH * 4 + cellH);  // 1 個分の高さ + 余白
+    // i = 0 が最新
+    [[nodiscard]] const WorldSnapshot& at_from_latest(std::size_t i) const noexcept {
+        return slots_[(head_ + slots_.size() - 1 - i) % slots_.size()];
+    }
+};
 
-        // パネル枠（4x4）
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 128);
-        SDL_Rect frame{panelX, panelY, cellW * 4, cellH * 4};
-        SDL_RenderDrawRect(renderer, &frame);
+// 1 手戻しで遡れるピース数
+export inline constexpr std::size_t kUndoDepth = 32;
 
-        // グリッド線（任意）
-        for (int c = 1; c <= 3; ++c) {
-            const int x = panelX + c * cellW;
-            SDL_RenderDrawLine(renderer, x, panelY, x, panelY + cellH * 4);
+/**
+ * @brief 練習モードの 1 手戻し付きで World を進める(ゲーム画面と replay が同じ手順を踏む)
+ *
+ * ピースが出るたびにその時点を記録し、UNDO が押されたフレームは step_world の代わりに
+ * 直前のピースの出現時点へ戻す(記録が 1 つなら今のピースをやり直す)。
+ * 戻したフレームも入力記録に 1 フレームとして残すので、記録をこの step で再生すれば一致する。
+ */
+export class UndoHistory {
+   public:
+    UndoHistory(const World& w, std::size_t depth, int rows, int cols) : ring_(depth, rows, cols) {
+        ring_.save(w, 0);
+        last_active_ = active_entity(w);
+    }
+
+    // 1 フレーム進める。UNDO で戻したフレームは true
+    bool step(const World& w, const Env<GlobalSetting>& env) {
+        if (game_key::pressed(env.input, game_key::GameKey::UNDO)) {
+            record_input_frame(w, env.input);
+            if (ring_.size() >= 2) ring_.pop_latest();
+            if (const auto frame = ring_.latest_frame()) {
+                ring_.restore(w, *frame);
+                last_active_ = active_entity(w);
+            }
+            return true;
         }
-        for (int r = 1; r <= 3; ++r) {
-            const int y = panelY + r * cellH;
-            SDL_RenderDrawLine(renderer, panelX, y, panelX + cellW * 4, y);
+
+        step_world(w, env);
+        // 新しいピースが出たら記録する(番号は記録した順の通し番号)
+        const entt::entity active = active_entity(w);
+        if (active != last_active_) {
+            ring_.save(w, ring_.latest_frame().value_or(0) + 1);
+            last_active_ = active;
         }
+        return false;
+    }
 
-        // テトリミノ本体（NEXT は固定向きとする）
-        const SDL_Color color = to_color(piece_type);
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-
-        const auto cells = cells_for(piece_type, PieceDirection::West);
-        for (const auto& c : cells) {
-            const int x = panelX + static_cast<int>(c.second) * cellW;
-            const int y = panelY + static_cast<int>(c.first) * cellH;
-            SDL_Rect rect{x, y, cellW, cellH};
-            SDL_RenderFillRect(renderer, &rect);
+    [[nodiscard]] const SnapshotRing& ring() const noexcept { return ring_; }
+
+   private:
+    SnapshotRing ring_;
+    entt::entity last_active_{entt::null};  // 直近に記録したときの操作中ピース
+};
+
+// 盤面とアクティブピースの状態ハッシュ(FNV-1a)。記録の再生結果を突き合わせるのに使う
+export inline std::uint64_t state_hash(const World& w) {
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](std::uint64_t v) {
+        for (int i = 0; i < 8; ++i) {
+            h ^= (v >> (8 * i)) & 0xFF;
+            h *= 1099511628211ull;
         }
+    };
+    if (!w.registry) return h;
+    const auto& r = *w.registry;
 
-        ++index;
+    if (const auto* grid = r.try_get<GridResource>(w.grid_singleton)) {
+        mix(static_cast<std::uint64_t>(grid->rows));
+        mix(static_cast<std::uint64_t>(grid->cols));
+        for (int row = 0; row < grid->rows; ++row) {
+            const RowMask bits = grid->occ.row_bits(row);
+            mix(bits);
+            if (const RowMask garbage = grid->garbage_bits(row)) mix(garbage);
+            for (int col = 0; col < grid->cols; ++col) {
+                if ((bits >> col) & 1) {
+                    mix(static_cast<std::uint64_t>(grid->occ_type[grid->index(row, col)]));
+                }
+            }
+        }
     }
+    mix(is_gameover(w) ? 1 : 0);
+
+    auto view = r.view<const ActivePiece, const Position, const TetriminoMeta>();
+    for (auto e : view) {
+        const auto& pos = view.get<const Position>(e);
+        const auto& meta = view.get<const TetriminoMeta>(e);
+        mix(static_cast<std::uint64_t>(meta.type));
+        mix(static_cast<std::uint64_t>(meta.direction));
+        mix(static_cast<std::uint64_t>(static_cast<std::uint32_t>(pos.x)));
+        mix(static_cast<std::uint64_t>(static_cast<std::uint32_t>(pos.y)));
+    }
+    return h;
 }
 
-export inline void render_hold_area(const World& world, SDL_Renderer* const renderer,
-                                    const Env<GlobalSetting>& env) {
-    auto& registry = *world.registry;
-    const auto& setting = env.setting;
+// =============================
+// ★ 追加: 描画用の写し
+//   描画に要る値(盤面・操作中ピースとゴースト・NEXT・HOLD・受けているおじゃま)だけを
+//   registry から写す。写しは registry を参照しないので、シミュレーションが次のフレームへ
+//   進んでいても別スレッドで描ける。ゴーストの位置も写す側で求めておく。
+// =============================
 
-    const int cellW = setting.cellWidth;
-    const int cellH = setting.cellHeight;
-    const int holdW = setting.holdAreaWidth;
-
-    const int marginX = 10;
-    const int marginY = 10;
-    const int baseX = marginX;
-    int baseY = marginY;
-
-    // "HOLD" ラベル描画
-    if (TTF_Font* font = setting.get_font()) {
-        const char* label = "HOLD";
-        SDL_Color color = {0, 0, 0, 255};
-
-        SurfacePtr surface(TTF_RenderUTF8_Blended(font, label, color), SDL_FreeSurface);
-        if (surface) {
-            TexturePtr texture(SDL_CreateTextureFromSurface(renderer, surface.get()),
-                               SDL_DestroyTexture);
-            if (texture) {
-                SDL_Rect dstRect{baseX, baseY, surface->w, surface->h};
-                SDL_RenderCopy(renderer, texture.get(), nullptr, &dstRect);
-            }
+// NEXT に並べる個数
+inline constexpr std::size_t kPreviewCount = 5;
+
+/**
+ * @brief 1 フレーム分の描画用の写し
+ *   同じ盤面サイズへ繰り返し写すときは、盤面のバッファを使い回す(確保なし)
+ */
+export struct RenderSnapshot {
+    bool has_grid{false};
+    GridResource grid;
+
+    bool has_active{false};
+    PieceType active_type{PieceType::I};
+    PieceDirection active_dir{kSpawnDirection};
+    Position active_pos;
+    Position ghost_pos;
+
+    std::array<PieceType, kPreviewCount> next{};
+    std::uint8_t next_count{0};
+    std::optional<PieceType> hold;
+    int incoming_garbage{0};
+};
+
+// 盤面以外の見た目(操作中ピースとゴースト・NEXT・HOLD・おじゃま)だけを out へ写す
+//   盤面(has_grid / grid)には触れない。ゴーストは grid の上で求める
+inline void capture_board_overlay(const World& w, const GridResource& grid, RenderSnapshot& out) {
+    out.has_active = false;
+    out.next_count = 0;
+    out.hold.reset();
+    out.incoming_garbage = 0;
+    const auto& r = *w.registry;
+
+    const entt::entity e = active_entity(w);
+    if (e != entt::null && r.all_of<Position, TetriminoMeta>(e)) {
+        const auto& pos = r.get<Position>(e);
+        const auto& meta = r.get<TetriminoMeta>(e);
+        out.has_active = true;
+        out.active_type = meta.type;
+        out.active_dir = meta.direction;
+        out.active_pos = pos;
+        out.ghost_pos = compute_ghost_position(grid, pos, meta);
+    }
+
+    if (const auto* pq = r.ctx().find<PieceQueue>()) {
+        for (PieceType piece_type : view_queue(*pq)) {
+            if (out.next_count >= kPreviewCount) break;
+            out.next[out.next_count++] = piece_type;
         }
+    }
+    if (const auto* held = r.ctx().find<HeldPiece>()) out.hold = held->held_type;
+    if (const auto* m = r.try_get<GarbageMeter>(w.grid_singleton)) {
+        out.incoming_garbage = m->incoming;
+    }
+}
 
-        baseY += cellH * 2;
+// World の今の見た目を out へ写す
+export inline void capture_render_snapshot(const World& w, RenderSnapshot& out) {
+    out.has_grid = false;
+    out.has_active = false;
+    out.next_count = 0;
+    out.hold.reset();
+    out.incoming_garbage = 0;
+    if (!w.registry) return;
+
+    const auto* grid = w.registry->try_get<GridResource>(w.grid_singleton);
+    if (!grid) return;
+    out.has_grid = true;
+    out.grid = *grid;  // 同じサイズならバッファへ上書きするだけ
+    capture_board_overlay(w, *grid, out);
+}
+
+// =============================
+// 描画(GeometryBatch に四角形を積み、SDL_RenderGeometry 1 回で送る)
+// =============================
+
+/**
+ * @brief 盤面描画キャッシュ(描画専用。registry の ctx に置く)
+ *
+ * batch の先頭 board_quads 個が盤面(1 行 = quads_per_row 個の固定長区間)で、
+ * 前回描画時から内容が変わった行だけ頂点を書き直す。以降の四角形(ゴースト・本体・
+ * NEXT・HOLD)は毎フレーム積み直す。
+ */
+export struct BoardRenderCache {
+    GeometryBatch batch;
+    std::size_t board_quads{0};
+    std::size_t quads_per_row{0};
+    // キャッシュが前提とする盤面形状
+    int rows{-1}, cols{-1}, cellW{0}, cellH{0}, origin_x{0}, origin_y{0};
+    // 前回描画時の各行の内容
+    std::vector<RowMask> row_bits;
+    std::vector<PieceType> cell_types;
+    std::vector<RowMask> garbage_bits;
+    // 直近フレームで書き直した行数(統計)
+    int rows_rebuilt{0};
+};
+
+inline constexpr SDL_Color kEmptyCellColor{230, 230, 230, 255};
+inline constexpr SDL_Color kGarbageCellColor{128, 128, 128, 255};
+inline constexpr SDL_Color kGridLineColor{0, 0, 0, 255};
+inline constexpr SDL_Color kPanelLineColor{255, 255, 255, 128};
+inline constexpr SDL_Color kLabelColor{0, 0, 0, 255};
+
+// 1 行分の四角形: セルの塗り cols 個 → 行の上辺・下辺 → 各セルの左辺・右辺
+//   (SDL_RenderDrawRect をセルごとに呼んでいた頃と同じピクセルになる)
+inline void write_board_row(BoardRenderCache& cache, const GridResource& grid, int row) {
+    std::size_t q = static_cast<std::size_t>(row) * cache.quads_per_row;
+    const RowMask bits = grid.occ.row_bits(row);
+    const RowMask garbage = grid.garbage_bits(row);
+    const int y = grid.origin_y + row * grid.cellH;
+    for (int col = 0; col < grid.cols; ++col) {
+        const auto idx = static_cast<std::size_t>(grid.index(row, col));
+        SDL_Color c = ((bits >> col) & 1) ? to_color(grid.occ_type[idx]) : kEmptyCellColor;
+        if ((garbage >> col) & 1) c = kGarbageCellColor;
+        cache.batch.set_quad(q++, grid.origin_x + col * grid.cellW, y, grid.cellW, grid.cellH, c);
+    }
+    const int row_w = grid.cols * grid.cellW;
+    cache.batch.set_quad(q++, grid.origin_x, y, row_w, 1, kGridLineColor);
+    cache.batch.set_quad(q++, grid.origin_x, y + grid.cellH - 1, row_w, 1, kGridLineColor);
+    for (int col = 0; col < grid.cols; ++col) {
+        const int x = grid.origin_x + col * grid.cellW;
+        cache.batch.set_quad(q++, x, y, 1, grid.cellH, kGridLineColor);
+        cache.batch.set_quad(q++, x + grid.cellW - 1, y, 1, grid.cellH, kGridLineColor);
+    }
+}
+
+// 盤面区間を最新にする(形状が変わったら全行、そうでなければ内容が変わった行だけ)
+export inline void update_board_geometry(BoardRenderCache& cache, const GridResource& grid) {
+    const bool reshaped = cache.rows != grid.rows || cache.cols != grid.cols ||
+                          cache.cellW != grid.cellW || cache.cellH != grid.cellH ||
+                          cache.origin_x != grid.origin_x || cache.origin_y != grid.origin_y;
+    if (reshaped) {
+        cache.rows = grid.rows;
+        cache.cols = grid.cols;
+        cache.cellW = grid.cellW;
+        cache.cellH = grid.cellH;
+        cache.origin_x = grid.origin_x;
+        cache.origin_y = grid.origin_y;
+        cache.quads_per_row = static_cast<std::size_t>(3 * grid.cols + 2);
+        cache.board_quads = cache.quads_per_row * static_cast<std::size_t>(grid.rows);
+        cache.row_bits.assign(static_cast<std::size_t>(grid.rows), RowMask{0});
+        cache.garbage_bits.assign(static_cast<std::size_t>(grid.rows), RowMask{0});
+        cache.cell_types = grid.occ_type;
+    }
+    cache.batch.resize_quads(cache.board_quads);
+
+    cache.rows_rebuilt = 0;
+    for (int row = 0; row < grid.rows; ++row) {
+        const auto r = static_cast<std::size_t>(row);
+        const RowMask bits = grid.occ.row_bits(row);
+        const RowMask garbage = grid.garbage_bits(row);
+        bool dirty = reshaped || cache.row_bits[r] != bits || cache.garbage_bits[r] != garbage;
+        if (!dirty) {
+            // 埋まっているセルの色だけ比較する(空セルの occ_type は描画に使わない)
+            for (RowMask m = bits; m != 0; m &= m - 1) {
+                const auto idx = static_cast<std::size_t>(grid.index(row, std::countr_zero(m)));
+                if (cache.cell_types[idx] != grid.occ_type[idx]) {
+                    dirty = true;
+                    break;
+                }
+            }
+        }
+        if (!dirty) continue;
+
+        write_board_row(cache, grid, row);
+        cache.row_bits[r] = bits;
+        cache.garbage_bits[r] = garbage;
+        const auto first = static_cast<std::ptrdiff_t>(grid.index(row, 0));
+        std::copy_n(grid.occ_type.begin() + first, grid.cols, cache.cell_types.begin() + first);
+        ++cache.rows_rebuilt;
     }
+}
 
-    // ★ 追加: HOLD パネル枠と中身の描画
-    const int panelX = baseX;
-    const int panelY = baseY;
+inline void append_tetrimino_cells(GeometryBatch& batch, int originX, int originY,
+                                   PieceType type, PieceDirection direction, int cellW, int cellH,
+                                   SDL_Color color) {
+    for (const auto& c : cells_for(type, direction)) {
+        const int x = originX + static_cast<int>(c.second) * cellW;
+        const int y = originY + static_cast<int>(c.first) * cellH;
+        batch.fill_rect(x, y, cellW, cellH, color);
+    }
+}
 
-    // 枠(4x4)
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 128);
-    SDL_Rect frame{panelX, panelY, cellW * 4, cellH * 4};
-    SDL_RenderDrawRect(renderer, &frame);
+inline void append_current_tetrimino(GeometryBatch& batch, const GridResource& grid,
+                                     const RenderSnapshot& snap) {
+    // 位置はセル単位なので、ピクセルへの変換に盤面が要る
+    if (!snap.has_active) return;
+
+    // ★ 追加：ゴースト描画(落下予定位置のシルエット。同じ色でアルファのみ薄くする)
+    SDL_Color ghostColor = to_color(snap.active_type);
+    ghostColor.a = 80;
+    append_tetrimino_cells(batch, grid.x_of(snap.ghost_pos.x), grid.y_of(snap.ghost_pos.y),
+                           snap.active_type, snap.active_dir, grid.cellW, grid.cellH, ghostColor);
+
+    // 本体
+    append_tetrimino_cells(batch, grid.x_of(snap.active_pos.x), grid.y_of(snap.active_pos.y),
+                           snap.active_type, snap.active_dir, grid.cellW, grid.cellH,
+                           to_color(snap.active_type));
+}
 
-    // グリッド線（任意）
+// 4x4 のプレビュー枠とグリッド線
+inline void append_preview_panel(GeometryBatch& batch, int panelX, int panelY, int cellW,
+                                 int cellH) {
+    batch.outline_rect(panelX, panelY, cellW * 4, cellH * 4, kPanelLineColor);
     for (int c = 1; c <= 3; ++c) {
-        const int x = panelX + c * cellW;
-        SDL_RenderDrawLine(renderer, x, panelY, x, panelY + cellH * 4);
+        batch.vline(panelX + c * cellW, panelY, panelY + cellH * 4, kPanelLineColor);
     }
     for (int r = 1; r <= 3; ++r) {
-        const int y = panelY + r * cellH;
-        SDL_RenderDrawLine(renderer, panelX, y, panelX + cellW * 4, y);
+        batch.hline(panelX, panelX + cellW * 4, panelY + r * cellH, kPanelLineColor);
     }
+}
+
+// NEXT / HOLD 領域の左上(ラベルがあればその下からパネルを並べる)
+inline constexpr int kSideMarginX = 10;
+inline constexpr int kSideMarginY = 10;
+
+inline int side_panel_top(const GlobalSetting& setting) {
+    return kSideMarginY + (setting.has_text() ? setting.cellHeight * 2 : 0);
+}
+
+export inline void append_next_area(GeometryBatch& batch, const RenderSnapshot& snap,
+                                    const Env<GlobalSetting>& env) {
+    const auto& setting = env.setting;
+
+    const int cellW = setting.cellWidth;
+    const int cellH = setting.cellHeight;
+    const int baseX = setting.holdAreaWidth + setting.gridAreaWidth + kSideMarginX;
+    const int baseY = side_panel_top(setting);
+
+    for (std::size_t index = 0; index < snap.next_count; ++index) {
+        const PieceType piece_type = snap.next[index];
+        const int panelX = baseX;
+        const int panelY =
+            baseY + static_cast<int>(index) * (cellH * 4 + cellH);  // 1 個分の高さ + 余白
 
-    // コンテキストに HeldPiece が無ければここで終了
-    auto* held = registry.ctx().find<HeldPiece>();
-    if (!held || !held->held_type.has_value()) {
-        return;  // 枠だけ表示
+        append_preview_panel(batch, panelX, panelY, cellW, cellH);
+        // テトリミノ本体（NEXT は固定向きとする）
+        append_tetrimino_cells(batch, panelX, panelY, piece_type, PieceDirection::West, cellW,
+                               cellH, to_color(piece_type));
     }
+}
+
+export inline void append_hold_area(GeometryBatch& batch, const RenderSnapshot& snap,
+                                    const Env<GlobalSetting>& env) {
+    const auto& setting = env.setting;
+
+    const int cellW = setting.cellWidth;
+    const int cellH = setting.cellHeight;
+    const int panelX = kSideMarginX;
+    const int panelY = side_panel_top(setting);
+
+    append_preview_panel(batch, panelX, panelY, cellW, cellH);
+
+    // ホールドが空なら枠だけ表示
+    if (!snap.hold) return;
+    append_tetrimino_cells(batch, panelX, panelY, *snap.hold, PieceDirection::West, cellW, cellH,
+                           to_color(*snap.hold));
+}
+
+// "NEXT" / "HOLD" ラベル(文字列テクスチャはキャッシュから)
+export inline void render_side_labels(SDL_Renderer* const renderer, const Env<GlobalSetting>& env) {
+    const auto& setting = env.setting;
+    if (!setting.has_text()) return;
+    setting.draw_text(renderer, ui_text::kHold, kLabelColor, kSideMarginX, kSideMarginY);
+    setting.draw_text(renderer, ui_text::kNext, kLabelColor,
+                      setting.holdAreaWidth + setting.gridAreaWidth + kSideMarginX, kSideMarginY);
+}
+
+// ★ 追加: 受けているおじゃまの行数を盤面の左に赤い柱で出す(対戦の World のみ)
+inline constexpr SDL_Color kIncomingGarbageColor{220, 40, 40, 255};
+inline constexpr int kIncomingBarWidth = 6;
+
+inline void append_incoming_garbage(GeometryBatch& batch, const GridResource& grid,
+                                    int incoming) {
+    if (incoming <= 0) return;
+    const int h = std::min(incoming, grid.rows) * grid.cellH;
+    const int bottom = grid.origin_y + grid.rows * grid.cellH;
+    batch.fill_rect(grid.origin_x - kIncomingBarWidth - 2, bottom - h, kIncomingBarWidth, h,
+                    kIncomingGarbageColor);
+}
+
+// 盤面 grid(なければ null)と、盤面以外の見た目 overlay を今の描画先へ描く
+//   overlay の has_grid / grid は見ない(盤面は registry の本体でも写しでもよい)
+inline void draw_board(const GridResource* grid, const RenderSnapshot& overlay,
+                       BoardRenderCache& cache, SDL_Renderer* const renderer,
+                       const Env<GlobalSetting>& env) {
+    // アルファブレンド有効化(ゴースト半透明描画用。SDL_RenderGeometry もこのモードで描く)
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
 
-    // ホールド中のテトリミノを描画
-    const PieceType piece_type = *held->held_type;
-    SDL_Color color = to_color(piece_type);
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-
-    const auto cells = cells_for(piece_type, PieceDirection::West);
-    for (const auto& c : cells) {
-        const int x = panelX + static_cast<int>(c.second) * cellW;
-        const int y = panelY + static_cast<int>(c.first) * cellH;
-        SDL_Rect rect{x, y, cellW, cellH};
-        SDL_RenderFillRect(renderer, &rect);
+    // 盤面(変化した行だけ書き直し)＋外枠 → ActivePiece(ゴースト含む)
+    if (grid) {
+        update_board_geometry(cache, *grid);
+        cache.batch.outline_rect(grid->origin_x, grid->origin_y, grid->cols * grid->cellW,
+                                 grid->rows * grid->cellH, kGridLineColor);
+        append_incoming_garbage(cache.batch, *grid, overlay.incoming_garbage);
+        append_current_tetrimino(cache.batch, *grid, overlay);
+    } else {
+        cache.batch.resize_quads(0);
+    }
+
+    // NEXT → HOLD
+    append_next_area(cache.batch, overlay, env);
+    append_hold_area(cache.batch, overlay, env);
+
+    cache.batch.submit(renderer);
+    render_side_labels(renderer, env);
+}
+
+// 写した 1 盤面を今の描画先(ビューポート・拡大率)へ描く。クリアと表示は呼び出し側
+//   registry に触れないので、シミュレーションと別のスレッドから呼んでよい(cache はその側の持ち物)
+export inline void draw_snapshot(const RenderSnapshot& snap, BoardRenderCache& cache,
+                                 SDL_Renderer* const renderer, const Env<GlobalSetting>& env) {
+    draw_board(snap.has_grid ? &snap.grid : nullptr, snap, cache, renderer, env);
+}
+
+// 1 つの World を今の描画先へ描く。クリアと表示は呼び出し側
+//   対戦では World ごとにビューポートを切り替えて並べる。
+//   盤面は registry の本体をそのまま差分描画し、写すのは盤面以外の小さな値だけ
+//   (盤面を丸ごと写すのは、別スレッドへ渡すトリプルバッファの側だけ)。
+//   その写しとキャッシュは World の ctx に置く
+export inline void draw_world(const World& world, SDL_Renderer* const renderer,
+                              const Env<GlobalSetting>& env) {
+    if (!world.registry) return;
+    auto& registry = *world.registry;
+
+    auto* overlay = registry.ctx().find<RenderSnapshot>();
+    if (!overlay) overlay = &registry.ctx().emplace<RenderSnapshot>();
+    auto* cache = registry.ctx().find<BoardRenderCache>();
+    if (!cache) cache = &registry.ctx().emplace<BoardRenderCache>();
+
+    const auto* grid = registry.try_get<GridResource>(world.grid_singleton);
+    if (!grid) return;
+    capture_board_overlay(world, *grid, *overlay);
+    draw_board(grid, *overlay, *cache, renderer, env);
+}
+
+// 写した 1 盤面だけの画面(背景クリア → 盤面 → 表示)。描画スレッドから呼ぶ
+//   シミュレーション側の区間とは別のレーンに、描画と present の区間を記録する
+export inline void render_snapshot(const RenderSnapshot& snap, BoardRenderCache& cache,
+                                   SDL_Renderer* const renderer, const Env<GlobalSetting>& env) {
+    profiler::FrameProfiler* prof = env.setting.frame_profiler.get();
+    profiler::ScopedZone zone{prof, "render_snapshot", "render"};
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderClear(renderer);
+    draw_snapshot(snap, cache, renderer, env);
+    {
+        profiler::ScopedZone present{prof, "present", "render"};
+        SDL_RenderPresent(renderer);
     }
 }
 
@@ -1236,23 +1939,22 @@ export inline void render_hold_area(const World& world, SDL_Renderer* const rend
 export inline void render_world(const World& world, SDL_Renderer* const renderer,
                                 const Env<GlobalSetting>& env) {
     if (!world.registry) return;
-
-    // アルファブレンド有効化(ゴースト半透明描画用)
-    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    auto& registry = *world.registry;
+    profiler::FrameProfiler* prof = nullptr;
+    if constexpr (profiler::kEnabled) {
+        if (auto* shared = registry.ctx().find<profiler::SharedProfiler>()) prof = shared->get();
+    }
+    profiler::ScopedZone zone{prof, "render_world", "render"};
 
     // 背景クリア
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
     SDL_RenderClear(renderer);
 
-    // グリッド描画
-    render_grid(world, renderer);
-
-    // ActivePiece 描画(TetriMino の描画を流用 -> ECS ローカルで置換)
-    render_current_tetrimino(world, renderer);
-    // TODO: NEXT / HOLD 表示
-    render_next_area(world, renderer, env);
-    render_hold_area(world, renderer, env);
-    SDL_RenderPresent(renderer);
+    draw_world(world, renderer, env);
+    {
+        profiler::ScopedZone present{prof, "present", "render"};
+        SDL_RenderPresent(renderer);
+    }
 }
 
 }  // namespace tetris_rule
@@ -0,0 +1,339 @@
+module;
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <tl/expected.hpp>
+
+export module Versus;
+
+import GlobalSetting;
+import SceneFramework;
+import Input;
+import TetrisRule;
+import CpuPlayer;
+import LockFreeQueue;
+import ThreadPool;
+import Profiler;
+
+// =============================
+// ローカル対戦(1 人 + CPU、2〜8 盤面)
+//   各プレイヤーは独立した World を持ち、フレームごとにワーカースレッドで並列に進める。
+//   World 同士は直接触らず、ライン消去で生じたおじゃまを相手の受信箱(ロックフリーキュー)へ
+//   送るだけ。受け手は次のフレームの頭で「前のフレームまでに送られた分」だけを受け取るので、
+//   スレッドの実行順によらず結果は決定的になる(同じフレームに届いた分は次へ持ち越す)。
+//   1 人あたりの状態(World・CPU・受信箱)は人数によらず一定で、人数に比例するのは
+//   フレーム頭の狙い先の決定(逐次・O(人数))だけ。
+// =============================
+
+export namespace versus {
+
+using global_setting::GlobalSetting;
+using scene_fw::Env;
+
+inline constexpr std::size_t kMinPlayers = 2;
+inline constexpr std::size_t kMaxPlayers = 8;
+// 受信箱の枠数。送り手は「自分の 1 つ前の生存者」だけなので、人数によらず固定でよい
+inline constexpr std::size_t kInboxCapacity = 16;
+
+/**
+ * @brief 送られたおじゃま 1 件
+ * @param frame 送ったフレーム(受け手はこれより後のフレームで受け取る)
+ * @param from 送り手の番号
+ * @param lines 行数
+ */
+struct GarbagePacket {
+    std::uint64_t frame{0};
+    std::uint32_t from{0};
+    int lines{0};
+};
+
+/**
+ * @brief 対戦の設定
+ * @param players 人数(番号 0 が人、残りが CPU)
+ * @param cpu_depth CPU の探索手数
+ * @param cpu_delay_frames CPU がキーを押す間隔(大きいほど弱い)
+ * @param seed 7-Bag の種(全員同じ順でピースが出る)。穴の列は番号ごとに変える
+ */
+struct MatchOptions {
+    std::size_t players{4};
+    int cpu_depth{1};
+    int cpu_delay_frames{6};
+    std::uint32_t seed{1};
+};
+
+class Match;
+inline tl::expected<Match, std::string> make_match(const Env<GlobalSetting>& env,
+                                                   const MatchOptions& opt);
+
+/**
+ * @brief 対戦 1 試合分
+ *   プレイヤーは番号順に並び、狙う相手は「番号が次の生存者」(最後は先頭へ戻る)
+ */
+class Match {
+   public:
+    struct Player {
+        tetris_rule::World world;
+        std::optional<cpu_player::CpuPlayer> cpu;  // nullopt なら人(Env の入力で動かす)
+        MpscQueue<GarbagePacket> inbox{kInboxCapacity};
+        std::vector<GarbagePacket> deferred;  // 受信箱から出したが、まだ受け取れない分
+        int backlog{0};                       // 受信箱が満杯で送れなかった行数(次で送り直す)
+        std::size_t target{0};
+        bool alive{true};
+    };
+
+    [[nodiscard]] std::size_t size() const noexcept { return players_.size(); }
+    [[nodiscard]] std::uint64_t frame() const noexcept { return frame_; }
+    [[nodiscard]] const Player& player(std::size_t i) const noexcept { return *players_[i]; }
+    [[nodiscard]] bool human_alive() const noexcept { return players_.front()->alive; }
+
+    [[nodiscard]] std::size_t alive_count() const noexcept {
+        return static_cast<std::size_t>(std::count_if(
+            players_.begin(), players_.end(), [](const auto& p) { return p->alive; }));
+    }
+
+    // 決着していれば勝者の番号(全員同時に倒れたら nullopt のまま finished)
+    [[nodiscard]] bool finished() const noexcept { return alive_count() <= 1; }
+    [[nodiscard]] std::optional<std::size_t> winner() const noexcept {
+        if (alive_count() != 1) return std::nullopt;
+        for (std::size_t i = 0; i < players_.size(); ++i) {
+            if (players_[i]->alive) return i;
+        }
+        return std::nullopt;
+    }
+
+    // 全員を 1 フレーム進める(pool があれば World ごとに並列。null なら逐次)
+    //   env.input は人(番号 0)の入力。CPU は自分の入力を作る
+    void step(const Env<GlobalSetting>& env, WorkStealingPool* pool) {
+        retarget();
+        const auto one = [&](std::size_t i) { step_player(i, env); };
+        if (pool) {
+            pool->parallel_for(players_.size(), one);
+        } else {
+            for (std::size_t i = 0; i < players_.size(); ++i) one(i);
+        }
+        ++frame_;
+    }
+
+   private:
+    friend tl::expected<Match, std::string> make_match(const Env<GlobalSetting>& env,
+                                                       const MatchOptions& opt);
+    Match() = default;
+
+    // Player は受信箱(atomic)を持つので動かせない。並びごとヒープに置く
+    std::vector<std::unique_ptr<Player>> players_;
+    std::uint64_t frame_{0};
+
+    // 生存者ごとに、番号が次の生存者を狙う(自分しか残っていなければ自分=送らない)
+    void retarget() noexcept {
+        const std::size_t n = players_.size();
+        for (std::size_t i = 0; i < n; ++i) {
+            Player& p = *players_[i];
+            p.target = i;
+            if (!p.alive) continue;
+            for (std::size_t k = 1; k < n; ++k) {
+                const std::size_t j = (i + k) % n;
+                if (players_[j]->alive) {
+                    p.target = j;
+                    break;
+                }
+            }
+        }
+    }
+
+    // 前のフレームまでに送られた分を受け取る(このフレームに届いた分は持ち越す)
+    void receive(Player& p) {
+        int lines = 0;
+        std::erase_if(p.deferred, [&](const GarbagePacket& g) {
+            if (g.frame >= frame_) return false;
+            lines += g.lines;
+            return true;
+        });
+        GarbagePacket g;
+        while (p.inbox.try_pop(g)) {
+            if (g.frame < frame_) {
+                lines += g.lines;
+            } else {
+                p.deferred.push_back(g);
+            }
+        }
+        if (p.alive) tetris_rule::receive_garbage(p.world, lines);
+    }
+
+    // このフレームで消した分を狙い先へ送る
+    void send(Player& p, std::size_t self) {
+        const int lines = tetris_rule::take_outgoing_garbage(p.world) + std::exchange(p.backlog, 0);
+        if (lines <= 0 || p.target == self) return;
+        const GarbagePacket g{frame_, static_cast<std::uint32_t>(self), lines};
+        if (!players_[p.target]->inbox.try_push(g)) p.backlog = lines;
+    }
+
+    // 1 人分(ワーカースレッドから呼ばれる。触るのは自分の状態と、相手の受信箱への push だけ)
+    void step_player(std::size_t i, const Env<GlobalSetting>& env) {
+        Player& p = *players_[i];
+        receive(p);  // 倒れた後も受信箱は空にしておく
+        if (!p.alive) return;
+
+        const input::Input* in = &env.input;
+        if (p.cpu) {
+            cpu_player::think(*p.cpu, p.world, env);
+            in = &p.cpu->input;
+        }
+        const Env<GlobalSetting> player_env{*in, env.setting, env.dt, {}};
+        tetris_rule::step_world(p.world, player_env);
+
+        send(p, i);
+        if (tetris_rule::is_gameover(p.world)) p.alive = false;
+    }
+};
+
+// 対戦を作る(人数が 2〜8 でなければエラー)
+inline tl::expected<Match, std::string> make_match(const Env<GlobalSetting>& env,
+                                                   const MatchOptions& opt) {
+    if (opt.players < kMinPlayers || opt.players > kMaxPlayers) {
+        return tl::make_unexpected("versus needs " + std::to_string(kMinPlayers) + ".." +
+                                   std::to_string(kMaxPlayers) + " players");
+    }
+    Match m;
+    m.players_.reserve(opt.players);
+    for (std::size_t i = 0; i < opt.players; ++i) {
+        auto world = tetris_rule::make_world(env, opt.seed, /*standalone=*/false);
+        if (!world) return tl::make_unexpected(world.error());
+        auto p = std::make_unique<Match::Player>();
+        p->world = std::move(*world);
+        tetris_rule::enable_garbage(p->world,
+                                    opt.seed ^ (0x9E3779B9u * static_cast<std::uint32_t>(i + 1)));
+        if (i != 0) {
+            p->cpu.emplace();
+            p->cpu->depth = opt.cpu_depth;
+            p->cpu->delay_frames = opt.cpu_delay_frames;
+        }
+        p->deferred.reserve(kInboxCapacity);
+        m.players_.push_back(std::move(p));
+    }
+    return m;
+}
+
+// =============================
+// 描画: 盤面 1 つ分(キャンバス全体)を縮小して格子状に並べる
+// =============================
+
+/**
+ * @brief 並べ方
+ * @param cols, rows 格子の列数・行数
+ * @param scale 盤面 1 つ分の縮小率(cols, rows の大きい方の逆数)
+ * @param offset_x, offset_y 格子全体を中央へ寄せるずらし量(縮小後の論理座標)
+ */
+struct Layout {
+    int cols{1};
+    int rows{1};
+    float scale{1.0f};
+    int offset_x{0};
+    int offset_y{0};
+};
+
+// n 個の盤面を、縮小率が最大になる行数で並べる(同じなら行が少ない方＝横並びを優先)
+inline Layout layout_for(std::size_t n, int canvas_w, int canvas_h) {
+    Layout best{};
+    int best_side = 0;
+    const int count = static_cast<int>(std::max<std::size_t>(n, 1));
+    for (int rows = 1; rows <= count; ++rows) {
+        const int cols = (count + rows - 1) / rows;
+        const int side = std::max(cols, rows);
+        if (best_side != 0 && side >= best_side) continue;
+        best_side = side;
+        best.cols = cols;
+        best.rows = rows;
+    }
+    best.scale = 1.0f / static_cast<float>(best_side);
+    best.offset_x = (canvas_w * best_side - canvas_w * best.cols) / 2;
+    best.offset_y = (canvas_h * best_side - canvas_h * best.rows) / 2;
+    return best;
+}
+
+inline constexpr SDL_Color kDefeatedShade{0, 0, 0, 140};
+
+// n 個の盤面を格子に並べて描く(クリアから表示まで)
+//   draw_board(i) が i 番の盤面を今のビューポートへ描く。alive(i) が false の盤面は暗くする
+//   描画と present は、呼んだスレッドのレーンに区間として記録する
+template <class DrawBoard, class Alive>
+void render_boards(std::size_t n, SDL_Renderer* const renderer, const Env<GlobalSetting>& env,
+                   DrawBoard&& draw_board, Alive&& alive) {
+    const auto& setting = env.setting;
+    profiler::FrameProfiler* prof = setting.frame_profiler.get();
+    profiler::ScopedZone zone{prof, "render_match", "render"};
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderClear(renderer);
+
+    const Layout lay = layout_for(n, setting.canvasWidth, setting.canvasHeight);
+    SDL_RenderSetScale(renderer, lay.scale, lay.scale);
+    for (std::size_t i = 0; i < n; ++i) {
+        const int col = static_cast<int>(i) % lay.cols;
+        const int row = static_cast<int>(i) / lay.cols;
+        // ビューポートは縮小前の論理座標で指定する(SDL が scale を掛ける)
+        const SDL_Rect vp{lay.offset_x + col * setting.canvasWidth,
+                          lay.offset_y + row * setting.canvasHeight, setting.canvasWidth,
+                          setting.canvasHeight};
+        SDL_RenderSetViewport(renderer, &vp);
+
+        draw_board(i);
+        if (!alive(i)) {
+            const SDL_Rect all{0, 0, setting.canvasWidth, setting.canvasHeight};
+            SDL_SetRenderDrawColor(renderer, kDefeatedShade.r, kDefeatedShade.g,
+                                   kDefeatedShade.b, kDefeatedShade.a);
+            SDL_RenderFillRect(renderer, &all);
+        }
+    }
+    SDL_RenderSetViewport(renderer, nullptr);
+    SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+    {
+        profiler::ScopedZone present{prof, "present", "render"};
+        SDL_RenderPresent(renderer);
+    }
+}
+
+inline void render_match(const Match& match, SDL_Renderer* const renderer,
+                         const Env<GlobalSetting>& env) {
+    render_boards(
+        match.size(), renderer, env,
+        [&](std::size_t i) { tetris_rule::draw_world(match.player(i).world, renderer, env); },
+        [&](std::size_t i) { return match.player(i).alive; });
+}
+
+/**
+ * @brief 描画用の試合の写し(盤面ごとの写しと生存)
+ *   人数が変わらなければ使い回しても確保しない
+ */
+struct MatchSnapshot {
+    std::vector<tetris_rule::RenderSnapshot> boards;
+    std::vector<std::uint8_t> alive;
+};
+
+inline void capture_match(const Match& match, MatchSnapshot& out) {
+    out.boards.resize(match.size());
+    out.alive.resize(match.size());
+    for (std::size_t i = 0; i < match.size(); ++i) {
+        tetris_rule::capture_render_snapshot(match.player(i).world, out.boards[i]);
+        out.alive[i] = match.player(i).alive ? 1 : 0;
+    }
+}
+
+// 写しから描く(caches は描画側の持ち物。盤面ごとに 1 つ)
+inline void render_match_snapshot(const MatchSnapshot& snap,
+                                  std::vector<tetris_rule::BoardRenderCache>& caches,
+                                  SDL_Renderer* const renderer, const Env<GlobalSetting>& env) {
+    if (caches.size() < snap.boards.size()) caches.resize(snap.boards.size());
+    render_boards(
+        snap.boards.size(), renderer, env,
+        [&](std::size_t i) {
+            tetris_rule::draw_snapshot(snap.boards[i], caches[i], renderer, env);
+        },
+        [&](std::size_t i) { return snap.alive[i] != 0; });
+}
+
+}  // namespace versus
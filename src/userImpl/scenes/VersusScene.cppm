@@ -0,0 +1,63 @@
+// ===========================
+// File: MyScenes-Versus.ixx (exported module partition)
+// ===========================
+module;
+#include <SDL2/SDL.h>
+#include <memory>
+#include <string>
+#include <tl/expected.hpp>
+#include <utility>
+
+export module MyScenes:Versus;  // パーティション名
+
+import SceneFramework;
+import GlobalSetting;
+import Input;
+import GameKey;
+import Versus;
+import ThreadPool;
+import :Core;
+
+export namespace my_scenes {
+
+using scene_fw::Env;
+
+// 対戦シーン生成(人は番号 0。残りは CPU)
+inline tl::expected<Scene, std::string> create_versus_scene(
+    const Env<global_setting::GlobalSetting>& env) {
+    versus::MatchOptions opt{};
+    opt.players = kVersusPlayers;
+    if (env.setting.seed) opt.seed = *env.setting.seed;
+    auto match = versus::make_match(env, opt);
+    if (!match) {
+        return tl::make_unexpected(match.error());
+    }
+    VersusSceneData s{
+        .match = std::make_shared<versus::Match>(std::move(*match)),
+        .pool = std::make_shared<WorkStealingPool>(),
+    };
+    return Scene{std::move(s)};
+}
+
+// 更新: 全盤面を並列に 1 フレーム進め、人が倒れるか 1 人だけ残ったら終わり
+inline Scene update(const VersusSceneData& s, const Env<global_setting::GlobalSetting>& env) {
+    s.match->step(env, s.pool.get());
+    if (!s.match->human_alive() || s.match->finished()) {
+        return Scene{GameOverSceneData{.won = s.match->winner() == 0}};
+    }
+    return Scene{s};
+}
+
+// 描画
+inline void render(const VersusSceneData& s, SDL_Renderer* const renderer,
+                   const Env<global_setting::GlobalSetting>& env) {
+    versus::render_match(*s.match, renderer, env);
+}
+
+// 描画用の写し
+inline void capture(const VersusSceneData& s, SceneSnapshot& out) {
+    out.kind = SceneKind::Versus;
+    versus::capture_match(*s.match, out.match);
+}
+
+}  // namespace my_scenes
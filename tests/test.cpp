@@ -4,13 +4,23 @@
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <entt/entt.hpp>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
 
 import TetrisRule;
+import Bitboard;
 import Tetrimino;
+import SRS;
 import GlobalSetting;
 import SceneFramework;
 import Input;
+import InputRecord;
+import GameKey;
 
 using global_setting::FontPtr;
 using global_setting::GlobalSetting;
@@ -170,8 +180,8 @@ TEST(TetrisRuleSystems, LockAndMergeFixesPieceAndSpawnsNewActive) {
 
     // 位置を盤面左上近く(0,0セル)に固定
     Position pos{};
-    pos.x = grid.origin_x + 0 * grid.cellW;
-    pos.y = grid.origin_y + 0 * grid.cellH;
+    pos.x = 0;
+    pos.y = 0;
     reg.replace<Position>(e, pos);
 
     // Meta を「着地済み」の状態にしておく(O ミノ、North で十分)
@@ -251,7 +261,7 @@ TEST(TetrisRuleSystems, GravityMakesPieceFallOneCellPerSecond) {
     const int after_y = posAfter.y;  // コピー
 
     EXPECT_EQ(posAfter.x, posBefore.x);
-    EXPECT_EQ(after_y, before_y + gravityFromWorld.rate_cps * cellH)
+    EXPECT_EQ(after_y, before_y + gravityFromWorld.rate_cps)
         << "1 秒経過で 1 セル分だけ落下する想定です";
 }
 
@@ -306,8 +316,8 @@ TEST(TetrisRuleSystems, SRSTSpinKickNorthToEast) {
     const int base_col = 4;
 
     Position pos{};
-    pos.x = grid.origin_x + base_col * grid.cellW;
-    pos.y = grid.origin_y + base_row * grid.cellH;
+    pos.x = base_col;
+    pos.y = base_row;
     reg.replace<Position>(e, pos);
 
     // その場(North 向き)では衝突しないように盤面を構成しつつ、
@@ -358,7 +368,7 @@ TEST(TetrisRuleSystems, SRSTSpinKickNorthToEast) {
     // x 座標が 1セルぶん左へ移動し、y 座標は変わらない想定。
     EXPECT_EQ(posAfter.y, posBefore.y)
         << "North->East の Tスピン SRS では縦方向オフセット dy=0 のキックが選ばれる想定です";
-    EXPECT_EQ(posAfter.x, posBefore.x - grid.cellW)
+    EXPECT_EQ(posAfter.x, posBefore.x - 1)
         << "North->East の SRS キック (-1,0) により、1セル左へ移動している想定です";
 }
 
@@ -409,8 +419,8 @@ TEST(TetrisRuleSystems, HOLDTest) {
     const int base_col = 4;
 
     Position pos{};
-    pos.x = grid.origin_x + base_col * grid.cellW;
-    pos.y = grid.origin_y + base_row * grid.cellH;
+    pos.x = base_col;
+    pos.y = base_row;
     reg.replace<Position>(e, pos);
 
     const int block_row = base_row + 2;
@@ -475,3 +485,529 @@ TEST(TetrisRuleSystems, HOLDTest) {
         EXPECT_EQ(held_piece.used_in_this_turn, false) << "入れ替えしたのでtrueになっているはず";
     }
 }
+
+// ------------------------------------------------------------
+// 7. ビットボード: 幅広盤面(40 列)でも満杯行だけが消え、上の行と色が詰められること
+// ------------------------------------------------------------
+TEST(TetrisRuleSystems, LineClearOnWideBoardShiftsRowsAndColors) {
+    constexpr int columns = 40;
+    constexpr int rows = 20;
+    constexpr int cellW = 16;
+    constexpr int cellH = 16;
+    constexpr int fps = 60;
+    constexpr double dropRate = 0.0;  // 重力無効化
+
+    auto gs = makeSetting(columns, rows, cellW, cellH, fps, dropRate);
+    auto input = input::Input{};
+    auto env = makeEnv(gs, input, 0.0);
+    auto worldExp = tetris_rule::make_world(env);
+    ASSERT_TRUE(worldExp.has_value());
+    World w = *worldExp;
+
+    auto& reg = *w.registry;
+    auto& grid = reg.get<GridResource>(w.grid_singleton);
+
+    // 最下段は満杯、その上の行は 1 セルだけ(色 Z)
+    const int bottom = grid.rows - 1;
+    for (int c = 0; c < grid.cols; ++c) {
+        grid.occ[grid.index(bottom, c)] = CellStatus::Filled;
+    }
+    grid.occ[grid.index(bottom - 1, 7)] = CellStatus::Filled;
+    grid.occ_type[grid.index(bottom - 1, 7)] = PieceType::Z;
+    reg.replace<GridResource>(w.grid_singleton, grid);
+
+    tetris_rule::step_world(w, env);
+
+    const auto& gridAfter = reg.get<GridResource>(w.grid_singleton);
+    EXPECT_EQ(std::count(gridAfter.occ.begin(), gridAfter.occ.end(), CellStatus::Filled), 1);
+    EXPECT_EQ(gridAfter.occ[gridAfter.index(bottom, 7)], CellStatus::Filled)
+        << "満杯行の上にあったセルが 1 行下へ詰められている想定です";
+    EXPECT_EQ(gridAfter.occ_type[gridAfter.index(bottom, 7)], PieceType::Z);
+}
+
+// ------------------------------------------------------------
+// 8. ビットボードの上限(64 列)を超える盤面は make_world がエラーを返すこと
+// ------------------------------------------------------------
+TEST(TetrisRuleSystems, MakeWorldRejectsBoardWiderThanRowMask) {
+    auto gs = makeSetting(65, 20, 16, 16, 60, 0.0);
+    auto input = input::Input{};
+    auto env = makeEnv(gs, input, 0.0);
+    EXPECT_FALSE(tetris_rule::make_world(env).has_value());
+}
+
+// ------------------------------------------------------------
+// 9. コマンドアリーナ: 定常フレームではコマンド確保がアリーナの初期バッファから溢れないこと
+//    (数えるのはアリーナ経由の確保だけ。プロセス全体のヒープ確保が 0 だとは主張しない)
+// ------------------------------------------------------------
+TEST(TetrisRuleSystems, SteadyStateStepWorldCommandsDoNotSpillArena) {
+    auto gs = makeSetting(10, 20, 16, 16, 60, 1.0);
+    auto input = input::Input{};
+    auto env = makeEnv(gs, input, 1.0 / 60.0);
+    auto worldExp = tetris_rule::make_world(env);
+    ASSERT_TRUE(worldExp.has_value());
+    World w = *worldExp;
+
+    for (int frame = 0; frame < 120; ++frame) {
+        tetris_rule::step_world(w, env);
+        const auto stats = tetris_rule::command_stats(w);
+        EXPECT_GT(stats.commands, 0u);
+        EXPECT_EQ(stats.arena_spills, 0u) << "frame=" << frame;
+    }
+}
+
+// ------------------------------------------------------------
+// 10. 決定的モード: 同じシードと記録した入力を再生すると、毎フレームの状態ハッシュが一致すること
+// ------------------------------------------------------------
+TEST(TetrisRuleSystems, SeededWorldReplaysRecordedInputBitExactly) {
+    constexpr std::uint32_t seed = 20240611;
+    const GlobalSetting gs{10, 20, 16, 16, 60, 1.0, FontPtr{}, 160, 320, seed};
+    const double dt = gs.fixed_step_seconds();
+    ASSERT_DOUBLE_EQ(dt, 1.0 / 60.0);
+
+    // 記録側: 一定間隔で左右移動・回転・ハードドロップを押して離す
+    const SDL_Keycode script[] = {SDLK_a, SDLK_x, SDLK_d, SDLK_d, SDLK_SPACE, SDLK_z, SDLK_SPACE};
+    input::Input input{};
+    auto env = makeEnv(gs, input, dt);
+    auto recorded = tetris_rule::make_world(env);
+    ASSERT_TRUE(recorded.has_value());
+
+    input_record::InputRecorder recorder{tetris_rule::recording_header(gs, seed)};
+    std::vector<std::uint64_t> expected;
+    for (int frame = 0; frame < 900 && !tetris_rule::is_gameover(*recorded); ++frame) {
+        const input::KeyStates prev = input.key_states;
+        input.key_states.begin_frame(prev);
+        const SDL_Keycode key = script[(frame / 12) % std::size(script)];
+        if (frame % 12 == 0) input.key_states.key_down(key);
+        if (frame % 12 == 1) input.key_states.key_up(key);
+        input.key_states.end_frame(prev);
+
+        recorder.record_frame(input);
+        tetris_rule::step_world(*recorded, env);
+        expected.push_back(tetris_rule::state_hash(*recorded));
+    }
+
+    // 再生側: 記録バイト列だけから同じ状態列を再現する
+    auto replayer = input_record::InputReplayer::from_bytes(recorder.bytes());
+    ASSERT_TRUE(replayer.has_value());
+    EXPECT_EQ(replayer->header().seed, seed);
+    EXPECT_EQ(replayer->header(), tetris_rule::recording_header(gs, seed));  // 盤面・落下速度も入る
+
+    input::Input replay_input{};
+    auto replay_env = makeEnv(gs, replay_input, dt);
+    auto replayed = tetris_rule::make_world(replay_env);
+    ASSERT_TRUE(replayed.has_value());
+
+    std::size_t frame = 0;
+    while (replayer->next_frame(replay_input)) {
+        tetris_rule::step_world(*replayed, replay_env);
+        ASSERT_LT(frame, expected.size());
+        ASSERT_EQ(tetris_rule::state_hash(*replayed), expected[frame]) << "frame=" << frame;
+        ++frame;
+    }
+    EXPECT_EQ(frame, expected.size());
+    // 入力のないフレームは 1 バイトなので、記録はフレーム数に対して小さい
+    EXPECT_LT(recorder.bytes().size(), expected.size() * 2);
+}
+
+// ------------------------------------------------------------
+// 11. 盤面描画キャッシュ: 内容が変わった行だけ頂点を作り直すこと
+// ------------------------------------------------------------
+TEST(TetrisRuleSystems, BoardRenderCacheRebuildsOnlyChangedRows) {
+    auto gs = makeSetting(10, 20, 16, 16, 60, 1.0);
+    auto input = input::Input{};
+    auto env = makeEnv(gs, input, 1.0 / 60.0);
+    auto worldExp = tetris_rule::make_world(env);
+    ASSERT_TRUE(worldExp.has_value());
+    World w = *worldExp;
+    auto& reg = *w.registry;
+
+    tetris_rule::BoardRenderCache cache;
+    tetris_rule::update_board_geometry(cache, reg.get<GridResource>(w.grid_singleton));
+    EXPECT_EQ(cache.rows_rebuilt, 20);
+    // 1 行 = セル塗り 10 + 上下辺 2 + 左右辺 20
+    EXPECT_EQ(cache.batch.quad_count(), 20u * (3 * 10 + 2));
+
+    tetris_rule::update_board_geometry(cache, reg.get<GridResource>(w.grid_singleton));
+    EXPECT_EQ(cache.rows_rebuilt, 0);
+
+    // 1 セル埋める → その行だけ
+    reg.patch<GridResource>(w.grid_singleton,
+                            [](GridResource& g) { g.fill_cell(19, 4, PieceType::T); });
+    tetris_rule::update_board_geometry(cache, reg.get<GridResource>(w.grid_singleton));
+    EXPECT_EQ(cache.rows_rebuilt, 1);
+
+    // 同じ位置の色だけ変える → 色の差分でも検出する
+    reg.patch<GridResource>(w.grid_singleton,
+                            [](GridResource& g) { g.fill_cell(19, 4, PieceType::I); });
+    tetris_rule::update_board_geometry(cache, reg.get<GridResource>(w.grid_singleton));
+    EXPECT_EQ(cache.rows_rebuilt, 1);
+}
+
+// ------------------------------------------------------------
+// 12. 列ごとの最上段: 書き込み・消去・行削除のたびに正しく保たれ、
+//     定数時間の落下距離が 1 行ずつの探索と一致すること(張り出しを含むランダム盤面)
+// ------------------------------------------------------------
+TEST(TetrisRuleSystems, ColumnTopsTrackEditsAndDropDistanceMatchesSlowPath) {
+    constexpr int rows = 20;
+    constexpr int cols = 10;
+    std::mt19937 rng{7};
+    BitBoard board;
+    board.reset(rows, cols);
+
+    auto expect_tops = [&](int step) {
+        for (int c = 0; c < cols; ++c) {
+            int top = rows;
+            for (int r = rows - 1; r >= 0; --r) {
+                if (board.test(r, c)) top = r;
+            }
+            ASSERT_EQ(board.column_top(c), top) << "step=" << step << " col=" << c;
+        }
+    };
+
+    constexpr PieceType types[] = {PieceType::I, PieceType::O, PieceType::T, PieceType::S,
+                                   PieceType::Z, PieceType::J, PieceType::L};
+    constexpr PieceDirection dirs[] = {PieceDirection::North, PieceDirection::East,
+                                       PieceDirection::South, PieceDirection::West};
+
+    for (int step = 0; step < 400; ++step) {
+        const int r = 6 + static_cast<int>(rng() % (rows - 6));
+        const int c = static_cast<int>(rng() % cols);
+        switch (rng() % 4) {
+            case 0:
+            case 1:
+                board.set(r, c);
+                break;
+            case 2:
+                board[r * cols + c] = CellStatus::Empty;
+                break;
+            default:
+                if (step % 8 == 0) {
+                    const int cleared[] = {rows - 1, r};
+                    if (r != rows - 1) board.remove_rows(cleared);
+                } else {
+                    board.set_row_bits(r, rng());
+                }
+                break;
+        }
+        expect_tops(step);
+
+        if (step % 20 != 0) continue;
+        for (auto t : types) {
+            for (auto d : dirs) {
+                const auto& m = piece_mask(t, d);
+                for (int row = -1; row < rows; ++row) {
+                    for (int col = -1; col < cols; ++col) {
+                        if (!board.fits(m, row, col)) continue;
+                        ASSERT_EQ(board.drop_distance(m, row, col),
+                                  board.drop_distance_slow(m, row, col))
+                            << "row=" << row << " col=" << col;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// 13. コンパイル時のセル表・キック表: 逆回転のキックは符号が反転し、
+//     同じ向き・180 度の組は 0 のみ、各向きのセルは 4x4 内の相異なる 4 マスであること
+// ------------------------------------------------------------
+TEST(TetrisRuleSystems, ConstexprPieceAndKickTablesAreConsistent) {
+    static_assert(cells_for(PieceType::T, PieceDirection::North)[0] == Coord{0, 1});
+    static_assert(srs_kicks(PieceType::I, PieceDirection::North, PieceDirection::East)[1].dx == -2);
+    static_assert(rotated_direction(PieceDirection::North, -1) == PieceDirection::West);
+
+    for (std::size_t t = 0; t < kPieceTypeCount; ++t) {
+        const auto type = static_cast<PieceType>(t);
+        for (std::size_t d = 0; d < kDirectionCount; ++d) {
+            const auto from = static_cast<PieceDirection>(d);
+            const auto cw = rotated_direction(from, +1);
+            EXPECT_EQ(rotated_direction(cw, -1), from);
+
+            const auto& fwd = srs_kicks(type, from, cw);
+            const auto& back = srs_kicks(type, cw, from);
+            for (std::size_t i = 0; i < fwd.size(); ++i) {
+                EXPECT_EQ(fwd[i].dx, -back[i].dx) << "type=" << t << " from=" << d << " i=" << i;
+                EXPECT_EQ(fwd[i].dy, -back[i].dy) << "type=" << t << " from=" << d << " i=" << i;
+            }
+            for (const auto& k : srs_kicks(type, from, rotated_direction(cw, +1))) {
+                EXPECT_EQ(k.dx, 0);
+                EXPECT_EQ(k.dy, 0);
+            }
+
+            const auto& cells = cells_for(type, from);
+            for (std::size_t i = 0; i < cells.size(); ++i) {
+                EXPECT_TRUE(0 <= cells[i].first && cells[i].first < 4);
+                EXPECT_TRUE(0 <= cells[i].second && cells[i].second < 4);
+                for (std::size_t j = i + 1; j < cells.size(); ++j) EXPECT_NE(cells[i], cells[j]);
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// 14. ロールバック: 遅れて届く相手の入力で予測が外れたら snapshot へ戻して再計算し、
+//     最終状態が最初から正しい入力で進めた World と一致すること
+// ------------------------------------------------------------
+TEST(TetrisRuleSystems, RollbackResimulationMatchesReferenceWorld) {
+    constexpr std::uint32_t seed = 7;
+    constexpr int kFrames = 360;
+    constexpr int kDelay = 4;  // ループバック相手からの入力遅延(フレーム)
+    const GlobalSetting gs{10, 20, 16, 16, 60, 1.0, FontPtr{}, 160, 320, seed};
+    const double dt = gs.fixed_step_seconds();
+
+    // 正しい入力列(一定間隔で押して次のフレームで離す)
+    const SDL_Keycode script[] = {SDLK_a, SDLK_x, SDLK_d, SDLK_SPACE, SDLK_w, SDLK_z, SDLK_SPACE};
+    std::vector<input::KeyStates> truth(kFrames);
+    input::KeyStates keys{};
+    for (int f = 0; f < kFrames; ++f) {
+        const input::KeyStates prev = keys;
+        keys.begin_frame(prev);
+        const SDL_Keycode key = script[(f / 9) % std::size(script)];
+        if (f % 9 == 0) keys.key_down(key);
+        if (f % 9 == 1) keys.key_up(key);
+        keys.end_frame(prev);
+        truth[f] = keys;
+    }
+    auto same = [](const input::KeyStates& a, const input::KeyStates& b) {
+        return a.held_bits() == b.held_bits() && a.pressed_bits() == b.pressed_bits() &&
+               a.released_bits() == b.released_bits();
+    };
+
+    // 基準: 最初から正しい入力で進める
+    input::Input ref_input{};
+    const auto ref_env = makeEnv(gs, ref_input, dt);
+    auto reference = tetris_rule::make_world(ref_env, seed);
+    ASSERT_TRUE(reference.has_value());
+    for (int f = 0; f < kFrames; ++f) {
+        ref_input.key_states = truth[f];
+        tetris_rule::step_world(*reference, ref_env);
+    }
+    ASSERT_FALSE(tetris_rule::is_gameover(*reference));
+
+    // 予測側: 未着の入力は「何も押していない」と予測して進め、届いたら突き合わせる
+    input::Input input{};
+    const auto env = makeEnv(gs, input, dt);
+    auto world = tetris_rule::make_world(env, seed);
+    ASSERT_TRUE(world.has_value());
+    tetris_rule::SnapshotRing ring{kDelay + 2, gs.gridRows, gs.gridColumns};
+    std::vector<input::KeyStates> used(kFrames);
+    std::vector<bool> confirmed(kFrames, false);
+
+    // snapshot f は「フレーム f を進める前」の状態
+    auto advance = [&](int f) {
+        ASSERT_TRUE(ring.save(*world, static_cast<std::uint64_t>(f)));
+        used[f] = confirmed[f] ? truth[f] : input::KeyStates{};
+        input.key_states = used[f];
+        tetris_rule::step_world(*world, env);
+    };
+
+    int rollbacks = 0;
+    for (int f = 0; f < kFrames + kDelay; ++f) {
+        const int arrived = f - kDelay;
+        if (arrived >= 0) {
+            confirmed[arrived] = true;
+            if (!same(used[arrived], truth[arrived])) {
+                ASSERT_TRUE(ring.restore(*world, static_cast<std::uint64_t>(arrived)));
+                ++rollbacks;
+                for (int g = arrived; g < std::min(f, kFrames); ++g) advance(g);
+            }
+        }
+        if (f < kFrames) advance(f);
+    }
+    EXPECT_GT(rollbacks, 0);
+    EXPECT_EQ(tetris_rule::state_hash(*world), tetris_rule::state_hash(*reference));
+
+    // 保存 → 数フレーム進める → 復元で、ハッシュが保存時へ戻ること
+    tetris_rule::WorldSnapshot snap;
+    ASSERT_TRUE(tetris_rule::save_snapshot(*world, snap));
+    const auto saved = tetris_rule::state_hash(*world);
+    for (int f = 0; f < 30; ++f) {
+        input.key_states = truth[f];
+        tetris_rule::step_world(*world, env);
+    }
+    EXPECT_NE(tetris_rule::state_hash(*world), saved);
+    ASSERT_TRUE(tetris_rule::restore_snapshot(*world, snap));
+    EXPECT_EQ(tetris_rule::state_hash(*world), saved);
+
+    // 対戦中のおじゃまメーター(受けた行数・穴の乱数・送る行数)も保存時へ戻ること
+    tetris_rule::enable_garbage(*world, 99u);
+    tetris_rule::receive_garbage(*world, 3);
+    ASSERT_TRUE(tetris_rule::save_snapshot(*world, snap));
+    const auto meter = tetris_rule::garbage_meter(*world);
+    ASSERT_TRUE(meter.has_value());
+    const auto saved_with_meter = tetris_rule::state_hash(*world);
+    for (int f = 0; f < 60; ++f) {
+        input.key_states = truth[f];
+        tetris_rule::step_world(*world, env);
+        tetris_rule::receive_garbage(*world, 1);
+    }
+    const auto moved = tetris_rule::garbage_meter(*world);
+    ASSERT_TRUE(moved.has_value());
+    EXPECT_NE(moved->incoming, meter->incoming);
+    ASSERT_TRUE(tetris_rule::restore_snapshot(*world, snap));
+    EXPECT_EQ(tetris_rule::state_hash(*world), saved_with_meter);
+    const auto restored = tetris_rule::garbage_meter(*world);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->incoming, meter->incoming);
+    EXPECT_EQ(restored->outgoing, meter->outgoing);
+    EXPECT_EQ(restored->hole_state, meter->hole_state);
+    EXPECT_EQ(restored->lines_cleared, meter->lines_cleared);
+}
+
+// ------------------------------------------------------------
+// 15. イベント駆動: ピースが動くだけのフレームでは盤面を走査する System を飛ばし、
+//     盤面が書き換わった(on_update が鳴った)フレームで実行する
+// ------------------------------------------------------------
+TEST(TetrisRuleSystems, BoardSystemsRunOnlyOnFrameEvents) {
+    using tetris_rule::FrameEvent;
+    auto gs = makeSetting(10, 20, 16, 16, 60, 0.0);
+    auto input = input::Input{};
+    auto env = makeEnv(gs, input, 1.0 / 60.0);
+    auto world = tetris_rule::make_world(env, 5u);
+    ASSERT_TRUE(world.has_value());
+    auto& reg = *world->registry;
+
+    // 最初のフレームは生成時のイベント(出現・盤面)を見る
+    tetris_rule::step_world(*world, env);
+    EXPECT_TRUE(tetris_rule::happened_last_frame(*world, FrameEvent::PieceSpawned));
+    EXPECT_TRUE(tetris_rule::happened_last_frame(*world, FrameEvent::BoardChanged));
+    tetris_rule::step_world(*world, env);
+    EXPECT_FALSE(tetris_rule::happened_last_frame(*world, FrameEvent::PieceSpawned));
+    EXPECT_FALSE(tetris_rule::happened_last_frame(*world, FrameEvent::BoardChanged));
+
+    // シグナルを通さずに最下段を埋めるとライン消去は飛ばされる(デバッグビルドは検出して数えるだけ)
+    auto& grid = reg.get<GridResource>(world->grid_singleton);
+    const int bottom = grid.rows - 1;
+    for (int c = 0; c < grid.cols; ++c) grid.fill_cell(bottom, c, PieceType::I);
+    tetris_rule::step_world(*world, env);
+    EXPECT_FALSE(tetris_rule::happened_last_frame(*world, FrameEvent::RowsCleared));
+    EXPECT_TRUE(grid.occ.row_full(bottom));
+    const std::uint32_t detected = tetris_rule::kCheckBoardWrites ? 1u : 0u;
+    EXPECT_EQ(tetris_rule::unsignaled_board_writes(*world), detected);
+
+    // patch で書き換えを知らせると、そのフレームで消える(検出には数えない)
+    reg.patch<GridResource>(world->grid_singleton, [&](GridResource& g) {
+        for (int c = 0; c < g.cols; ++c) g.fill_cell(bottom, c, PieceType::I);
+    });
+    tetris_rule::step_world(*world, env);
+    EXPECT_TRUE(tetris_rule::happened_last_frame(*world, FrameEvent::RowsCleared));
+    EXPECT_TRUE(reg.get<GridResource>(world->grid_singleton).occ.row_empty(bottom));
+    EXPECT_EQ(tetris_rule::unsignaled_board_writes(*world), detected);
+
+    // ハードドロップで固定したフレームは、固定・出現・盤面のイベントがそろう
+    const auto first = tetris_rule::active_entity(*world);
+    bool locked = false;
+    for (int f = 0; f < 120 && !locked; ++f) {
+        const input::KeyStates prev = input.key_states;
+        input.key_states.begin_frame(prev);
+        if (f == 0) input.key_states.key_down(SDLK_SPACE);
+        if (f == 1) input.key_states.key_up(SDLK_SPACE);
+        input.key_states.end_frame(prev);
+        tetris_rule::step_world(*world, env);
+        locked = tetris_rule::active_entity(*world) != first;
+    }
+    ASSERT_TRUE(locked);
+    EXPECT_TRUE(tetris_rule::happened_last_frame(*world, FrameEvent::PieceLocked));
+    EXPECT_TRUE(tetris_rule::happened_last_frame(*world, FrameEvent::PieceSpawned));
+    EXPECT_TRUE(tetris_rule::happened_last_frame(*world, FrameEvent::BoardChanged));
+    EXPECT_FALSE(tetris_rule::happened_last_frame(*world, FrameEvent::RowsCleared));
+}
+
+// ------------------------------------------------------------
+// 16. 入力記録: 再スタートしたゲームは別ファイルに書き、ヘッダにルール設定が入ること
+// ------------------------------------------------------------
+TEST(TetrisRuleSystems, RestartedGamesRecordToSeparateFiles) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "tetris_record_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string base = (dir / "run.trir").string();
+
+    constexpr std::uint32_t seed = 7;
+    const GlobalSetting gs{8, 16, 16, 16, 30, 2.5, FontPtr{}, 128, 256, seed, base};
+    input::Input input{};
+    auto env = makeEnv(gs, input, gs.fixed_step_seconds());
+    for (int game = 0; game < 2; ++game) {
+        auto world = tetris_rule::make_world(env);  // スコープを抜けると書き出す
+        ASSERT_TRUE(world.has_value());
+        for (int frame = 0; frame < 10 * (game + 1); ++frame) tetris_rule::step_world(*world, env);
+    }
+
+    const std::string second = (dir / "run.2.trir").string();
+    ASSERT_TRUE(fs::exists(base));
+    ASSERT_TRUE(fs::exists(second));
+    for (const auto& [path, frames] : {std::pair{base, 10}, std::pair{second, 20}}) {
+        auto replayer = input_record::InputReplayer::load(path);
+        ASSERT_TRUE(replayer.has_value()) << path;
+        EXPECT_EQ(replayer->header(), tetris_rule::recording_header(gs, seed));
+        EXPECT_EQ(replayer->header().columns, 8);
+        EXPECT_EQ(replayer->header().rows, 16);
+        EXPECT_DOUBLE_EQ(replayer->header().drop_rate, 2.5);
+        int replayed = 0;
+        while (replayer->next_frame(input)) ++replayed;
+        EXPECT_EQ(replayed, frames) << path;
+    }
+    fs::remove_all(dir);
+}
+
+// ------------------------------------------------------------
+// 17. 1 手戻し: UNDO を含む記録も、UndoHistory で再生すれば毎フレームの状態が一致すること
+// ------------------------------------------------------------
+TEST(TetrisRuleSystems, RecordedSessionWithUndoReplaysBitExactly) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "tetris_undo_record_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string path = (dir / "undo.trir").string();
+
+    constexpr std::uint32_t seed = 99;
+    const SDL_Keycode undo = *game_key::to_sdl_key(game_key::GameKey::UNDO);
+    // 2 個置いて 1 手戻す、を繰り返す(戻した後も操作を続ける)
+    const SDL_Keycode script[] = {SDLK_a, SDLK_SPACE, SDLK_d, SDLK_SPACE, undo,
+                                  SDLK_x, SDLK_SPACE, undo,   undo,      SDLK_SPACE};
+
+    std::vector<std::uint64_t> expected;
+    int undos = 0;
+    {
+        const GlobalSetting gs{10, 20, 16, 16, 60, 1.0, FontPtr{}, 160, 320, seed, path};
+        input::Input input{};
+        auto env = makeEnv(gs, input, gs.fixed_step_seconds());
+        auto world = tetris_rule::make_world(env);  // スコープを抜けると記録を書き出す
+        ASSERT_TRUE(world.has_value());
+        tetris_rule::UndoHistory history{*world, tetris_rule::kUndoDepth, 20, 10};
+        for (int frame = 0; frame < 400 && !tetris_rule::is_gameover(*world); ++frame) {
+            const input::KeyStates prev = input.key_states;
+            input.key_states.begin_frame(prev);
+            const SDL_Keycode key = script[(frame / 8) % std::size(script)];
+            if (frame % 8 == 0) input.key_states.key_down(key);
+            if (frame % 8 == 1) input.key_states.key_up(key);
+            input.key_states.end_frame(prev);
+
+            undos += history.step(*world, env) ? 1 : 0;
+            expected.push_back(tetris_rule::state_hash(*world));
+        }
+    }
+    ASSERT_GT(undos, 0);
+
+    auto replayer = input_record::InputReplayer::load(path);
+    ASSERT_TRUE(replayer.has_value());
+    const GlobalSetting gs{10, 20, 16, 16, 60, 1.0, FontPtr{}, 160, 320, seed};
+    input::Input input{};
+    auto env = makeEnv(gs, input, gs.fixed_step_seconds());
+    auto world = tetris_rule::make_world(env);
+    ASSERT_TRUE(world.has_value());
+    tetris_rule::UndoHistory history{*world, tetris_rule::kUndoDepth, 20, 10};
+
+    std::size_t frame = 0;
+    int replayed_undos = 0;
+    while (replayer->next_frame(input)) {
+        replayed_undos += history.step(*world, env) ? 1 : 0;
+        ASSERT_LT(frame, expected.size());
+        ASSERT_EQ(tetris_rule::state_hash(*world), expected[frame]) << "frame=" << frame;
+        ++frame;
+    }
+    EXPECT_EQ(frame, expected.size());  // UNDO のフレームも記録に残っている
+    EXPECT_EQ(replayed_undos, undos);
+    fs::remove_all(dir);
+}
@@ -0,0 +1,60 @@
+// tests/test_asset_loader.cpp
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+import AssetLoader;
+
+// ------------------------------------------------------------
+// 要求はすぐ戻り、読み込み結果(成功・失敗とも)は poll で呼び出し側スレッドに届くこと
+// ------------------------------------------------------------
+TEST(AssetLoader, DeliversBytesAndFailuresThroughPoll) {
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string present = (dir / "asset_loader_test.bin").string();
+    const std::string missing = (dir / "asset_loader_missing.bin").string();
+    std::filesystem::remove(missing);
+    const std::vector<std::uint8_t> content{0x00, 0x7F, 0x80, 0xFF, 'T', 'G', 'A'};
+    {
+        std::ofstream os(present, std::ios::binary | std::ios::trunc);
+        os.write(reinterpret_cast<const char*>(content.data()),
+                 static_cast<std::streamsize>(content.size()));
+    }
+
+    std::vector<assets::LoadResult> results;
+    {
+        assets::AssetLoader loader;
+        EXPECT_EQ(loader.pending(), 0u);
+        EXPECT_TRUE(loader.poll().empty());
+
+        loader.request(present);
+        loader.request(missing);
+        EXPECT_EQ(loader.pending(), 2u);
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (loader.pending() > 0 && std::chrono::steady_clock::now() < deadline) {
+            for (auto& r : loader.poll()) results.push_back(std::move(r));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(loader.pending(), 0u);
+    }
+    std::filesystem::remove(present);
+
+    ASSERT_EQ(results.size(), 2u);
+    for (const auto& r : results) {
+        EXPECT_GE(r.elapsed_ms, 0.0);
+        if (r.path == present) {
+            EXPECT_TRUE(r.ok);
+            EXPECT_EQ(r.bytes, content);
+        } else {
+            EXPECT_EQ(r.path, missing);
+            EXPECT_FALSE(r.ok);
+            EXPECT_FALSE(r.error.empty());
+        }
+    }
+}
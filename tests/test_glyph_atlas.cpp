@@ -0,0 +1,99 @@
+// tests/test_glyph_atlas.cpp
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+import GlyphAtlas;
+import UiText;
+
+namespace {
+
+glyph_atlas::GlyphBitmap solid(char32_t cp, int w, int h, int advance, std::uint8_t value) {
+    std::vector<std::uint8_t> coverage(static_cast<std::size_t>(w * h), value);
+    return glyph_atlas::GlyphBitmap{cp, w, h, advance, std::move(coverage)};
+}
+
+}  // namespace
+
+// ------------------------------------------------------------
+// 棚詰め → 書き出し → 読み込みで同じアトラスに戻り、文字の検索と幅の計算ができること
+// ------------------------------------------------------------
+TEST(GlyphAtlas, PackEncodeDecodeRoundTrip) {
+    std::vector<glyph_atlas::GlyphBitmap> bitmaps{
+        solid(U'B', 5, 8, 6, 200), solid(U'A', 6, 8, 7, 255), solid(U' ', 0, 0, 4, 0),
+        solid(U'A', 6, 8, 7, 255),  // 重複は 1 つにまとまる
+        solid(U'あ', 8, 8, 9, 128)};
+    const auto atlas = glyph_atlas::pack(std::move(bitmaps), 10, 12);
+    ASSERT_EQ(atlas.glyphs.size(), 4u);
+    EXPECT_EQ(atlas.width, 11);   // 1 段目: ' ' + 'A' + 'B'
+    EXPECT_EQ(atlas.height, 16);  // 2 段目: 'あ'
+
+    const auto bytes = glyph_atlas::encode(atlas);
+    const auto decoded = glyph_atlas::decode(bytes);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->width, atlas.width);
+    EXPECT_EQ(decoded->height, atlas.height);
+    EXPECT_EQ(decoded->line_height, 10);
+    EXPECT_EQ(decoded->coverage, atlas.coverage);
+
+    const auto* b = decoded->find(U'B');
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(decoded->coverage[static_cast<std::size_t>(b->y * decoded->width + b->x)], 200);
+    const auto* a = decoded->find(U'あ');
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(a->y, 8);
+    EXPECT_EQ(decoded->find(U'C'), nullptr);
+
+    EXPECT_TRUE(decoded->covers("A B"));
+    EXPECT_TRUE(decoded->covers("あ"));
+    EXPECT_FALSE(decoded->covers("ABC"));
+    EXPECT_EQ(decoded->measure("A B"), 7 + 4 + 6);
+}
+
+// ------------------------------------------------------------
+// 壊れたバイト列(魔法数違い・切り詰め・はみ出す矩形)は読み込まないこと
+// ------------------------------------------------------------
+TEST(GlyphAtlas, DecodeRejectsCorruptInput) {
+    const auto atlas = glyph_atlas::pack({solid(U'A', 4, 4, 5, 255)}, 4);
+    auto bytes = glyph_atlas::encode(atlas);
+    ASSERT_TRUE(glyph_atlas::decode(bytes).has_value());
+
+    auto bad_magic = bytes;
+    bad_magic[0] = 'X';
+    EXPECT_FALSE(glyph_atlas::decode(bad_magic).has_value());
+
+    auto truncated = bytes;
+    truncated.pop_back();
+    EXPECT_FALSE(glyph_atlas::decode(truncated).has_value());
+    EXPECT_FALSE(glyph_atlas::decode(std::vector<std::uint8_t>(bytes.begin(), bytes.begin() + 6))
+                     .has_value());
+
+    auto out_of_range = bytes;
+    out_of_range[glyph_atlas::kHeaderBytes + 4] = 3;  // x = 3(幅 4 の文字がはみ出す)
+    EXPECT_FALSE(glyph_atlas::decode(out_of_range).has_value());
+}
+
+// ------------------------------------------------------------
+// UTF-8 の読み取り: 1〜4 バイトの文字と、不正・途中で切れたバイト列
+// ------------------------------------------------------------
+TEST(GlyphAtlas, NextCodepointDecodesUtf8) {
+    constexpr std::string_view text = "aé あ\xF0\x9F\x98\x80";
+    std::vector<char32_t> cps;
+    for (std::size_t i = 0; i < text.size();) cps.push_back(glyph_atlas::next_codepoint(text, i));
+    EXPECT_EQ(cps, (std::vector<char32_t>{U'a', U'é', U' ', U'あ', U'\U0001F600'}));
+
+    constexpr std::string_view broken = "\xE3\x81";  // 3 バイト文字の途中で切れている
+    std::size_t i = 0;
+    EXPECT_EQ(glyph_atlas::next_codepoint(broken, i), glyph_atlas::kReplacement);
+    EXPECT_EQ(i, 1u);
+
+    // UI 文字列は焼き込める(置換文字を含まない)こと
+    for (const auto text : ui_text::kAll) {
+        for (std::size_t k = 0; k < text.size();) {
+            EXPECT_NE(glyph_atlas::next_codepoint(text, k), glyph_atlas::kReplacement) << text;
+        }
+    }
+}
@@ -0,0 +1,109 @@
+// tests/test_input.cpp
+
+#include <gtest/gtest.h>
+#include <SDL2/SDL.h>
+#include <type_traits>
+#include <unordered_map>
+
+import Input;
+import GameKey;
+
+namespace {
+
+// 1 フレーム分のイベントを取り込む(Game::poll_input と同じ手順)
+template <class Fn>
+input::Input ingest(const input::Input& prev, Fn&& events) {
+    input::Input next = prev;
+    next.key_states.begin_frame(prev.key_states);
+    events(next.key_states);
+    next.key_states.end_frame(prev.key_states);
+    return next;
+}
+
+}  // namespace
+
+// ------------------------------------------------------------
+// キーコード → スロットの写像: ASCII とスキャンコード由来の両方が往復できること
+// ------------------------------------------------------------
+TEST(InputSnapshot, KeySlotRoundTripsAsciiAndScancodeKeys) {
+    for (SDL_Keycode k : {SDLK_a, SDLK_SPACE, SDLK_ESCAPE, SDLK_LEFT, SDLK_F12, SDLK_RCTRL}) {
+        const auto slot = input::key_slot(k);
+        ASSERT_LT(slot, input::kKeySlots) << k;
+        EXPECT_EQ(input::slot_key(slot), k);
+    }
+    EXPECT_EQ(input::key_slot(0x00E9), input::kNoSlot);  // 配列依存の非 ASCII 文字
+    static_assert(std::is_trivially_copyable_v<input::Input>);
+}
+
+// ------------------------------------------------------------
+// XOR によるエッジ検出: 押下・保持・解放、および同一フレーム内の押して離す/離して押す
+// ------------------------------------------------------------
+TEST(InputSnapshot, EdgesComeFromHeldXorAndBouncesSetBothEdges) {
+    input::Input f0{};
+    const auto f1 = ingest(f0, [](input::KeyStates& k) { k.key_down(SDLK_LEFT); });
+    EXPECT_TRUE(f1.pressed(SDLK_LEFT));
+    EXPECT_TRUE(f1.held(SDLK_LEFT));
+    EXPECT_FALSE(f1.released(SDLK_LEFT));
+
+    // キーリピート(KEYDOWN の重複)はエッジを立てない
+    const auto f2 = ingest(f1, [](input::KeyStates& k) { k.key_down(SDLK_LEFT); });
+    EXPECT_FALSE(f2.pressed(SDLK_LEFT));
+    EXPECT_TRUE(f2.held(SDLK_LEFT));
+    EXPECT_FALSE(f2.any_pressed());
+
+    const auto f3 = ingest(f2, [](input::KeyStates& k) {
+        k.key_up(SDLK_LEFT);
+        k.key_down(SDLK_LEFT);  // 離して押し直した
+        k.key_down(SDLK_x);
+        k.key_up(SDLK_x);  // 押して離した
+    });
+    EXPECT_TRUE(f3.pressed(SDLK_LEFT) && f3.released(SDLK_LEFT) && f3.held(SDLK_LEFT));
+    EXPECT_TRUE(f3.pressed(SDLK_x) && f3.released(SDLK_x));
+    EXPECT_FALSE(f3.held(SDLK_x));
+
+    const auto f4 = ingest(f3, [](input::KeyStates& k) { k.key_up(SDLK_LEFT); });
+    EXPECT_TRUE(f4.released(SDLK_LEFT));
+    EXPECT_FALSE(f4.held(SDLK_LEFT));
+    EXPECT_FALSE(f4.pressed(SDLK_x) || f4.released(SDLK_x));
+    EXPECT_FALSE(f4.get_input_key()->is_held);
+}
+
+// ------------------------------------------------------------
+// 互換アダプタ: 旧マップ表現からの変換と GameKey 単位の O(1) 判定が一致すること
+// ------------------------------------------------------------
+TEST(InputSnapshot, MapAdapterAndGameKeyQueriesAgree) {
+    const std::unordered_map<SDL_Keycode, input::InputState> states = {
+        {SDLK_SPACE, input::InputState{true, false, true}},
+        {SDLK_s, input::InputState{false, false, true}},
+    };
+    const input::Input in{.key_states = states};
+
+    EXPECT_TRUE(game_key::pressed(in, game_key::GameKey::DROP));
+    EXPECT_TRUE(game_key::held(in, game_key::GameKey::DOWN));
+    EXPECT_FALSE(game_key::pressed(in, game_key::GameKey::DOWN));
+    EXPECT_FALSE(game_key::held(in, game_key::GameKey::LEFT));
+    for (const auto& [sdl, key] : game_key::KEY_MAP) {
+        EXPECT_EQ(game_key::pressed(in, key), in.pressed(sdl));
+        EXPECT_EQ(game_key::held(in, key), in.held(sdl));
+    }
+}
+
+// ------------------------------------------------------------
+// 固定刻みループ用: 消費済みのエッジは落とし、未消費のエッジは次のスナップショットへ引き継ぐ
+// ------------------------------------------------------------
+TEST(InputSnapshot, UnconsumedEdgesCarryOverAndConsumedEdgesClear) {
+    input::Input f0{};
+    auto f1 = ingest(f0, [](input::KeyStates& k) { k.key_down(SDLK_SPACE); });
+
+    // シミュレーションが進まなかったフレーム: 次のフレームへエッジを引き継ぐ
+    auto f2 = ingest(f1, [](input::KeyStates&) {});
+    EXPECT_FALSE(f2.pressed(SDLK_SPACE));
+    f2.key_states.merge_edges(f1.key_states);
+    EXPECT_TRUE(f2.pressed(SDLK_SPACE));
+    EXPECT_TRUE(f2.held(SDLK_SPACE));
+
+    // 1 ステップ目が消費したら、同じフレームの 2 ステップ目には held だけが残る
+    f2.key_states.clear_edges();
+    EXPECT_FALSE(f2.any_pressed());
+    EXPECT_TRUE(f2.held(SDLK_SPACE));
+}
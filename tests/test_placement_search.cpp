@@ -0,0 +1,155 @@
+// tests/test_placement_search.cpp
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <vector>
+
+import Tetrimino;
+import Bitboard;
+import PlacementSearch;
+import ThreadPool;
+
+namespace {
+
+constexpr int kRows = 20;
+constexpr int kCols = 10;
+
+BitBoard empty_board() {
+    BitBoard b;
+    b.reset(kRows, kCols);
+    return b;
+}
+
+// 行 row を holes 以外すべて埋める
+void fill_row_except(BitBoard& b, int row, std::initializer_list<int> holes) {
+    for (int c = 0; c < b.cols(); ++c) {
+        if (std::find(holes.begin(), holes.end(), c) == holes.end()) b.set(row, c);
+    }
+}
+
+placement::PieceState spawn_of(PieceType type) {
+    return placement::PieceState{type, PieceDirection::West, 3, 0};
+}
+
+}  // namespace
+
+// ------------------------------------------------------------
+// 空の盤面では、同じセルを占める向き違いをまとめた配置数になり、どれも接地していること
+// ------------------------------------------------------------
+TEST(PlacementSearch, EnumeratesDistinctLandingsOnEmptyBoard) {
+    const BitBoard board = empty_board();
+    placement::PlacementSearcher searcher;
+
+    struct Expect {
+        PieceType type;
+        std::size_t count;
+    };
+    // 幅 3 の向き 8 通り + 幅 2 の向き 9 通り(I は 7 + 10、O は 9)
+    constexpr std::array<Expect, 7> expects{{{PieceType::I, 17},
+                                             {PieceType::O, 9},
+                                             {PieceType::T, 34},
+                                             {PieceType::S, 17},
+                                             {PieceType::Z, 17},
+                                             {PieceType::J, 34},
+                                             {PieceType::L, 34}}};
+    for (const auto& e : expects) {
+        const auto found = searcher.search(board, spawn_of(e.type));
+        EXPECT_EQ(found.size(), e.count) << "type=" << static_cast<int>(e.type);
+        for (const auto& p : found) {
+            const auto& m = piece_mask(p.piece.type, p.piece.dir);
+            EXPECT_TRUE(board.fits(m, p.piece.row, p.piece.col));
+            EXPECT_FALSE(board.fits(m, p.piece.row + 1, p.piece.col));
+            EXPECT_FALSE(p.twist);
+        }
+    }
+}
+
+// ------------------------------------------------------------
+// 張り出しの下の T 字穴へは回転でしか入れず、その配置はひねり込みとして 2 行消しになること
+// ------------------------------------------------------------
+TEST(PlacementSearch, FindsTwistUnderOverhang) {
+    BitBoard board = empty_board();
+    fill_row_except(board, kRows - 1, {4});
+    fill_row_except(board, kRows - 2, {3, 4, 5});
+    for (int c = 0; c <= 3; ++c) board.set(kRows - 3, c);  // 穴の左上を塞ぐ張り出し
+
+    placement::PlacementSearcher searcher;
+    const auto found = searcher.search(board, spawn_of(PieceType::T));
+    const auto slot = std::find_if(found.begin(), found.end(), [](const auto& p) {
+        return p.piece.dir == PieceDirection::South && p.piece.col == 3 &&
+               p.piece.row == kRows - 3;
+    });
+    ASSERT_NE(slot, found.end()) << "T 字穴への配置が列挙されていません";
+    EXPECT_TRUE(slot->twist);
+
+    BitBoard after = board;
+    EXPECT_EQ(placement::place(after, slot->piece), 2);
+}
+
+// ------------------------------------------------------------
+// 4 段の井戸には I を縦に入れて 4 行消す。並列の先読みでも逐次と同じ手を選ぶこと
+// ------------------------------------------------------------
+TEST(PlacementSearch, BestPlanTakesTetrisAndParallelMatchesSequential) {
+    BitBoard board = empty_board();
+    for (int r = kRows - 4; r < kRows; ++r) fill_row_except(board, r, {9});
+
+    const std::vector<PieceType> preview{PieceType::O, PieceType::T, PieceType::S};
+    placement::SearchRequest req{};
+    req.board = &board;
+    req.current = spawn_of(PieceType::I);
+    req.preview = preview;
+    req.spawn_col = 3;
+
+    placement::SearchOptions opt{};
+    opt.depth = 1;
+    const auto greedy = placement::best_plan(req, opt);
+    ASSERT_TRUE(greedy.has_value());
+    EXPECT_EQ(greedy->first.lines_cleared, 4);
+    EXPECT_FALSE(greedy->first.used_hold);
+
+    opt.depth = 3;
+    const auto sequential = placement::best_plan(req, opt);
+    WorkStealingPool pool{3};
+    const auto parallel = placement::best_plan(req, opt, &pool);
+    ASSERT_TRUE(sequential.has_value());
+    ASSERT_TRUE(parallel.has_value());
+    EXPECT_EQ(parallel->first.piece, sequential->first.piece);
+    EXPECT_EQ(parallel->first.used_hold, sequential->first.used_hold);
+    EXPECT_DOUBLE_EQ(parallel->score, sequential->score);
+    EXPECT_EQ(sequential->first.lines_cleared, 4);
+}
+
+// ------------------------------------------------------------
+// hard_drop_only: 空の盤面では全探索と同じ配置が出て、張り出しの下のひねり込みは出ないこと
+// ------------------------------------------------------------
+TEST(PlacementSearch, HardDropOnlyDropsTucksAndTwists) {
+    placement::PlacementSearcher searcher;
+    const BitBoard empty = empty_board();
+    for (const PieceType type : {PieceType::I, PieceType::O, PieceType::T, PieceType::S,
+                                 PieceType::Z, PieceType::J, PieceType::L}) {
+        const auto all = searcher.search(empty, spawn_of(type));
+        const std::vector<placement::Placement> full(all.begin(), all.end());
+        const auto dropped = searcher.search(empty, spawn_of(type), /*hard_drop_only=*/true);
+        EXPECT_EQ(dropped.size(), full.size()) << "type=" << static_cast<int>(type);
+        for (const auto& p : dropped) {
+            EXPECT_FALSE(p.twist);
+            EXPECT_TRUE(std::any_of(full.begin(), full.end(),
+                                    [&](const auto& q) { return q.piece == p.piece; }));
+        }
+    }
+
+    BitBoard board = empty_board();
+    fill_row_except(board, kRows - 1, {4});
+    fill_row_except(board, kRows - 2, {3, 4, 5});
+    for (int c = 0; c <= 3; ++c) board.set(kRows - 3, c);
+    const auto found = searcher.search(board, spawn_of(PieceType::T), /*hard_drop_only=*/true);
+    ASSERT_FALSE(found.empty());
+    for (const auto& p : found) EXPECT_FALSE(p.twist);
+    const auto slot = std::find_if(found.begin(), found.end(), [](const auto& p) {
+        return p.piece.dir == PieceDirection::South && p.piece.col == 3 &&
+               p.piece.row == kRows - 3;
+    });
+    EXPECT_EQ(slot, found.end()) << "張り出しの下の T 字穴へは真上から落とせない";
+}
@@ -0,0 +1,177 @@
+// tests/test_profiler.cpp
+
+#include <gtest/gtest.h>
+#include <entt/entt.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+import Command;
+import Profiler;
+import ThreadPool;
+
+namespace {
+
+struct Counter {
+    int value{0};
+};
+struct Res {};
+
+CommandList countUp(ReadOnlyView<Counter> rv, WriteCommands<Counter> wr, const Res&) {
+    CommandList out;
+    for (auto e : rv.view<Counter>()) {
+        out.push_back(wr.emplace_or_replace<Counter>(e, Counter{rv.get<Counter>(e).value + 1}));
+    }
+    return out;
+}
+
+struct Other {
+    int value{0};
+};
+
+CommandList bumpOther(ReadOnlyView<Other> rv, WriteCommands<Other> wr, const Res&) {
+    CommandList out;
+    for (auto e : rv.view<Other>()) {
+        out.push_back(wr.emplace_or_replace<Other>(e, Other{rv.get<Other>(e).value + 1}));
+    }
+    return out;
+}
+
+}  // namespace
+
+// ------------------------------------------------------------
+// __PRETTY_FUNCTION__ から修飾なしの System 名が取れること
+// ------------------------------------------------------------
+TEST(FrameProfiler, FunctionNameStripsQualifiers) {
+    static_assert(profiler::function_name<&countUp>() == "countUp");
+    EXPECT_EQ(profiler::function_name<&countUp>(), std::string_view{"countUp"});
+}
+
+// ------------------------------------------------------------
+// 区間の集計(分位点・コマンド数)とトレース JSON
+// ------------------------------------------------------------
+TEST(FrameProfiler, SummarizesZonesAndExportsChromeTrace) {
+    profiler::FrameProfiler prof;
+    for (std::uint64_t i = 1; i <= 100; ++i) {
+        prof.record("gravity", "system", i * 1000, i * 10, 3);
+        prof.record("present", "render", i * 1000 + 500, 7);
+        prof.end_frame();
+    }
+
+    const auto s = prof.summaries();
+    ASSERT_EQ(s.size(), 2u);
+    EXPECT_EQ(s[0].name, "gravity");
+    EXPECT_EQ(s[0].samples, 100u);
+    EXPECT_EQ(s[0].p50_ns, 500u);
+    EXPECT_EQ(s[0].p99_ns, 990u);
+    EXPECT_EQ(s[0].last_commands, 3u);
+    EXPECT_EQ(s[1].p95_ns, 7u);
+    EXPECT_EQ(s[1].last_commands, profiler::kNoCount);
+    EXPECT_EQ(prof.frames(), 100u);
+    EXPECT_FALSE(prof.end_frame());  // report_every を指定しなければ定期レポートは出さない
+    prof.report_every(3);
+    int due = 0;
+    for (int i = 0; i < 9; ++i) due += prof.end_frame() ? 1 : 0;
+    EXPECT_EQ(due, 3);
+
+    const std::string json = prof.trace_json();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("{\"name\":\"gravity\",\"cat\":\"system\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"commands\":3"), std::string::npos);
+    EXPECT_NE(json.find("\"frame\":99"), std::string::npos);
+}
+
+// ------------------------------------------------------------
+// 別スレッドで記録した区間は、トレースで別のレーン(tid)に並ぶ
+// ------------------------------------------------------------
+TEST(FrameProfiler, ZonesFromEachThreadGetTheirOwnTraceLane) {
+    profiler::FrameProfiler prof;
+    prof.record("run_schedule", "frame", 0, 10);
+    std::thread render([&] { prof.record("present", "render", 5, 3); });
+    render.join();
+    prof.record("gravity", "system", 20, 4);
+
+    const std::string json = prof.trace_json();
+    EXPECT_NE(json.find("\"name\":\"run_schedule\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,"
+                        "\"tid\":1"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"present\",\"cat\":\"render\",\"ph\":\"X\",\"pid\":1,"
+                        "\"tid\":2"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"gravity\",\"cat\":\"system\",\"ph\":\"X\",\"pid\":1,"
+                        "\"tid\":1"),
+              std::string::npos);
+}
+
+// ------------------------------------------------------------
+// 有効ビルドでは静的スケジュールが System / apply / phase を記録すること
+// ------------------------------------------------------------
+TEST(FrameProfiler, StaticScheduleRecordsSystemsWhenEnabled) {
+    if constexpr (!profiler::kEnabled) {
+        GTEST_SKIP() << "built without TETRIS_PROFILING";
+    } else {
+        entt::registry reg;
+        reg.ctx().emplace<CommandArena>();
+        auto& prof = *reg.ctx().emplace<profiler::SharedProfiler>(
+            std::make_shared<profiler::FrameProfiler>());
+        const auto e = reg.create();
+        reg.emplace<Counter>(e);
+
+        using Schedule = StaticSchedule<Res, StaticPhase<&countUp>>;
+        run_schedule(reg, Res{}, Schedule{});
+        EXPECT_EQ(reg.get<Counter>(e).value, 1);
+
+        bool saw_system = false;
+        bool saw_apply = false;
+        bool saw_phase = false;
+        for (const auto& z : prof.summaries()) {
+            if (z.name != "countUp") continue;
+            saw_system |= z.category == "system" && z.last_commands == 1;
+            saw_apply |= z.category == "apply";
+            saw_phase |= z.category == "phase";
+        }
+        EXPECT_TRUE(saw_system);
+        EXPECT_TRUE(saw_apply);
+        EXPECT_TRUE(saw_phase);
+    }
+}
+
+// ------------------------------------------------------------
+// 有効ビルドでは動的スケジュールの並列フェーズも System / apply / phase を記録すること
+// ------------------------------------------------------------
+TEST(FrameProfiler, ParallelPhaseRecordsSystemsWhenEnabled) {
+    if constexpr (!profiler::kEnabled) {
+        GTEST_SKIP() << "built without TETRIS_PROFILING";
+    } else {
+        WorkStealingPool pool{2};
+        entt::registry reg;
+        reg.ctx().emplace<CommandArena>();
+        auto& prof = *reg.ctx().emplace<profiler::SharedProfiler>(
+            std::make_shared<profiler::FrameProfiler>());
+        const auto e = reg.create();
+        reg.emplace<Counter>(e);
+        reg.emplace<Other>(e);
+
+        Schedule<Res> sch{{make_parallel_phase<Res, &countUp, &bumpOther>()}, &pool};
+        run_schedule(reg, Res{}, sch);
+        EXPECT_EQ(reg.get<Counter>(e).value, 1);
+        EXPECT_EQ(reg.get<Other>(e).value, 1);
+
+        int systems = 0;
+        int applies = 0;
+        bool saw_phase = false;
+        bool saw_frame = false;
+        for (const auto& z : prof.summaries()) {
+            const bool named = z.name == "countUp" || z.name == "bumpOther";
+            systems += named && z.category == "system" && z.last_commands == 1 ? 1 : 0;
+            applies += named && z.category == "apply" ? 1 : 0;
+            saw_phase |= z.name == "countUp" && z.category == "phase";
+            saw_frame |= z.name == "run_schedule" && z.category == "frame";
+        }
+        EXPECT_EQ(systems, 2);
+        EXPECT_EQ(applies, 2);
+        EXPECT_TRUE(saw_phase);
+        EXPECT_TRUE(saw_frame);
+    }
+}
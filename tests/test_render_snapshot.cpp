@@ -0,0 +1,183 @@
+// tests/test_render_snapshot.cpp
+//   描画用の写し: トリプルバッファの受け渡しと、World から写す内容
+
+#include <SDL2/SDL.h>
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+import TetrisRule;
+import Tetrimino;
+import GlobalSetting;
+import SceneFramework;
+import Input;
+import GameKey;
+import TripleBuffer;
+import Versus;
+
+using global_setting::GlobalSetting;
+using scene_fw::Env;
+
+namespace {
+
+GlobalSetting make_setting() {
+    constexpr int cols = 10;
+    constexpr int rows = 20;
+    constexpr int cell = 30;
+    return GlobalSetting{cols,
+                         rows,
+                         cell,
+                         cell,
+                         60,
+                         0.0,
+                         global_setting::FontPtr{},
+                         cols * cell + 300,
+                         rows * cell,
+                         std::uint32_t{42}};
+}
+
+// 1 フレームだけ key を押して離す
+void tap(input::Input& input, const tetris_rule::World& world, const Env<GlobalSetting>& env,
+         SDL_Keycode key) {
+    for (int f = 0; f < 2; ++f) {
+        const input::KeyStates prev = input.key_states;
+        input.key_states.begin_frame(prev);
+        if (f == 0) input.key_states.key_down(key);
+        if (f == 1) input.key_states.key_up(key);
+        input.key_states.end_frame(prev);
+        tetris_rule::step_world(world, env);
+    }
+}
+
+struct Frame {
+    std::uint64_t seq{0};
+    std::array<std::uint64_t, 32> payload{};
+};
+
+}  // namespace
+
+// ------------------------------------------------------------
+// 1. トリプルバッファ: 公開されるまで読み手には見えず、読む前に何度公開されても最新だけが届く
+// ------------------------------------------------------------
+TEST(RenderSnapshot, TripleBufferHandsOverLatestFrame) {
+    TripleBuffer<Frame> tb;
+    EXPECT_FALSE(tb.acquire());
+    EXPECT_EQ(tb.front().seq, 0u);
+
+    tb.back().seq = 1;
+    tb.publish();
+    ASSERT_TRUE(tb.acquire());
+    EXPECT_EQ(tb.front().seq, 1u);
+    EXPECT_FALSE(tb.acquire());  // 新しいものがなければ手元のまま
+    EXPECT_EQ(tb.front().seq, 1u);
+
+    for (std::uint64_t s = 2; s <= 4; ++s) {
+        tb.back().seq = s;
+        tb.publish();
+    }
+    ASSERT_TRUE(tb.acquire());
+    EXPECT_EQ(tb.front().seq, 4u);
+}
+
+// ------------------------------------------------------------
+// 2. 別スレッドの書き手と並べても、読み手は書きかけの枠を見ず、番号は戻らない
+// ------------------------------------------------------------
+TEST(RenderSnapshot, TripleBufferNeverTearsAcrossThreads) {
+    constexpr std::uint64_t kFrames = 100000;
+    TripleBuffer<Frame> tb;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (std::uint64_t s = 1; s <= kFrames; ++s) {
+            Frame& f = tb.back();
+            f.seq = s;
+            f.payload.fill(s);
+            tb.publish();
+        }
+        done = true;
+    });
+
+    std::uint64_t last = 0;
+    int received = 0;
+    for (;;) {
+        const bool finished = done;  // これより前の公開は、この後の acquire で必ず見える
+        if (!tb.acquire()) {
+            if (finished) break;
+            continue;
+        }
+        const Frame& f = tb.front();
+        ASSERT_GT(f.seq, last);
+        for (const std::uint64_t v : f.payload) ASSERT_EQ(v, f.seq);
+        last = f.seq;
+        ++received;
+    }
+    writer.join();
+    EXPECT_EQ(tb.front().seq, kFrames);
+    EXPECT_GT(received, 0);
+}
+
+// ------------------------------------------------------------
+// 3. World の写し: 盤面・操作中ピースとゴースト・NEXT・HOLD が入り、
+//    写した後に World を進めても写しは変わらない
+// ------------------------------------------------------------
+TEST(RenderSnapshot, CaptureCopiesEverythingTheBoardDraws) {
+    const auto setting = make_setting();
+    input::Input input{};
+    const Env<GlobalSetting> env{input, setting, setting.fixed_step_seconds(), {}};
+    auto world = tetris_rule::make_world(env, 3u);
+    ASSERT_TRUE(world);
+
+    tetris_rule::RenderSnapshot snap;
+    tetris_rule::capture_render_snapshot(*world, snap);
+    ASSERT_TRUE(snap.has_grid);
+    EXPECT_EQ(snap.grid.rows, setting.gridRows);
+    EXPECT_EQ(snap.grid.cols, setting.gridColumns);
+    ASSERT_TRUE(snap.has_active);
+    const auto piece = tetris_rule::active_piece_state(*world);
+    ASSERT_TRUE(piece);
+    EXPECT_EQ(snap.active_type, piece->type);
+    EXPECT_EQ(snap.active_pos.x, piece->col);
+    EXPECT_EQ(snap.active_pos.y, piece->row);
+    EXPECT_EQ(snap.ghost_pos.x, snap.active_pos.x);
+    EXPECT_GT(snap.ghost_pos.y, snap.active_pos.y);  // 空の盤面なら底まで落ちる
+    EXPECT_EQ(snap.next_count, 5);
+    EXPECT_FALSE(snap.hold);
+    EXPECT_EQ(snap.incoming_garbage, 0);
+
+    // ホールドすると、持っていた種が HOLD に、NEXT の先頭が操作中になる
+    const PieceType first = snap.active_type;
+    const PieceType next = snap.next[0];
+    tap(input, *world, env, *game_key::to_sdl_key(game_key::GameKey::HOLD));
+    const tetris_rule::RenderSnapshot before = snap;
+    tetris_rule::capture_render_snapshot(*world, snap);
+    ASSERT_TRUE(snap.hold);
+    EXPECT_EQ(*snap.hold, first);
+    EXPECT_EQ(snap.active_type, next);
+    EXPECT_FALSE(before.hold);  // 先に写したものは元のまま
+}
+
+// ------------------------------------------------------------
+// 4. 対戦の写し: 人数分の盤面と生存が入る
+// ------------------------------------------------------------
+TEST(RenderSnapshot, CaptureMatchHasOneBoardPerPlayer) {
+    const auto setting = make_setting();
+    input::Input idle{};
+    const Env<GlobalSetting> env{idle, setting, setting.fixed_step_seconds(), {}};
+    versus::MatchOptions opt{};
+    opt.players = 3;
+    auto match = versus::make_match(env, opt);
+    ASSERT_TRUE(match);
+    match->step(env, nullptr);
+
+    versus::MatchSnapshot snap;
+    versus::capture_match(*match, snap);
+    ASSERT_EQ(snap.boards.size(), 3u);
+    ASSERT_EQ(snap.alive.size(), 3u);
+    for (std::size_t i = 0; i < snap.boards.size(); ++i) {
+        EXPECT_TRUE(snap.boards[i].has_grid);
+        EXPECT_TRUE(snap.boards[i].has_active);
+        EXPECT_EQ(snap.alive[i], 1);
+    }
+}
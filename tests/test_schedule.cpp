@@ -0,0 +1,184 @@
+// tests/test_schedule.cpp
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <entt/entt.hpp>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+import Command;
+import ThreadPool;
+
+namespace {
+
+struct ScoreA {
+    int value{0};
+};
+struct ScoreB {
+    int value{0};
+};
+struct Spawned {
+    int by{0};
+};
+struct Res {
+    int frame{0};
+};
+
+// ScoreA だけを書き、自分の印を付けたエンティティを 1 つ作る
+CommandList bumpA(ReadOnlyView<ScoreA> rv, WriteCommands<ScoreA> wr, const Res&) {
+    CommandList out;
+    for (auto e : rv.view<ScoreA>()) {
+        const int v = rv.get<ScoreA>(e).value;
+        out.push_back(wr.emplace_or_replace<ScoreA>(e, ScoreA{v + 1}));
+    }
+    out.push_back(wr.create_then([](entt::registry& r, entt::entity e) {
+        r.emplace<Spawned>(e, Spawned{1});
+    }));
+    return out;
+}
+
+CommandList bumpB(ReadOnlyView<ScoreB> rv, WriteCommands<ScoreB> wr, const Res&) {
+    CommandList out;
+    for (auto e : rv.view<ScoreB>()) {
+        const int v = rv.get<ScoreB>(e).value;
+        out.push_back(wr.emplace_or_replace<ScoreB>(e, ScoreB{v + 10}));
+    }
+    out.push_back(wr.create_then([](entt::registry& r, entt::entity e) {
+        r.emplace<Spawned>(e, Spawned{2});
+    }));
+    return out;
+}
+
+// ScoreA を読むので bumpA とは同じ並列フェーズに置けない
+CommandList copyAtoB(ReadOnlyView<ScoreA> rv, WriteCommands<ScoreB> wr, const Res&) {
+    CommandList out;
+    for (auto e : rv.view<ScoreA>()) {
+        out.push_back(wr.emplace_or_replace<ScoreB>(e, ScoreB{rv.get<ScoreA>(e).value}));
+    }
+    return out;
+}
+
+}  // namespace
+
+static_assert(!systems_conflict_v<decltype(&bumpA), decltype(&bumpB)>);
+static_assert(systems_conflict_v<decltype(&bumpA), decltype(&copyAtoB)>);
+static_assert(systems_conflict_v<decltype(&copyAtoB), decltype(&bumpB)>);
+
+// ------------------------------------------------------------
+// 並列フェーズ: 結果と適用順(エンティティ生成順)がスレッド数によらず一定であること
+// ------------------------------------------------------------
+TEST(Schedule, ParallelPhaseMatchesSerialAndMergesInDeclarationOrder) {
+    WorkStealingPool pool{3};
+
+    auto run = [](WorkStealingPool* executor) {
+        entt::registry reg;
+        reg.ctx().emplace<CommandArena>();
+        const auto e = reg.create();
+        reg.emplace<ScoreA>(e);
+        reg.emplace<ScoreB>(e);
+
+        Schedule<Res> sch{{make_parallel_phase<Res, &bumpA, &bumpB>()}, executor};
+        const Res res{};
+        for (int i = 0; i < 50; ++i) run_schedule(reg, res, sch);
+
+        // エンティティ ID(破棄なしなので生成順)で並べて、どの System が作ったかを取り出す
+        std::vector<std::pair<entt::id_type, int>> spawned;
+        for (auto [ent, s] : reg.view<Spawned>().each()) {
+            spawned.emplace_back(entt::to_integral(ent), s.by);
+        }
+        std::sort(spawned.begin(), spawned.end());
+        std::vector<int> spawn_order;
+        for (const auto& [id, by] : spawned) spawn_order.push_back(by);
+        return std::tuple{reg.get<ScoreA>(e).value, reg.get<ScoreB>(e).value, spawn_order};
+    };
+
+    const auto serial = run(nullptr);
+    const auto parallel = run(&pool);
+
+    EXPECT_EQ(std::get<0>(serial), 50);
+    EXPECT_EQ(std::get<1>(serial), 500);
+    EXPECT_EQ(serial, parallel);
+
+    // 各フレーム、宣言順(bumpA → bumpB)でコマンドが適用される
+    const auto& order = std::get<2>(parallel);
+    ASSERT_EQ(order.size(), 100u);
+    for (std::size_t i = 0; i < order.size(); i += 2) {
+        EXPECT_EQ(order[i], 1);
+        EXPECT_EQ(order[i + 1], 2);
+    }
+}
+
+// ------------------------------------------------------------
+// 手組みの並列フェーズ: 衝突する組でも executor の有無で結果が変わらず、
+// どちらもフェーズ開始時の状態を読んでから宣言順に適用すること
+// ------------------------------------------------------------
+TEST(Schedule, HandBuiltParallelPhaseReadsPhaseStartStateWithOrWithoutExecutor) {
+    WorkStealingPool pool{3};
+
+    auto run = [](WorkStealingPool* executor) {
+        entt::registry reg;
+        reg.ctx().emplace<CommandArena>();
+        const auto e = reg.create();
+        reg.emplace<ScoreA>(e);
+        reg.emplace<ScoreB>(e);
+
+        // make_parallel_phase を通さないので access が空(並列には走らない)
+        Schedule<Res> sch{{Phase<Res>{{make_system<Res>(bumpA), make_system<Res>(copyAtoB)}, true}},
+                          executor};
+        const Res res{};
+        for (int i = 0; i < 10; ++i) run_schedule(reg, res, sch);
+        return std::pair{reg.get<ScoreA>(e).value, reg.get<ScoreB>(e).value};
+    };
+
+    const auto serial = run(nullptr);
+    EXPECT_EQ(serial, run(&pool));
+    EXPECT_EQ(serial.first, 10);
+    EXPECT_EQ(serial.second, 9);  // copyAtoB は同じフレームの bumpA の結果を見ない
+}
+
+// ------------------------------------------------------------
+// 静的スケジュール: 動的な Schedule/Phase と同じ順序・結果になること
+// ------------------------------------------------------------
+TEST(Schedule, StaticScheduleMatchesDynamicSchedule) {
+    auto setup = [](entt::registry& reg) {
+        reg.ctx().emplace<CommandArena>();
+        const auto e = reg.create();
+        reg.emplace<ScoreA>(e);
+        reg.emplace<ScoreB>(e);
+        return e;
+    };
+
+    entt::registry dyn;
+    const auto de = setup(dyn);
+    Schedule<Res> sch{{
+        Phase<Res>{{make_system<Res>(bumpA)}},
+        Phase<Res>{{make_system<Res>(copyAtoB), make_system<Res>(bumpB)}},
+    }};
+
+    entt::registry st;
+    const auto se = setup(st);
+    using Static = StaticSchedule<Res, StaticPhase<&bumpA>, StaticPhase<&copyAtoB, &bumpB>>;
+
+    const Res res{};
+    for (int i = 0; i < 5; ++i) {
+        run_schedule(dyn, res, sch);
+        run_schedule(st, res, Static{});
+    }
+
+    EXPECT_EQ(st.get<ScoreA>(se).value, dyn.get<ScoreA>(de).value);
+    EXPECT_EQ(st.get<ScoreB>(se).value, dyn.get<ScoreB>(de).value);
+    EXPECT_EQ(st.get<ScoreB>(se).value, 15);  // 最終フレーム: copyAtoB で 5、bumpB で +10
+    EXPECT_EQ(st.ctx().get<CommandArena>().stats().commands,
+              dyn.ctx().get<CommandArena>().stats().commands);
+}
+
+// ------------------------------------------------------------
+// WorkStealingPool: 全インデックスがちょうど 1 回ずつ実行されること
+// ------------------------------------------------------------
+TEST(Schedule, WorkStealingPoolRunsEveryIndexOnce) {
+    WorkStealingPool pool{4};
+    std::vector<int> hits(1000, 0);
+    pool.parallel_for(hits.size(), [&](std::size_t i) { hits[i] += 1; });
+    EXPECT_TRUE(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 1; }));
+}
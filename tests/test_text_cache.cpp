@@ -0,0 +1,88 @@
+// tests/test_text_cache.cpp
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+import TextCache;
+import GlyphAtlas;
+
+// ------------------------------------------------------------
+// TextCache: 同じ (フォント, 色, 文字列) は 2 回目以降ラスタライズしないこと
+//   ウィンドウ不要のソフトウェア renderer で確認する
+// ------------------------------------------------------------
+TEST(TextCache, HitsAfterFirstRasterizeAndEvictsLeastRecentlyUsed) {
+    if (TTF_WasInit() == 0 && TTF_Init() == -1) GTEST_SKIP() << TTF_GetError();
+    std::shared_ptr<TTF_Font> font{
+        TTF_OpenFont("assets/Noto_Sans_JP/static/NotoSansJP-Regular.ttf", 16), TTF_CloseFont};
+    if (!font) GTEST_SKIP() << "font asset not found: " << TTF_GetError();
+
+    std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> target{
+        SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_RGBA8888), SDL_FreeSurface};
+    ASSERT_TRUE(target);
+    std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> renderer{
+        SDL_CreateSoftwareRenderer(target.get()), SDL_DestroyRenderer};
+    ASSERT_TRUE(renderer);
+
+    {
+        text_cache::TextCache cache{2};
+        const SDL_Color black{0, 0, 0, 255};
+
+        for (int frame = 0; frame < 60; ++frame) {
+            EXPECT_TRUE(cache.draw(renderer.get(), font, "NEXT", black, 0, 0));
+            EXPECT_TRUE(cache.draw(renderer.get(), font, "HOLD", black, 0, 0));
+        }
+        EXPECT_EQ(cache.stats().misses, 2u);
+        EXPECT_EQ(cache.stats().hits, 118u);
+        EXPECT_GT(cache.stats().hit_rate(), 0.98);
+
+        // 色が違えば別エントリ。容量 2 なので最も古い "NEXT"(黒) が追い出される
+        EXPECT_TRUE(cache.draw(renderer.get(), font, "HOLD", SDL_Color{255, 0, 0, 255}, 0, 0));
+        EXPECT_EQ(cache.stats().entries, 2u);
+        EXPECT_EQ(cache.stats().evictions, 1u);
+        EXPECT_TRUE(cache.draw(renderer.get(), font, "NEXT", black, 0, 0));
+        EXPECT_EQ(cache.stats().misses, 4u);
+    }
+    font.reset();
+}
+
+// ------------------------------------------------------------
+// TextCache: フォントなしでも、焼き込み済みアトラスの文字を指定色で描けること
+// ------------------------------------------------------------
+TEST(TextCache, DrawsBakedAtlasGlyphsWithoutFont) {
+    std::vector<glyph_atlas::GlyphBitmap> bitmaps;
+    bitmaps.push_back({U'A', 2, 2, 3, std::vector<std::uint8_t>(4, 255)});
+    bitmaps.push_back({U' ', 0, 0, 2, {}});
+    const auto atlas = std::make_shared<const glyph_atlas::GlyphAtlas>(
+        glyph_atlas::pack(std::move(bitmaps), 2));
+
+    std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> target{
+        SDL_CreateRGBSurfaceWithFormat(0, 8, 4, 32, SDL_PIXELFORMAT_RGBA8888), SDL_FreeSurface};
+    ASSERT_TRUE(target);
+    std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> renderer{
+        SDL_CreateSoftwareRenderer(target.get()), SDL_DestroyRenderer};
+    ASSERT_TRUE(renderer);
+    SDL_SetRenderDrawColor(renderer.get(), 0, 0, 0, 255);
+    SDL_RenderClear(renderer.get());
+
+    text_cache::TextCache cache;
+    const SDL_Color red{255, 0, 0, 255};
+    EXPECT_TRUE(cache.draw(renderer.get(), atlas, "A A", red, 0, 0));
+    EXPECT_FALSE(cache.draw(renderer.get(), std::shared_ptr<const glyph_atlas::GlyphAtlas>{}, "A",
+                            red, 0, 0));
+    SDL_RenderPresent(renderer.get());
+
+    auto pixel = [&target](int x, int y) {
+        const auto* row = static_cast<const std::uint8_t*>(target->pixels) + y * target->pitch;
+        return reinterpret_cast<const std::uint32_t*>(row)[x];
+    };
+    const std::uint32_t kRed = SDL_MapRGBA(target->format, 255, 0, 0, 255);
+    const std::uint32_t kBlack = SDL_MapRGBA(target->format, 0, 0, 0, 255);
+    EXPECT_EQ(pixel(0, 0), kRed);    // 1 文字目
+    EXPECT_EQ(pixel(2, 0), kBlack);  // 送り幅 3 のうち文字のない列
+    EXPECT_EQ(pixel(5, 1), kRed);    // 空白(送り幅 2)を挟んだ 2 文字目
+    EXPECT_EQ(pixel(7, 3), kBlack);
+}
@@ -0,0 +1,268 @@
+// tests/test_versus.cpp
+//   対戦モード: おじゃまのせり上げ、ロックフリーキュー、並列実行の決定性、画面の並べ方
+
+#include <SDL2/SDL.h>
+#include <gtest/gtest.h>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+import TetrisRule;
+import Bitboard;
+import Tetrimino;
+import GlobalSetting;
+import SceneFramework;
+import Input;
+import LockFreeQueue;
+import ThreadPool;
+import Versus;
+import CpuPlayer;
+import GameKey;
+import PlacementSearch;
+
+using global_setting::GlobalSetting;
+using scene_fw::Env;
+using tetris_rule::GridResource;
+
+namespace {
+
+GlobalSetting make_setting() {
+    constexpr int cols = 10;
+    constexpr int rows = 20;
+    constexpr int cell = 30;
+    return GlobalSetting{cols,
+                         rows,
+                         cell,
+                         cell,
+                         60,
+                         0.7,
+                         global_setting::FontPtr{},
+                         cols * cell + 300,
+                         rows * cell,
+                         std::uint32_t{42}};
+}
+
+GridResource make_grid(int rows, int cols) {
+    GridResource g{};
+    g.rows = rows;
+    g.cols = cols;
+    g.occ.reset(rows, cols);
+    g.occ_type.assign(static_cast<std::size_t>(rows * cols), PieceType::I);
+    return g;
+}
+
+}  // namespace
+
+// ------------------------------------------------------------
+// 1. おじゃまのせり上げ: 下に穴 1 つの行が入り、元の盤面はその分だけ上がる。
+//    列ごとの最上段も追従し、上端から押し出されたら false
+// ------------------------------------------------------------
+TEST(Versus, InsertGarbagePushesBoardUpWithOneHole) {
+    constexpr int rows = 8;
+    constexpr int cols = 6;
+    GridResource g = make_grid(rows, cols);
+    g.fill_cell(rows - 1, 0, PieceType::T);
+    g.fill_cell(rows - 1, 1, PieceType::S);
+
+    ASSERT_TRUE(g.insert_garbage(3, 4));
+    // 元の最下段は 3 行上へ(色も一緒に)
+    EXPECT_TRUE(g.occ.test(rows - 4, 0));
+    EXPECT_TRUE(g.occ.test(rows - 4, 1));
+    EXPECT_EQ(g.occ_type[static_cast<std::size_t>(g.index(rows - 4, 1))], PieceType::S);
+    EXPECT_EQ(g.garbage_bits(rows - 4), RowMask{0});
+    for (int r = rows - 3; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) EXPECT_EQ(g.occ.test(r, c), c != 4) << r << "," << c;
+        EXPECT_EQ(g.garbage_bits(r), g.occ.row_bits(r));
+    }
+    for (int c = 0; c < cols; ++c) {
+        const int expected = c <= 1 ? rows - 4 : (c == 4 ? rows : rows - 3);
+        EXPECT_EQ(g.occ.column_top(c), expected) << "col=" << c;
+    }
+
+    // 行を消すと、おじゃまの印も一緒に詰まる
+    const int cleared[] = {rows - 4};
+    g.remove_rows(cleared);
+    EXPECT_EQ(g.garbage_bits(rows - 3), g.occ.row_bits(rows - 3));
+    EXPECT_EQ(g.garbage_bits(rows - 4), RowMask{0});
+
+    // 上端まで積んであれば押し出される
+    g.fill_cell(0, 2, PieceType::I);
+    EXPECT_FALSE(g.insert_garbage(1, 0));
+}
+
+// ------------------------------------------------------------
+// 2. 受け取ったおじゃまは、消さずに固定したときにせり上がる
+// ------------------------------------------------------------
+TEST(Versus, ReceivedGarbageRisesWhenPieceLocksWithoutClear) {
+    const auto setting = make_setting();
+    input::Input input{};
+    const Env<GlobalSetting> env{input, setting, setting.fixed_step_seconds(), {}};
+    auto world = tetris_rule::make_world(env, 7u, false);
+    ASSERT_TRUE(world);
+    tetris_rule::enable_garbage(*world, 99u);
+    tetris_rule::receive_garbage(*world, 2);
+
+    const auto first = tetris_rule::active_entity(*world);
+    for (int f = 0; f < 120 && tetris_rule::active_entity(*world) == first; ++f) {
+        const input::KeyStates prev = input.key_states;
+        input.key_states.begin_frame(prev);
+        if (f == 0) input.key_states.key_down(SDLK_SPACE);
+        if (f == 1) input.key_states.key_up(SDLK_SPACE);
+        input.key_states.end_frame(prev);
+        tetris_rule::step_world(*world, env);
+    }
+    ASSERT_NE(tetris_rule::active_entity(*world), first);
+
+    const auto& grid = world->registry->get<GridResource>(world->grid_singleton);
+    for (int r = grid.rows - 2; r < grid.rows; ++r) {
+        EXPECT_EQ(std::popcount(grid.garbage_bits(r)), grid.cols - 1) << "row=" << r;
+    }
+    EXPECT_EQ(grid.garbage_bits(grid.rows - 1), grid.garbage_bits(grid.rows - 2));
+    const auto meter = tetris_rule::garbage_meter(*world);
+    ASSERT_TRUE(meter);
+    EXPECT_EQ(meter->incoming, 0);
+    EXPECT_EQ(meter->outgoing, 0);
+}
+
+// ------------------------------------------------------------
+// 3. ロックフリーキュー: 複数スレッドから押し込んだ値が欠けず、送り手ごとの順序も保たれる
+// ------------------------------------------------------------
+TEST(Versus, MpscQueueDeliversEveryItemInProducerOrder) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+    MpscQueue<std::uint64_t> q{64};
+    EXPECT_EQ(q.capacity(), 64u);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&q, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                const std::uint64_t v = (std::uint64_t(p) << 32) | std::uint64_t(i);
+                while (!q.try_push(v)) std::this_thread::yield();
+            }
+        });
+    }
+    std::vector<int> next(kProducers, 0);
+    int received = 0;
+    std::uint64_t v = 0;
+    while (received < kProducers * kPerProducer) {
+        if (!q.try_pop(v)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const auto p = static_cast<std::size_t>(v >> 32);
+        ASSERT_LT(p, next.size());
+        ASSERT_EQ(static_cast<int>(v & 0xFFFFFFFFu), next[p]);
+        ++next[p];
+        ++received;
+    }
+    for (auto& t : producers) t.join();
+    EXPECT_FALSE(q.try_pop(v));
+
+    // 満杯なら押し込めず、1 つ取り出せばまた入る(容量は 2 の冪へ切り上げ)
+    MpscQueue<int> small{3};
+    ASSERT_EQ(small.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(small.try_push(i));
+    EXPECT_FALSE(small.try_push(4));
+    int out = -1;
+    EXPECT_TRUE(small.try_pop(out));
+    EXPECT_EQ(out, 0);
+    EXPECT_TRUE(small.try_push(4));
+}
+
+// ------------------------------------------------------------
+// 4. 並列に進めても逐次と同じ結果になる(おじゃまは 1 フレーム遅れで決定的に届く)
+// ------------------------------------------------------------
+TEST(Versus, ParallelStepMatchesSerialStep) {
+    const auto setting = make_setting();
+    input::Input idle{};
+    const Env<GlobalSetting> env{idle, setting, setting.fixed_step_seconds(), {}};
+
+    EXPECT_FALSE(versus::make_match(env, versus::MatchOptions{.players = 1}));
+    EXPECT_FALSE(versus::make_match(env, versus::MatchOptions{.players = 9}));
+
+    versus::MatchOptions opt{};
+    opt.players = 6;
+    opt.cpu_delay_frames = 0;
+    auto serial = versus::make_match(env, opt);
+    auto parallel = versus::make_match(env, opt);
+    ASSERT_TRUE(serial);
+    ASSERT_TRUE(parallel);
+
+    WorkStealingPool pool{3};
+    int lines = 0;
+    for (int f = 0; f < 1500 && !serial->finished(); ++f) {
+        serial->step(env, nullptr);
+        parallel->step(env, &pool);
+        for (std::size_t i = 0; i < serial->size(); ++i) {
+            ASSERT_EQ(tetris_rule::state_hash(serial->player(i).world),
+                      tetris_rule::state_hash(parallel->player(i).world))
+                << "frame=" << f << " player=" << i;
+            ASSERT_EQ(serial->player(i).alive, parallel->player(i).alive);
+        }
+    }
+    for (std::size_t i = 1; i < serial->size(); ++i) {
+        lines += tetris_rule::garbage_meter(serial->player(i).world)->lines_cleared;
+    }
+    EXPECT_GT(lines, 0);
+}
+
+// ------------------------------------------------------------
+// 5. 並べ方: 縮小率が最大になる格子を選び、同じなら横並びを優先する
+// ------------------------------------------------------------
+TEST(Versus, LayoutPicksLargestScale) {
+    const auto two = versus::layout_for(2, 600, 600);
+    EXPECT_EQ(two.cols, 2);
+    EXPECT_EQ(two.rows, 1);
+    EXPECT_FLOAT_EQ(two.scale, 0.5f);
+    EXPECT_EQ(two.offset_y, 300);  // 縦は 1 段分の余白を上下に半分ずつ
+
+    const auto three = versus::layout_for(3, 600, 600);
+    EXPECT_EQ(three.cols, 2);
+    EXPECT_EQ(three.rows, 2);
+
+    const auto eight = versus::layout_for(8, 600, 600);
+    EXPECT_EQ(eight.cols, 3);
+    EXPECT_EQ(eight.rows, 3);
+    EXPECT_FLOAT_EQ(eight.scale, 1.0f / 3.0f);
+}
+
+// ------------------------------------------------------------
+// 6. CPU: 決めた配置へは、実際に押すキー(ホールド・回転・左右・ハードドロップ)で届くこと
+//    ハードドロップを押す瞬間の向き・列と、そこから真下に落ちる行が配置と一致する
+// ------------------------------------------------------------
+TEST(Versus, CpuDropsEveryPieceWhereItPlanned) {
+    const auto setting = make_setting();
+    cpu_player::CpuPlayer cpu{};
+    cpu.depth = 2;
+    const Env<GlobalSetting> env{cpu.input, setting, setting.fixed_step_seconds(), {}};
+    auto world = tetris_rule::make_world(env, 11u);
+    ASSERT_TRUE(world);
+
+    int drops = 0;
+    tetris_rule::RenderSnapshot snap;
+    for (int f = 0; f < 4000 && !tetris_rule::is_gameover(*world); ++f) {
+        cpu_player::drive(cpu, [&]() -> std::optional<game_key::GameKey> {
+            // これから探す配置は、search_key と同じ設定で先に求めておく
+            std::optional<placement::Placement> goal = cpu.target;
+            if (!goal) {
+                const auto plan =
+                    tetris_rule::plan_placement(*world, env, cpu_player::search_options(cpu));
+                if (plan) goal = plan->first;
+            }
+            const auto key = cpu_player::search_key(cpu, *world, env);
+            if (key == game_key::GameKey::DROP && goal && !goal->used_hold) {
+                tetris_rule::capture_render_snapshot(*world, snap);
+                EXPECT_EQ(snap.active_dir, goal->piece.dir) << "frame=" << f;
+                EXPECT_EQ(snap.active_pos.x, goal->piece.col) << "frame=" << f;
+                EXPECT_EQ(snap.ghost_pos.y, goal->piece.row) << "frame=" << f;
+                ++drops;
+            }
+            return key;
+        });
+        tetris_rule::step_world(*world, env);
+    }
+    EXPECT_GT(drops, 50);
+}